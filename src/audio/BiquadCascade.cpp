@@ -0,0 +1,143 @@
+#include "audio/BiquadCascade.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace host::audio
+{
+    void BiquadCascade::prepare(int maxSectionsIn, int maxChannelsIn)
+    {
+        numSections = std::max(0, maxSectionsIn);
+        maxChannels = std::max(1, maxChannelsIn);
+        numGroups = (maxChannels + kLanes - 1) / kLanes;
+
+        const auto unity = Register::expand(1.0f);
+        const auto zero = Register::expand(0.0f);
+        coefficients.assign(static_cast<size_t>(numSections), SectionCoefficients { unity, zero, zero, zero, zero });
+        enabled.assign(static_cast<size_t>(numSections), false);
+        active.clear();
+        active.reserve(static_cast<size_t>(numSections));
+        state.assign(static_cast<size_t>(numGroups) * static_cast<size_t>(numSections), SectionState { zero, zero });
+        scratch.assign(static_cast<size_t>(numSections), SectionState { zero, zero });
+    }
+
+    void BiquadCascade::reset() noexcept
+    {
+        const auto zero = Register::expand(0.0f);
+        std::fill(state.begin(), state.end(), SectionState { zero, zero });
+    }
+
+    void BiquadCascade::setCoefficients(int section, const BiquadCoefficients& c) noexcept
+    {
+        if (section < 0 || section >= numSections)
+            return;
+
+        coefficients[static_cast<size_t>(section)] = { Register::expand(c.b0), Register::expand(c.b1), Register::expand(c.b2),
+                                                       Register::expand(c.a1), Register::expand(c.a2) };
+    }
+
+    void BiquadCascade::setEnabled(int section, bool shouldBeEnabled) noexcept
+    {
+        if (section < 0 || section >= numSections || enabled[static_cast<size_t>(section)] == shouldBeEnabled)
+            return;
+
+        enabled[static_cast<size_t>(section)] = shouldBeEnabled;
+        if (shouldBeEnabled)
+        {
+            // Whatever the state held when the section was switched off no
+            // longer matches the signal.
+            const auto zero = Register::expand(0.0f);
+            for (int g = 0; g < numGroups; ++g)
+                state[static_cast<size_t>(g) * static_cast<size_t>(numSections) + static_cast<size_t>(section)] = { zero, zero };
+        }
+        rebuildActive();
+    }
+
+    void BiquadCascade::rebuildActive() noexcept
+    {
+        // Capacity was reserved in prepare(), so this never allocates.
+        active.clear();
+        for (int s = 0; s < numSections; ++s)
+        {
+            if (enabled[static_cast<size_t>(s)])
+                active.push_back(s);
+        }
+    }
+
+    void BiquadCascade::process(const float* const* inputs, float* const* outputs, int numChannels, int numSamples) noexcept
+    {
+        if (outputs == nullptr || numSamples <= 0)
+            return;
+
+        const int filtered = std::min(numChannels, maxChannels);
+        for (int ch = filtered; ch < numChannels; ++ch)
+        {
+            if (outputs[ch] != nullptr && inputs != nullptr && inputs[ch] != nullptr && inputs[ch] != outputs[ch])
+                std::memcpy(outputs[ch], inputs[ch], static_cast<size_t>(numSamples) * sizeof(float));
+        }
+
+        const int numActive = static_cast<int>(active.size());
+        if (numActive == 0)
+        {
+            for (int ch = 0; ch < filtered; ++ch)
+            {
+                if (outputs[ch] != nullptr && inputs != nullptr && inputs[ch] != nullptr && inputs[ch] != outputs[ch])
+                    std::memcpy(outputs[ch], inputs[ch], static_cast<size_t>(numSamples) * sizeof(float));
+            }
+            return;
+        }
+
+        const int usedGroups = (filtered + kLanes - 1) / kLanes;
+        for (int g = 0; g < usedGroups; ++g)
+        {
+            const int firstChannel = g * kLanes;
+            const int groupChannels = std::min(kLanes, filtered - firstChannel);
+            auto* groupState = state.data() + static_cast<size_t>(g) * static_cast<size_t>(numSections);
+
+            // The enabled sections' state, packed in chain order, so the inner
+            // loop walks two arrays front to back.
+            for (int a = 0; a < numActive; ++a)
+                scratch[static_cast<size_t>(a)] = groupState[active[static_cast<size_t>(a)]];
+
+            std::array<const float*, kLanes> in {};
+            std::array<float*, kLanes> out {};
+            for (int lane = 0; lane < groupChannels; ++lane)
+            {
+                in[static_cast<size_t>(lane)] = inputs != nullptr ? inputs[firstChannel + lane] : nullptr;
+                out[static_cast<size_t>(lane)] = outputs[firstChannel + lane];
+            }
+
+            Register frame = Register::expand(0.0f);
+            auto* lanes = reinterpret_cast<float*>(&frame);
+            for (int i = 0; i < numSamples; ++i)
+            {
+                for (int lane = 0; lane < groupChannels; ++lane)
+                {
+                    const auto* source = in[static_cast<size_t>(lane)];
+                    lanes[lane] = source != nullptr ? source[i] : 0.0f;
+                }
+
+                Register x = frame;
+                for (int a = 0; a < numActive; ++a)
+                {
+                    const auto& c = coefficients[static_cast<size_t>(active[static_cast<size_t>(a)])];
+                    auto& s = scratch[static_cast<size_t>(a)];
+                    const Register y = Register::multiplyAdd(s.s1, c.b0, x);
+                    s.s1 = Register::multiplyAdd(s.s2, c.b1, x) - c.a1 * y;
+                    s.s2 = c.b2 * x - c.a2 * y;
+                    x = y;
+                }
+
+                frame = x;
+                for (int lane = 0; lane < groupChannels; ++lane)
+                {
+                    if (auto* dest = out[static_cast<size_t>(lane)])
+                        dest[i] = lanes[lane];
+                }
+            }
+
+            for (int a = 0; a < numActive; ++a)
+                groupState[active[static_cast<size_t>(a)]] = scratch[static_cast<size_t>(a)];
+        }
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+#include <array>
+#include <vector>
+
+namespace host::audio
+{
+    /// Biquad coefficients normalised so a0 == 1.
+    struct BiquadCoefficients
+    {
+        float b0 { 1.0f };
+        float b1 { 0.0f };
+        float b2 { 0.0f };
+        float a1 { 0.0f };
+        float a2 { 0.0f };
+
+        /// From JUCE's {b0, b1, b2, a0, a1, a2} layout, as returned by
+        /// juce::dsp::IIR::ArrayCoefficients.
+        [[nodiscard]] static BiquadCoefficients fromJuce(const std::array<float, 6>& raw) noexcept
+        {
+            const float inverseA0 = raw[3] != 0.0f ? 1.0f / raw[3] : 1.0f;
+            return { raw[0] * inverseA0, raw[1] * inverseA0, raw[2] * inverseA0, raw[4] * inverseA0, raw[5] * inverseA0 };
+        }
+    };
+
+    /// A chain of biquad sections run as one fused kernel: each sample goes
+    /// through every enabled section before the next sample is read, with
+    /// the coefficients pre-broadcast into SIMD registers and channels packed
+    /// into the lanes (four channels per register on SSE/NEON), so a stereo
+    /// pair costs the same as a mono channel.
+    ///
+    /// Sections use transposed direct form II. The state of one group of
+    /// channels is two registers per section. For the length of a block the
+    /// enabled sections' state is gathered into a contiguous scratch array
+    /// allocated in prepare().
+    ///
+    /// Every channel shares the same coefficients. Not thread-safe: set
+    /// coefficients from the thread that calls process().
+    class BiquadCascade
+    {
+    public:
+        /// Allocates for up to maxSections sections and maxChannels channels.
+        /// Sections start disabled with unity coefficients.
+        void prepare(int maxSections, int maxChannels);
+        void reset() noexcept;
+
+        /// Audio thread, allocation-free.
+        void setCoefficients(int section, const BiquadCoefficients& coefficients) noexcept;
+        /// Audio thread, allocation-free. A section that is switched back on
+        /// starts from silent state.
+        void setEnabled(int section, bool enabled) noexcept;
+
+        /// In place is fine (inputs == outputs). numChannels above the
+        /// prepared maximum are passed through unfiltered.
+        void process(const float* const* inputs, float* const* outputs, int numChannels, int numSamples) noexcept;
+
+        [[nodiscard]] int getNumSections() const noexcept { return numSections; }
+        [[nodiscard]] int getNumEnabledSections() const noexcept { return static_cast<int>(active.size()); }
+
+    private:
+        using Register = juce::dsp::SIMDRegister<float>;
+        static constexpr int kLanes = static_cast<int>(Register::SIMDNumElements);
+
+        struct SectionCoefficients
+        {
+            Register b0, b1, b2, a1, a2;
+        };
+
+        struct SectionState
+        {
+            Register s1, s2;
+        };
+
+        void rebuildActive() noexcept;
+
+        int numSections { 0 };
+        int maxChannels { 0 };
+        int numGroups { 0 };
+
+        std::vector<SectionCoefficients> coefficients;
+        std::vector<bool> enabled;
+        std::vector<int> active;           // Enabled section indices in chain order
+        std::vector<SectionState> state;   // numGroups rows of numSections
+        std::vector<SectionState> scratch; // One group's active state during process()
+    };
+}
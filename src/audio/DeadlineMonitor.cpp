@@ -0,0 +1,251 @@
+#include "audio/DeadlineMonitor.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace host::audio
+{
+    namespace
+    {
+        // Per logNewMisses() call; the rest are summarised as a count.
+        constexpr std::size_t kMaxLoggedMisses = 8;
+
+        [[nodiscard]] double toMicroseconds(DeadlineMonitor::Clock::duration duration) noexcept
+        {
+            return std::chrono::duration<double, std::micro>(duration).count();
+        }
+
+        [[nodiscard]] juce::String formatMs(double microseconds)
+        {
+            return juce::String(microseconds / 1000.0, 2) + " ms";
+        }
+
+        template <typename T>
+        void storeMax(std::atomic<T>& target, T value) noexcept
+        {
+            if (value > target.load(std::memory_order_relaxed))
+                target.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    void DeadlineMonitor::reset(double newSampleRate) noexcept
+    {
+        sampleRate = newSampleRate > 0.0 ? newSampleRate : 48000.0;
+        hasPrevious = false;
+
+        callbacks.store(0, std::memory_order_relaxed);
+        overruns.store(0, std::memory_order_relaxed);
+        lateCallbacks.store(0, std::memory_order_relaxed);
+        deadlineUs.store(0.0, std::memory_order_relaxed);
+        lastDurationUs.store(0.0, std::memory_order_relaxed);
+        totalDurationUs.store(0.0, std::memory_order_relaxed);
+        worstDurationUs.store(0.0, std::memory_order_relaxed);
+        worstIntervalUs.store(0.0, std::memory_order_relaxed);
+        worstJitterUs.store(0.0, std::memory_order_relaxed);
+        for (auto& bucket : jitterHistogram)
+            bucket.store(0, std::memory_order_relaxed);
+
+        // Misses stay numbered across resets so the logger's position in the
+        // sequence remains valid; only the ring contents are dropped.
+        for (auto& slot : misses)
+            slot.sequence.store(0, std::memory_order_relaxed);
+    }
+
+    void DeadlineMonitor::callbackFinished(Clock::time_point started,
+                                           int numSamples,
+                                           const host::graph::GraphEngine* graph) noexcept
+    {
+        if (numSamples <= 0)
+            return;
+
+        const double durationUs = toMicroseconds(Clock::now() - started);
+        const double periodUs = static_cast<double>(numSamples) * 1.0e6 / sampleRate;
+
+        double intervalUs = 0.0;
+        if (hasPrevious)
+        {
+            // The interval ends at this callback, so it is measured against
+            // this block's period; drivers that alternate sizes see jitter.
+            intervalUs = toMicroseconds(started - previousStart);
+            const double jitterUs = std::abs(intervalUs - periodUs);
+            auto& bucket = jitterHistogram[static_cast<size_t>(jitterBucket(jitterUs))];
+            bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            storeMax(worstIntervalUs, intervalUs);
+            storeMax(worstJitterUs, jitterUs);
+        }
+        previousStart = started;
+
+        callbacks.store(callbacks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        deadlineUs.store(periodUs, std::memory_order_relaxed);
+        lastDurationUs.store(durationUs, std::memory_order_relaxed);
+        totalDurationUs.store(totalDurationUs.load(std::memory_order_relaxed) + durationUs, std::memory_order_relaxed);
+        storeMax(worstDurationUs, durationUs);
+
+        if (durationUs > periodUs)
+        {
+            overruns.store(overruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            recordMiss(MissKind::overrun, numSamples, periodUs, durationUs, intervalUs, graph);
+        }
+        else if (hasPrevious && intervalUs > periodUs * kLateCallbackFactor)
+        {
+            lateCallbacks.store(lateCallbacks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            recordMiss(MissKind::lateCallback, numSamples, periodUs, durationUs, intervalUs, graph);
+        }
+
+        hasPrevious = true;
+    }
+
+    void DeadlineMonitor::recordMiss(MissKind kind,
+                                     int numSamples,
+                                     double missDeadlineUs,
+                                     double durationUs,
+                                     double intervalUs,
+                                     const host::graph::GraphEngine* graph) noexcept
+    {
+        const auto sequence = missCount.load(std::memory_order_relaxed) + 1;
+        auto& slot = misses[static_cast<size_t>((sequence - 1) % kMaxMisses)];
+
+        // Invalidate first so a reader copying this slot notices the rewrite.
+        slot.sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.timestampMs.store(juce::Time::getMillisecondCounterHiRes(), std::memory_order_relaxed);
+        slot.kind.store(static_cast<std::uint8_t>(kind), std::memory_order_relaxed);
+        slot.numSamples.store(numSamples, std::memory_order_relaxed);
+        slot.deadlineUs.store(missDeadlineUs, std::memory_order_relaxed);
+        slot.durationUs.store(durationUs, std::memory_order_relaxed);
+        slot.intervalUs.store(intervalUs, std::memory_order_relaxed);
+
+        std::uint64_t packedNode = 0;
+        double slowestUs = 0.0;
+        if (graph != nullptr)
+        {
+            const auto slowest = graph->getSlowestNode();
+            if (slowest.handle.isValid())
+            {
+                packedNode = (static_cast<std::uint64_t>(slowest.handle.index + 1) << 32) | slowest.handle.generation;
+                slowestUs = static_cast<double>(slowest.elapsedNs) * 1.0e-3;
+            }
+        }
+        slot.slowestNode.store(packedNode, std::memory_order_relaxed);
+        slot.slowestNodeUs.store(slowestUs, std::memory_order_relaxed);
+
+        slot.sequence.store(sequence, std::memory_order_release);
+        missCount.store(sequence, std::memory_order_release);
+    }
+
+    int DeadlineMonitor::jitterBucket(double jitterUs) noexcept
+    {
+        if (jitterUs < 1.0)
+            return 0;
+
+        int exponent = 0;
+        std::frexp(jitterUs, &exponent); // jitterUs in [2^(exponent-1), 2^exponent)
+        return std::clamp(exponent, 1, kJitterBuckets - 1);
+    }
+
+    DeadlineMonitor::Stats DeadlineMonitor::getStats() const noexcept
+    {
+        Stats stats;
+        stats.callbacks = callbacks.load(std::memory_order_relaxed);
+        stats.overruns = overruns.load(std::memory_order_relaxed);
+        stats.lateCallbacks = lateCallbacks.load(std::memory_order_relaxed);
+        stats.deadlineUs = deadlineUs.load(std::memory_order_relaxed);
+        stats.lastDurationUs = lastDurationUs.load(std::memory_order_relaxed);
+        if (stats.callbacks > 0)
+            stats.meanDurationUs = totalDurationUs.load(std::memory_order_relaxed) / static_cast<double>(stats.callbacks);
+        stats.worstDurationUs = worstDurationUs.load(std::memory_order_relaxed);
+        stats.worstIntervalUs = worstIntervalUs.load(std::memory_order_relaxed);
+        stats.worstJitterUs = worstJitterUs.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < jitterHistogram.size(); ++i)
+            stats.jitterHistogram[i] = jitterHistogram[i].load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    std::vector<DeadlineMonitor::Miss> DeadlineMonitor::getMissesSince(std::uint64_t afterSequence) const
+    {
+        const auto newest = missCount.load(std::memory_order_acquire);
+        const auto oldestAvailable = newest > static_cast<std::uint64_t>(kMaxMisses) ? newest - kMaxMisses + 1 : 1;
+        const auto first = std::max(afterSequence + 1, oldestAvailable);
+
+        std::vector<Miss> result;
+        if (first > newest)
+            return result;
+
+        result.reserve(static_cast<size_t>(newest - first + 1));
+        for (auto sequence = first; sequence <= newest; ++sequence)
+        {
+            const auto& slot = misses[static_cast<size_t>((sequence - 1) % kMaxMisses)];
+            if (slot.sequence.load(std::memory_order_acquire) != sequence)
+                continue;
+
+            Miss miss;
+            miss.sequence = sequence;
+            miss.timestampMs = slot.timestampMs.load(std::memory_order_relaxed);
+            miss.kind = static_cast<MissKind>(slot.kind.load(std::memory_order_relaxed));
+            miss.numSamples = slot.numSamples.load(std::memory_order_relaxed);
+            miss.deadlineUs = slot.deadlineUs.load(std::memory_order_relaxed);
+            miss.durationUs = slot.durationUs.load(std::memory_order_relaxed);
+            miss.intervalUs = slot.intervalUs.load(std::memory_order_relaxed);
+            const auto packedNode = slot.slowestNode.load(std::memory_order_relaxed);
+            if (packedNode != 0)
+            {
+                miss.slowestNode.index = static_cast<std::uint32_t>(packedNode >> 32) - 1;
+                miss.slowestNode.generation = static_cast<std::uint32_t>(packedNode);
+            }
+            miss.slowestNodeUs = slot.slowestNodeUs.load(std::memory_order_relaxed);
+
+            // Overwritten while copying: the entry is gone, drop it.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+                continue;
+
+            result.push_back(miss);
+        }
+
+        return result;
+    }
+
+    void DeadlineMonitor::logNewMisses(const host::graph::GraphEngine* graph)
+    {
+        const auto newest = getMissCount();
+        if (newest <= lastLoggedMiss)
+            return;
+
+        auto missed = getMissesSince(lastLoggedMiss);
+        const auto newMisses = newest - lastLoggedMiss;
+        lastLoggedMiss = newest;
+
+        const auto skipped = missed.size() > kMaxLoggedMisses ? missed.size() - kMaxLoggedMisses : 0;
+        for (size_t i = skipped; i < missed.size(); ++i)
+        {
+            const auto& miss = missed[i];
+            juce::String line = "Audio deadline miss #" + juce::String(static_cast<juce::int64>(miss.sequence)) + ": ";
+            if (miss.kind == MissKind::overrun)
+                line << "callback took " << formatMs(miss.durationUs) << " of " << formatMs(miss.deadlineUs);
+            else
+                line << "callback started " << formatMs(miss.intervalUs) << " after the previous one, expected "
+                     << formatMs(miss.deadlineUs);
+            line << " (" << miss.numSamples << " samples)";
+
+            if (graph != nullptr && miss.slowestNode.isValid())
+            {
+                if (auto node = graph->getNode(miss.slowestNode))
+                    line << ", slowest node '" << juce::String(node->name()) << "' " << formatMs(miss.slowestNodeUs);
+            }
+
+            juce::Logger::writeToLog(line);
+        }
+
+        if (skipped > 0 || newMisses > missed.size())
+            juce::Logger::writeToLog("Audio deadline misses not listed: "
+                                     + juce::String(static_cast<juce::int64>(newMisses - (missed.size() - skipped))));
+
+        const auto stats = getStats();
+        juce::Logger::writeToLog("Audio deadlines: " + juce::String(static_cast<juce::int64>(stats.overruns)) + " overruns, "
+                                 + juce::String(static_cast<juce::int64>(stats.lateCallbacks)) + " late callbacks in "
+                                 + juce::String(static_cast<juce::int64>(stats.callbacks)) + " callbacks; mean "
+                                 + formatMs(stats.meanDurationUs) + ", worst " + formatMs(stats.worstDurationUs)
+                                 + " of " + formatMs(stats.deadlineUs) + ", worst jitter " + formatMs(stats.worstJitterUs));
+    }
+}
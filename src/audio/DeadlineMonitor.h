@@ -0,0 +1,139 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "graph/GraphEngine.h"
+
+namespace host::audio
+{
+    /// Watches the device callback against its real-time deadline: the
+    /// duration of the block it was handed (numSamples / device rate).
+    ///
+    /// Two things are measured per callback: how long processing took and
+    /// how far the interval since the previous callback strayed from one
+    /// block period (jitter). A callback that runs past its deadline is an
+    /// overrun the listener hears as a glitch; one that starts much later
+    /// than expected points at the driver or the OS instead.
+    ///
+    /// Everything the audio thread writes is a relaxed atomic with a single
+    /// writer, and misses go into a fixed ring of kMaxMisses entries, so
+    /// callbackFinished() never locks or allocates. The ring and the
+    /// counters are read and logged from the message thread.
+    class DeadlineMonitor
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        static constexpr int kMaxMisses = 64;
+        /// Power-of-two microsecond buckets of |interval - period|: bucket 0
+        /// is under 1 us, bucket k covers [2^(k-1), 2^k) us, the last is open.
+        static constexpr int kJitterBuckets = 18;
+        /// Interval over the period that counts as a late callback.
+        static constexpr double kLateCallbackFactor = 1.5;
+
+        enum class MissKind : std::uint8_t
+        {
+            overrun,      ///< Processing ran past the block duration
+            lateCallback  ///< The callback started kLateCallbackFactor periods late
+        };
+
+        struct Miss
+        {
+            std::uint64_t sequence { 0 };  ///< 1-based, in the order misses happened
+            double timestampMs { 0.0 };    ///< juce::Time::getMillisecondCounterHiRes() at entry
+            MissKind kind { MissKind::overrun };
+            int numSamples { 0 };
+            double deadlineUs { 0.0 };
+            double durationUs { 0.0 };
+            double intervalUs { 0.0 };
+            /// Slowest graph node of the last graph block processed; invalid
+            /// when the graph ran no node.
+            host::graph::GraphEngine::NodeHandle slowestNode;
+            double slowestNodeUs { 0.0 };
+        };
+
+        struct Stats
+        {
+            std::uint64_t callbacks { 0 };
+            std::uint64_t overruns { 0 };
+            std::uint64_t lateCallbacks { 0 };
+            double deadlineUs { 0.0 };      ///< Of the last callback
+            double lastDurationUs { 0.0 };
+            double meanDurationUs { 0.0 };
+            double worstDurationUs { 0.0 };
+            double worstIntervalUs { 0.0 };
+            double worstJitterUs { 0.0 };
+            std::array<std::uint64_t, kJitterBuckets> jitterHistogram {};
+        };
+
+        /// Forget all counters and misses and start measuring a device
+        /// running at sampleRate. Not safe while callbacks are running.
+        void reset(double sampleRate) noexcept;
+
+        /// Audio thread: call first thing in the callback.
+        [[nodiscard]] Clock::time_point callbackStarted() const noexcept { return Clock::now(); }
+        /// Audio thread: call last thing in the callback. `graph` (may be
+        /// null) names the slowest node when a miss is recorded.
+        void callbackFinished(Clock::time_point started,
+                              int numSamples,
+                              const host::graph::GraphEngine* graph) noexcept;
+
+        [[nodiscard]] Stats getStats() const noexcept;
+        /// Message thread: misses newer than `afterSequence`, oldest first.
+        /// Ones the ring has already overwritten are skipped.
+        [[nodiscard]] std::vector<Miss> getMissesSince(std::uint64_t afterSequence) const;
+        [[nodiscard]] std::uint64_t getMissCount() const noexcept { return missCount.load(std::memory_order_acquire); }
+
+        /// Message thread: write a line per new miss and a summary line to
+        /// the current juce::Logger (the app's ConsoleLogger), resolving
+        /// slowest nodes by name through `graph`. Does nothing when nothing
+        /// was missed since the previous call.
+        void logNewMisses(const host::graph::GraphEngine* graph);
+
+    private:
+        struct MissSlot
+        {
+            // Written last with release; a reader that sees the sequence it
+            // expects before and after copying has a consistent entry.
+            std::atomic<std::uint64_t> sequence { 0 };
+            std::atomic<double> timestampMs { 0.0 };
+            std::atomic<std::uint8_t> kind { 0 };
+            std::atomic<int> numSamples { 0 };
+            std::atomic<double> deadlineUs { 0.0 };
+            std::atomic<double> durationUs { 0.0 };
+            std::atomic<double> intervalUs { 0.0 };
+            std::atomic<std::uint64_t> slowestNode { 0 }; // index + 1 << 32 | generation
+            std::atomic<double> slowestNodeUs { 0.0 };
+        };
+
+        static int jitterBucket(double jitterUs) noexcept;
+        void recordMiss(MissKind kind, int numSamples, double deadlineUs, double durationUs, double intervalUs,
+                        const host::graph::GraphEngine* graph) noexcept;
+
+        double sampleRate { 48000.0 };
+        bool hasPrevious { false };          // Audio thread only
+        Clock::time_point previousStart {};  // Audio thread only
+
+        std::atomic<std::uint64_t> callbacks { 0 };
+        std::atomic<std::uint64_t> overruns { 0 };
+        std::atomic<std::uint64_t> lateCallbacks { 0 };
+        std::atomic<double> deadlineUs { 0.0 };
+        std::atomic<double> lastDurationUs { 0.0 };
+        std::atomic<double> totalDurationUs { 0.0 };
+        std::atomic<double> worstDurationUs { 0.0 };
+        std::atomic<double> worstIntervalUs { 0.0 };
+        std::atomic<double> worstJitterUs { 0.0 };
+        std::array<std::atomic<std::uint64_t>, kJitterBuckets> jitterHistogram {};
+
+        std::array<MissSlot, kMaxMisses> misses;
+        std::atomic<std::uint64_t> missCount { 0 };
+
+        std::uint64_t lastLoggedMiss { 0 }; // Message thread only
+    };
+}
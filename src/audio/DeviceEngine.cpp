@@ -3,8 +3,12 @@
 #include <juce_audio_basics/juce_audio_basics.h>
 
 #include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <utility>
 
+#include "graph/RealtimeChecker.h"
+
 namespace host::audio
 {
     struct DeviceEngine::ProcessingState
@@ -17,11 +21,29 @@ namespace host::audio
         std::vector<float*> engineWritePointers;
         std::vector<const float*> engineReadPointers;
         int engineBlockSize { 1 };
+        // Device and engine run at the same rate: device buffers go straight
+        // through the graph (which splits them into engine-sized sub-blocks
+        // itself) and both resamplers are left unprepared.
+        bool passthrough { false };
+        int resamplerLatencySamples { 0 };
+        // Drift compensation: nominal ratios and the device clock measured
+        // against the host clock, which steers both of them.
+        bool adaptive { false };
+        double nominalInputRatio { 1.0 };
+        double nominalOutputRatio { 1.0 };
+        double deviceSampleRate { 48000.0 };
+        DriftCompensator clockDrift;
+        // Callback (or engine-thread render) time against the block duration.
+        juce::AudioProcessLoadMeasurer loadMeasurer;
+        // Last member: destroyed first, so the engine thread is gone before
+        // the resamplers and buffers it renders with.
+        std::unique_ptr<EnginePipeline> pipeline;
     };
 
     namespace
     {
         constexpr int resamplerMargin = 12;
+        constexpr int deadlineLogIntervalMs = 2000;
 
         [[nodiscard]] double safeRatio(double numerator, double denominator) noexcept
         {
@@ -29,6 +51,18 @@ namespace host::audio
                 return 1.0;
             return numerator / denominator;
         }
+
+        [[nodiscard]] bool ratesMatch(double deviceRate, double engineRate) noexcept
+        {
+            return deviceRate > 0.0 && engineRate > 0.0 && std::abs(deviceRate - engineRate) < 1.0e-6;
+        }
+
+        // Width of the engine bus: the wider of the device's input and output
+        // sides, at least stereo. The graph is prepared for the same width.
+        [[nodiscard]] int engineChannelCount(const DeviceInfo& info) noexcept
+        {
+            return std::max(2, std::max(info.inputChannels, info.outputChannels));
+        }
     }
 
     DeviceEngine::DeviceEngine()
@@ -38,6 +72,8 @@ namespace host::audio
         deviceInfo.inputChannels = 2;
         deviceInfo.outputChannels = 2;
         rebuildProcessingState(engineConfig, deviceInfo);
+        deadlineMonitor.reset(deviceInfo.sampleRate);
+        startTimer(deadlineLogIntervalMs);
     }
 
     void DeviceEngine::setGraph(std::shared_ptr<host::graph::GraphEngine> newGraph)
@@ -45,10 +81,14 @@ namespace host::audio
         graphEngine.store(std::move(newGraph));
 
         EngineConfig cfg = getEngineConfig();
+        const DeviceInfo info = getDeviceInfo();
 
         if (auto graph = graphEngine.load())
         {
+            graph->setBusChannels(engineChannelCount(info));
             graph->setPdcEnabled(cfg.pdcEnabled);
+            graph->setWorkerCount(cfg.workerThreads);
+            graph->setTailSleepEnabled(cfg.tailSleepEnabled);
             graph->setEngineFormat(cfg.sampleRate, cfg.blockSize);
             graph->prepare();
         }
@@ -77,6 +117,8 @@ namespace host::audio
         if (auto graph = graphEngine.load())
         {
             graph->setPdcEnabled(appliedConfig.pdcEnabled);
+            graph->setWorkerCount(appliedConfig.workerThreads);
+            graph->setTailSleepEnabled(appliedConfig.tailSleepEnabled);
             graph->setEngineFormat(appliedConfig.sampleRate, appliedConfig.blockSize);
             // Do NOT call graph->prepare() here. setEngineConfig can be invoked
             // from the preferences change callback while a background session
@@ -101,6 +143,11 @@ namespace host::audio
         }
 
         rebuildProcessingState(currentEngineConfig, appliedInfo);
+
+        // Takes effect on the next prepare(), which audioDeviceAboutToStart
+        // runs right after this.
+        if (auto graph = graphEngine.load())
+            graph->setBusChannels(engineChannelCount(appliedInfo));
     }
 
     DeviceInfo DeviceEngine::getDeviceInfo() const
@@ -109,6 +156,92 @@ namespace host::audio
         return deviceInfo;
     }
 
+    LatencyReport DeviceEngine::getLatencyReport() const
+    {
+        LatencyReport report;
+
+        const DeviceInfo info = getDeviceInfo();
+        const EngineConfig cfg = getEngineConfig();
+
+        if (auto state = processingState_.load(std::memory_order_acquire))
+        {
+            report.passthrough = state->passthrough;
+            report.resamplerSamples = state->resamplerLatencySamples;
+            if (state->pipeline != nullptr)
+                report.pipelineSamples = state->pipeline->getLatencySamples();
+        }
+
+        if (auto graph = graphEngine.load())
+        {
+            const double engineToDevice = safeRatio(info.sampleRate, cfg.sampleRate);
+            report.graphSamples = static_cast<int>(std::ceil(graph->getRuntimeStats().latencySamples * engineToDevice));
+        }
+
+        report.totalSamples = report.resamplerSamples + report.graphSamples + report.pipelineSamples;
+        if (info.sampleRate > 0.0)
+            report.totalMs = 1000.0 * report.totalSamples / info.sampleRate;
+
+        return report;
+    }
+
+    ResamplerFifoReport DeviceEngine::getResamplerFifoReport() const
+    {
+        ResamplerFifoReport report;
+        if (auto state = processingState_.load(std::memory_order_acquire))
+        {
+            report.input = state->inputResampler.getFifoStats();
+            report.output = state->outputResampler.getFifoStats();
+        }
+        return report;
+    }
+
+    DriftReport DeviceEngine::getDriftReport() const
+    {
+        DriftReport report;
+        if (auto state = processingState_.load(std::memory_order_acquire); state && state->adaptive)
+        {
+            report.enabled = true;
+            report.clock = state->clockDrift.getStats();
+        }
+        return report;
+    }
+
+    EnginePipeline::Stats DeviceEngine::getPipelineStats() const
+    {
+        if (auto state = processingState_.load(std::memory_order_acquire); state && state->pipeline != nullptr)
+            return state->pipeline->getStats();
+        return {};
+    }
+
+    CallbackLoadReport DeviceEngine::getCallbackLoad() const
+    {
+        CallbackLoadReport report;
+        if (auto state = processingState_.load(std::memory_order_acquire))
+        {
+            report.pipelined = state->pipeline != nullptr;
+            report.loadPercent = state->loadMeasurer.getLoadAsPercentage();
+            report.overloads = state->loadMeasurer.getXRunCount();
+        }
+        return report;
+    }
+
+    DeadlineMonitor::Stats DeviceEngine::getDeadlineStats() const
+    {
+        return deadlineMonitor.getStats();
+    }
+
+    std::vector<DeadlineMonitor::Miss> DeviceEngine::getDeadlineMisses(std::uint64_t afterSequence) const
+    {
+        return deadlineMonitor.getMissesSince(afterSequence);
+    }
+
+    void DeviceEngine::timerCallback()
+    {
+        const auto graph = graphEngine.load();
+        deadlineMonitor.logNewMisses(graph.get());
+        host::graph::RealtimeChecker::logNewViolations(graph.get());
+    }
+
     void DeviceEngine::audioDeviceIOCallbackWithContext(const float* const* inputChannelData,
                                                         int numInputChannels,
                                                         float* const* outputChannelData,
@@ -117,6 +250,7 @@ namespace host::audio
                                                         const juce::AudioIODeviceCallbackContext& context)
     {
         juce::ignoreUnused(context);
+        const auto callbackStart = deadlineMonitor.callbackStarted();
         clearOutputs(outputChannelData, numOutputChannels, numSamples);
 
         // ASIO/WASAPI may supply a high-resolution host timestamp; forward it
@@ -127,53 +261,97 @@ namespace host::audio
         if (! state || numSamples <= 0 || state->engineBuffer.getNumChannels() == 0)
             return;
 
-        const int channels = state->engineBuffer.getNumChannels();
+        if (state->adaptive)
+        {
+            // Timed here rather than in renderDeviceBlock(), which runs on the
+            // engine thread when pipelining and never sees the device clock.
+            const auto timeNs = hostTimeNs != nullptr
+                ? *hostTimeNs
+                : static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now().time_since_epoch()).count());
+            state->clockDrift.update(numSamples, timeNs);
+        }
+
+        const auto graph = graphEngine.load();
+        if (state->pipeline != nullptr)
+        {
+            // The engine thread renders; this callback only trades buffers.
+            // Its misses then show up as pipeline underruns instead.
+            state->pipeline->exchange(inputChannelData, numInputChannels,
+                                      outputChannelData, numOutputChannels, numSamples);
+        }
+        else
+        {
+            const juce::AudioProcessLoadMeasurer::ScopedTimer loadTimer(state->loadMeasurer, numSamples);
+            renderDeviceBlock(*state, graph.get(), inputChannelData, numInputChannels,
+                              outputChannelData, numOutputChannels, numSamples, hostTimeNs);
+        }
+
+        deadlineMonitor.callbackFinished(callbackStart, numSamples, graph.get());
+    }
+
+    void DeviceEngine::renderDeviceBlock(ProcessingState& state,
+                                         host::graph::GraphEngine* graph,
+                                         const float* const* inputChannelData,
+                                         int numInputChannels,
+                                         float* const* outputChannelData,
+                                         int numOutputChannels,
+                                         int numSamples,
+                                         const std::uint64_t* hostTimeNs)
+    {
+        if (state.passthrough)
+        {
+            processPassthrough(state, graph, inputChannelData, numInputChannels,
+                               outputChannelData, numOutputChannels, numSamples, hostTimeNs);
+            return;
+        }
+
+        const int channels = state.engineBuffer.getNumChannels();
 
         for (int ch = 0; ch < channels; ++ch)
         {
             const float* source = (inputChannelData != nullptr && ch < numInputChannels && inputChannelData[ch] != nullptr)
                 ? inputChannelData[ch]
                 : nullptr;
-            state->inputPointerScratch[static_cast<size_t>(ch)] = source;
+            state.inputPointerScratch[static_cast<size_t>(ch)] = source;
 
             float* dest = (outputChannelData != nullptr && ch < numOutputChannels)
                 ? outputChannelData[ch]
                 : nullptr;
-            state->outputPointerScratch[static_cast<size_t>(ch)] = dest;
+            state.outputPointerScratch[static_cast<size_t>(ch)] = dest;
 
-            state->engineWritePointers[static_cast<size_t>(ch)] = state->engineBuffer.getWritePointer(ch);
-            state->engineReadPointers[static_cast<size_t>(ch)] = state->engineBuffer.getReadPointer(ch);
+            state.engineWritePointers[static_cast<size_t>(ch)] = state.engineBuffer.getWritePointer(ch);
+            state.engineReadPointers[static_cast<size_t>(ch)] = state.engineBuffer.getReadPointer(ch);
         }
 
-        state->inputResampler.push(state->inputPointerScratch.data(), numSamples);
+        state.inputResampler.push(state.inputPointerScratch.data(), numSamples);
 
-        auto graph = graphEngine.load();
-        const int engineBlockSize = std::max(1, state->engineBlockSize);
+        const int engineBlockSize = std::max(1, state.engineBlockSize);
 
-        while (state->inputResampler.canProcess(engineBlockSize))
+        while (state.inputResampler.canProcess(engineBlockSize))
         {
-            state->inputResampler.process(state->engineWritePointers.data(), engineBlockSize);
+            state.inputResampler.process(state.engineWritePointers.data(), engineBlockSize);
 
             int produced = engineBlockSize;
 
-            if (graph)
+            if (graph != nullptr)
             {
-                produced = graph->process(state->engineBuffer, hostTimeNs);
+                produced = graph->process(state.engineBuffer, hostTimeNs);
                 if (produced <= 0)
                 {
-                    state->engineBuffer.clear();
+                    state.engineBuffer.clear();
                     break;
                 }
             }
             else
             {
-                state->engineBuffer.clear();
+                state.engineBuffer.clear();
             }
 
-            state->outputResampler.push(state->engineReadPointers.data(), produced);
+            state.outputResampler.push(state.engineReadPointers.data(), produced);
         }
 
-        const int produced = state->outputResampler.process(state->outputPointerScratch.data(), numSamples);
+        const int produced = state.outputResampler.process(state.outputPointerScratch.data(), numSamples);
         if (produced < numSamples)
         {
             for (int ch = 0; ch < numOutputChannels; ++ch)
@@ -182,6 +360,71 @@ namespace host::audio
                     juce::FloatVectorOperations::clear(outputChannelData[ch] + produced, numSamples - produced);
             }
         }
+
+        if (state.adaptive)
+        {
+            // A fast device clock delivers more samples per host second: the
+            // input side takes more of them per engine sample and the output
+            // side spreads each engine sample over more of them. The two
+            // ratios stay reciprocal, so neither FIFO creeps.
+            const double factor = state.clockDrift.getRateFactor();
+            state.inputResampler.setRatio(state.nominalInputRatio * factor);
+            state.outputResampler.setRatio(state.nominalOutputRatio / factor);
+        }
+    }
+
+    void DeviceEngine::processPassthrough(ProcessingState& state,
+                                          host::graph::GraphEngine* graph,
+                                          const float* const* inputChannelData,
+                                          int numInputChannels,
+                                          float* const* outputChannelData,
+                                          int numOutputChannels,
+                                          int numSamples,
+                                          const std::uint64_t* hostTimeNs)
+    {
+        auto& buffer = state.engineBuffer;
+        const int channels = buffer.getNumChannels();
+        const int capacity = state.engineBlockSize;
+
+        // The buffer is sized for the largest device block seen at prepare
+        // time; a driver that hands over more runs it in several passes.
+        for (int offset = 0; offset < numSamples; offset += capacity)
+        {
+            const int count = std::min(capacity, numSamples - offset);
+            buffer.setSize(channels, count, false, false, true);
+
+            for (int ch = 0; ch < channels; ++ch)
+            {
+                const float* source = (inputChannelData != nullptr && ch < numInputChannels && inputChannelData[ch] != nullptr)
+                    ? inputChannelData[ch] + offset
+                    : nullptr;
+
+                if (source != nullptr)
+                    juce::FloatVectorOperations::copy(buffer.getWritePointer(ch), source, count);
+                else
+                    juce::FloatVectorOperations::clear(buffer.getWritePointer(ch), count);
+            }
+
+            // Later passes start after the device timestamp by the samples
+            // already rendered, as GraphEngine does for its own sub-blocks.
+            std::uint64_t chunkTimeNs = 0;
+            const std::uint64_t* chunkTimePtr = hostTimeNs;
+            if (hostTimeNs != nullptr && offset > 0)
+            {
+                chunkTimeNs = *hostTimeNs
+                            + static_cast<std::uint64_t>(static_cast<double>(offset) * 1.0e9 / state.deviceSampleRate);
+                chunkTimePtr = &chunkTimeNs;
+            }
+
+            if (graph == nullptr || graph->process(buffer, chunkTimePtr) <= 0)
+                continue; // Outputs were cleared on entry.
+
+            for (int ch = 0; ch < std::min(channels, numOutputChannels); ++ch)
+            {
+                if (outputChannelData != nullptr && outputChannelData[ch] != nullptr)
+                    juce::FloatVectorOperations::copy(outputChannelData[ch] + offset, buffer.getReadPointer(ch), count);
+            }
+        }
     }
 
     void DeviceEngine::audioDeviceAboutToStart(juce::AudioIODevice* device)
@@ -195,6 +438,8 @@ namespace host::audio
         info.inputChannels = device->getActiveInputChannels().countNumberOfSetBits();
         info.outputChannels = device->getActiveOutputChannels().countNumberOfSetBits();
         setDeviceInfo(info);
+        // Callbacks have not started yet, so the monitor can be reset here.
+        deadlineMonitor.reset(info.sampleRate);
 
         // The device (re)start is the safe moment to prepare the graph: it
         // happens on the device thread before audio runs, and is not racing
@@ -225,36 +470,99 @@ namespace host::audio
     {
         auto state = std::make_shared<ProcessingState>();
 
-        const int numChannels = std::max(2, std::max(info.inputChannels, info.outputChannels));
+        const int numChannels = engineChannelCount(info);
         const int engineBlockSize = std::max(1, cfg.blockSize);
         const int deviceBlockSize = std::max(1, info.blockSize);
 
         state->engineBlockSize = engineBlockSize;
-        state->engineBuffer.setSize(numChannels, engineBlockSize, false, false, true);
+        state->loadMeasurer.reset(info.sampleRate > 0.0 ? info.sampleRate : cfg.sampleRate, deviceBlockSize);
 
         state->inputPointerScratch.resize(static_cast<size_t>(numChannels));
         state->outputPointerScratch.resize(static_cast<size_t>(numChannels));
         state->engineWritePointers.resize(static_cast<size_t>(numChannels));
         state->engineReadPointers.resize(static_cast<size_t>(numChannels));
 
+        // Drift compensation resamples by the measured correction, so it
+        // needs the resamplers even when the nominal rates match.
+        if (ratesMatch(info.sampleRate, cfg.sampleRate) && ! cfg.driftCompensation)
+        {
+            // The graph accepts any buffer length, so the scratch buffer only
+            // has to hold one device block (with room for drivers that
+            // deliver a little more than they announce).
+            state->passthrough = true;
+            state->engineBlockSize = std::max(deviceBlockSize, engineBlockSize) * 2;
+            state->engineBuffer.setSize(numChannels, state->engineBlockSize, false, false, true);
+            attachPipeline(*state, cfg, info);
+            return state;
+        }
+
+        state->engineBuffer.setSize(numChannels, engineBlockSize, false, false, true);
+
         const int inputChunk = std::max(deviceBlockSize, engineBlockSize) * 2;
         const double deviceToEngine = safeRatio(info.sampleRate, cfg.sampleRate);
         state->inputResampler.prepare(numChannels, deviceToEngine, inputChunk, engineBlockSize,
-                                      resamplerQualityFromIndex(cfg.resamplerQuality), resamplerMargin);
+                                      resamplerQualityFromIndex(cfg.resamplerQuality), resamplerMargin,
+                                      cfg.driftCompensation);
         state->inputResampler.reset();
 
         const int outputChunk = std::max(deviceBlockSize, engineBlockSize) * 2;
         const double engineToDevice = safeRatio(cfg.sampleRate, info.sampleRate);
         state->outputResampler.prepare(numChannels, engineToDevice, engineBlockSize, outputChunk,
-                                       resamplerQualityFromIndex(cfg.resamplerQuality), resamplerMargin);
+                                       resamplerQualityFromIndex(cfg.resamplerQuality), resamplerMargin,
+                                       cfg.driftCompensation);
         state->outputResampler.reset();
 
+        state->adaptive = cfg.driftCompensation;
+        state->nominalInputRatio = deviceToEngine;
+        state->nominalOutputRatio = engineToDevice;
+        if (state->adaptive)
+        {
+            state->deviceSampleRate = info.sampleRate > 0.0 ? info.sampleRate : cfg.sampleRate;
+            state->clockDrift.prepare(state->deviceSampleRate);
+        }
+
+        attachPipeline(*state, cfg, info);
+
+        // The input side waits for a full engine block plus its lookahead
+        // before the graph runs; the output side holds its lookahead (at the
+        // engine rate) back for the interpolator.
+        state->resamplerLatencySamples = state->inputResampler.getLookaheadSamples()
+            + static_cast<int>(std::ceil((engineBlockSize + state->outputResampler.getLookaheadSamples()) * deviceToEngine));
+
         return state;
     }
 
+    void DeviceEngine::attachPipeline(ProcessingState& state, const EngineConfig& cfg, const DeviceInfo& info) const
+    {
+        if (cfg.pipelineDepth <= 0)
+            return;
+
+        // One pipeline block covers a device buffer and at least one engine
+        // block (at the device rate), so a large engine block size gives the
+        // engine thread correspondingly larger, cheaper chunks to render.
+        const double engineToDevice = safeRatio(info.sampleRate, cfg.sampleRate);
+        const int engineBlockAtDeviceRate = static_cast<int>(std::ceil(std::max(1, cfg.blockSize) * engineToDevice));
+        const int blockSize = std::max(std::max(1, info.blockSize), engineBlockAtDeviceRate);
+
+        auto* rawState = &state;
+        state.pipeline = std::make_unique<EnginePipeline>(
+            state.engineBuffer.getNumChannels(), blockSize, cfg.pipelineDepth,
+            [this, rawState](const float* const* inputs, float* const* outputs, int numChannels, int numSamples)
+            {
+                const juce::AudioProcessLoadMeasurer::ScopedTimer loadTimer(rawState->loadMeasurer, numSamples);
+                renderDeviceBlock(*rawState, graphEngine.load().get(), inputs, numChannels,
+                                  outputs, numChannels, numSamples, nullptr);
+            });
+    }
+
     void DeviceEngine::rebuildProcessingState(const EngineConfig& cfg, const DeviceInfo& info)
     {
-        processingState_.store(buildProcessingState(cfg, info), std::memory_order_release);
+        auto previous = processingState_.exchange(buildProcessingState(cfg, info), std::memory_order_acq_rel);
+
+        // Join the old engine thread here rather than wherever the last
+        // reference happens to drop, which may be the device callback.
+        if (previous != nullptr && previous->pipeline != nullptr)
+            previous->pipeline->stop();
     }
 
     void DeviceEngine::clearOutputs(float* const* outputChannelData, int numOutputChannels, int numSamples)
@@ -7,6 +7,9 @@
 #include <memory>
 #include <vector>
 
+#include "audio/DeadlineMonitor.h"
+#include "audio/DriftCompensator.h"
+#include "audio/EnginePipeline.h"
 #include "audio/Resampler.h"
 #include "graph/GraphEngine.h"
 
@@ -17,9 +20,26 @@ namespace host::audio
         double sampleRate { 48000.0 };
         int blockSize { 256 };
         // Mirrors host::persist::EngineSettings::resamplerQuality.
-        // 0=Linear 1=CatmullRom 2=Lagrange 3=WindowedSinc
+        // 0=Linear 1=CatmullRom 2=Lagrange 3=WindowedSinc 4=Polyphase
         int resamplerQuality { 2 };
         bool pdcEnabled { true };
+        // Realtime worker threads that run independent graph branches in
+        // parallel with the device callback. 0 = serial processing.
+        int workerThreads { 0 };
+        // Stop processing nodes whose input has been silent for longer than
+        // their reported tail (see GraphEngine::setTailSleepEnabled).
+        bool tailSleepEnabled { false };
+        // Measure the device's sample clock against the host clock and steer
+        // both resampler ratios so the engine runs at its nominal rate in
+        // host time (see DriftCompensator). Keeps the resamplers in the path
+        // even when the nominal rates match. Input and output of one duplex
+        // device share a clock; a device combining two interfaces reconciles
+        // their clocks in the driver, before the callback.
+        bool driftCompensation { false };
+        // Render the graph on a dedicated engine thread, this many blocks
+        // ahead of the device (see EnginePipeline). 0 = render inside the
+        // device callback.
+        int pipelineDepth { 0 };
     };
 
     struct DeviceInfo
@@ -30,7 +50,45 @@ namespace host::audio
         int outputChannels { 0 };
     };
 
-    class DeviceEngine : public juce::AudioIODeviceCallback
+    /// Latency the engine adds between device input and device output, on top
+    /// of the driver's own buffering. All sample counts are at the device rate.
+    struct LatencyReport
+    {
+        bool passthrough { false }; ///< Device and engine rates match; no resampling
+        int resamplerSamples { 0 };  ///< FIFO fill plus interpolator margins (0 in passthrough)
+        int graphSamples { 0 };      ///< Plug-in and PDC latency of the prepared graph
+        int pipelineSamples { 0 };   ///< Blocks the engine thread renders ahead (0 without pipelining)
+        int totalSamples { 0 };
+        double totalMs { 0.0 };
+    };
+
+    /// Resampler FIFO health for the current processing state. Both sides
+    /// stay at zero in passthrough, where no resampler runs.
+    struct ResamplerFifoReport
+    {
+        BlockResampler::FifoStats input;
+        BlockResampler::FifoStats output;
+    };
+
+    /// Drift-compensation loop state: the device clock against the host's.
+    struct DriftReport
+    {
+        bool enabled { false };
+        DriftCompensator::Stats clock;
+    };
+
+    /// How much of its real-time budget the audio work takes. Measured around
+    /// the device callback, or around each engine-thread render when
+    /// pipelining (the callback itself then only copies buffers).
+    struct CallbackLoadReport
+    {
+        bool pipelined { false };
+        double loadPercent { 0.0 }; ///< Smoothed processing time over block duration
+        int overloads { 0 };        ///< Blocks that took longer than their duration
+    };
+
+    class DeviceEngine : public juce::AudioIODeviceCallback,
+                         private juce::Timer
     {
     public:
         DeviceEngine();
@@ -44,6 +102,18 @@ namespace host::audio
         void setDeviceInfo(const DeviceInfo& info);
         [[nodiscard]] DeviceInfo getDeviceInfo() const;
 
+        /// End-to-end latency for the current device, engine format and graph.
+        [[nodiscard]] LatencyReport getLatencyReport() const;
+        [[nodiscard]] ResamplerFifoReport getResamplerFifoReport() const;
+        [[nodiscard]] DriftReport getDriftReport() const;
+        /// Engine-thread pipeline counters; all zero when pipelining is off.
+        [[nodiscard]] EnginePipeline::Stats getPipelineStats() const;
+        [[nodiscard]] CallbackLoadReport getCallbackLoad() const;
+        /// Device callback timing against its deadline since the device last
+        /// started. New misses are also logged every couple of seconds.
+        [[nodiscard]] DeadlineMonitor::Stats getDeadlineStats() const;
+        [[nodiscard]] std::vector<DeadlineMonitor::Miss> getDeadlineMisses(std::uint64_t afterSequence = 0) const;
+
         void audioDeviceIOCallbackWithContext(const float* const* inputChannelData,
                                               int numInputChannels,
                                               float* const* outputChannelData,
@@ -57,10 +127,29 @@ namespace host::audio
     private:
         struct ProcessingState;
 
+        void timerCallback() override;
+
         [[nodiscard]] std::shared_ptr<ProcessingState> buildProcessingState(const EngineConfig& cfg,
                                                                             const DeviceInfo& info) const;
         void rebuildProcessingState(const EngineConfig& cfg, const DeviceInfo& info);
+        void attachPipeline(ProcessingState& state, const EngineConfig& cfg, const DeviceInfo& info) const;
         void clearOutputs(float* const* outputChannelData, int numOutputChannels, int numSamples);
+        static void renderDeviceBlock(ProcessingState& state,
+                                      host::graph::GraphEngine* graph,
+                                      const float* const* inputChannelData,
+                                      int numInputChannels,
+                                      float* const* outputChannelData,
+                                      int numOutputChannels,
+                                      int numSamples,
+                                      const std::uint64_t* hostTimeNs);
+        static void processPassthrough(ProcessingState& state,
+                                       host::graph::GraphEngine* graph,
+                                       const float* const* inputChannelData,
+                                       int numInputChannels,
+                                       float* const* outputChannelData,
+                                       int numOutputChannels,
+                                       int numSamples,
+                                       const std::uint64_t* hostTimeNs);
 
         std::atomic<std::shared_ptr<host::graph::GraphEngine>> graphEngine;
         mutable std::mutex configMutex_;
@@ -68,5 +157,6 @@ namespace host::audio
         DeviceInfo deviceInfo;
 
         std::atomic<std::shared_ptr<ProcessingState>> processingState_;
+        DeadlineMonitor deadlineMonitor;
     };
 }
@@ -0,0 +1,112 @@
+#include "audio/DriftCompensator.h"
+
+#include <juce_core/juce_core.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace host::audio
+{
+    void DriftCompensator::prepare(double nominalRate) noexcept
+    {
+        nominalPeriod = 1.0 / (nominalRate > 0.0 ? nominalRate : 48000.0);
+        reset();
+    }
+
+    void DriftCompensator::reset() noexcept
+    {
+        period = nominalPeriod;
+        filteredTime = 0.0;
+        originNs = 0;
+        previousSamples = 0;
+        settleElapsed = 0.0;
+        primed = false;
+
+        locked.store(false, std::memory_order_relaxed);
+        factor.store(1.0, std::memory_order_relaxed);
+        drift.store(0.0, std::memory_order_relaxed);
+        peakCorrection.store(0.0, std::memory_order_relaxed);
+        timingError.store(0.0, std::memory_order_relaxed);
+        resyncs.store(0, std::memory_order_relaxed);
+        saturatedUpdates.store(0, std::memory_order_relaxed);
+    }
+
+    void DriftCompensator::update(int numSamples, std::uint64_t timeNs) noexcept
+    {
+        if (numSamples <= 0)
+            return;
+
+        if (! primed)
+        {
+            originNs = timeNs;
+            filteredTime = 0.0;
+            previousSamples = numSamples;
+            primed = true;
+            return;
+        }
+
+        // Signed, so a clock that steps backwards shows up as a jump too.
+        const double now = static_cast<double>(static_cast<std::int64_t>(timeNs - originNs)) * 1.0e-9;
+        const double blockSeconds = period * previousSamples;
+        const double predicted = filteredTime + blockSeconds;
+        const double error = now - predicted;
+        timingError.store(error * 1.0e6, std::memory_order_relaxed);
+
+        if (std::abs(error) > kResyncSeconds)
+        {
+            filteredTime = now;
+            previousSamples = numSamples;
+            resyncs.store(resyncs.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return;
+        }
+
+        // Critically damped second-order loop (b = sqrt(2) w, c = w^2) with
+        // w scaled to the length of the block just timed.
+        const double omega = juce::MathConstants<double>::twoPi * kBandwidthHz * blockSeconds;
+        filteredTime = predicted + std::sqrt(2.0) * omega * error;
+        period += omega * omega * error / previousSamples;
+        previousSamples = numSamples;
+
+        const double estimate = nominalPeriod / period - 1.0;
+        drift.store(estimate, std::memory_order_relaxed);
+
+        if (! locked.load(std::memory_order_relaxed))
+        {
+            settleElapsed += blockSeconds;
+            if (settleElapsed < kSettleSeconds)
+                return;
+            locked.store(true, std::memory_order_relaxed);
+        }
+
+        // A rate this far off is a broken timestamp source rather than a
+        // clock; hold the correction at the limit instead of following it.
+        double applied = estimate;
+        if (std::abs(applied) > kMaxCorrection)
+        {
+            applied = std::clamp(applied, -kMaxCorrection, kMaxCorrection);
+            saturatedUpdates.store(saturatedUpdates.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        factor.store(1.0 + applied, std::memory_order_relaxed);
+        if (std::abs(applied) > peakCorrection.load(std::memory_order_relaxed))
+            peakCorrection.store(std::abs(applied), std::memory_order_relaxed);
+    }
+
+    double DriftCompensator::getRateFactor() const noexcept
+    {
+        return factor.load(std::memory_order_relaxed);
+    }
+
+    DriftCompensator::Stats DriftCompensator::getStats() const noexcept
+    {
+        Stats stats;
+        stats.locked = locked.load(std::memory_order_relaxed);
+        stats.correctionPpm = (factor.load(std::memory_order_relaxed) - 1.0) * 1.0e6;
+        stats.driftPpm = drift.load(std::memory_order_relaxed) * 1.0e6;
+        stats.peakCorrectionPpm = peakCorrection.load(std::memory_order_relaxed) * 1.0e6;
+        stats.timingErrorUs = timingError.load(std::memory_order_relaxed);
+        stats.resyncs = resyncs.load(std::memory_order_relaxed);
+        stats.saturatedUpdates = saturatedUpdates.load(std::memory_order_relaxed);
+        return stats;
+    }
+}
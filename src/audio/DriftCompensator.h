@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace host::audio
+{
+    /// Measures the device's sample clock against the host's clock and gives
+    /// the factor that keeps the engine running at its nominal rate in host
+    /// time. The device callback is the only place both clocks can be seen:
+    /// the resampler FIFOs are filled and drained in that same callback, so
+    /// their fill level follows the device clock alone and cannot show drift.
+    ///
+    /// A second-order delay-locked loop filters the callback timestamps
+    /// (the driver's host time, or the time the callback started) against the
+    /// samples each callback delivers. Its period estimate converges on the
+    /// device's actual rate; jitter in the timestamps is averaged out over
+    /// roughly 1 / kBandwidthHz seconds. A jump larger than kResyncSeconds
+    /// (a stalled or restarted device) restarts the time estimate but keeps
+    /// the rate.
+    ///
+    /// update() runs on the device callback thread and never locks or
+    /// allocates; getRateFactor() and getStats() may be called from any
+    /// thread.
+    class DriftCompensator
+    {
+    public:
+        struct Stats
+        {
+            bool locked { false };            ///< Settled; the factor is applied
+            double correctionPpm { 0.0 };     ///< Rate correction applied to the resamplers
+            double driftPpm { 0.0 };          ///< Device clock against the host clock, unclamped
+            double peakCorrectionPpm { 0.0 }; ///< Largest |correction| since reset()
+            double timingErrorUs { 0.0 };     ///< Last callback time minus the loop's prediction
+            std::uint64_t resyncs { 0 };      ///< Timestamp jumps that restarted the loop
+            std::uint64_t saturatedUpdates { 0 }; ///< Updates clamped at kMaxCorrection
+        };
+
+        static constexpr double kBandwidthHz = 0.05;
+        static constexpr double kSettleSeconds = 10.0;
+        static constexpr double kResyncSeconds = 0.1;
+        static constexpr double kMaxCorrection = 0.002; ///< 2000 ppm
+
+        /// nominalRate is the rate the device was opened at.
+        void prepare(double nominalRate) noexcept;
+        void reset() noexcept;
+
+        /// Device callback thread: a callback of numSamples started at timeNs.
+        void update(int numSamples, std::uint64_t timeNs) noexcept;
+
+        /// Any thread: actual over nominal device rate, 1 until the loop has
+        /// settled.
+        [[nodiscard]] double getRateFactor() const noexcept;
+
+        [[nodiscard]] Stats getStats() const noexcept;
+
+    private:
+        double nominalPeriod { 1.0 / 48000.0 }; // Seconds per sample
+        double period { 1.0 / 48000.0 };
+        double filteredTime { 0.0 };            // Seconds, relative to origin
+        std::uint64_t originNs { 0 };
+        int previousSamples { 0 };
+        double settleElapsed { 0.0 };
+        bool primed { false };
+
+        std::atomic<bool> locked { false };
+        std::atomic<double> factor { 1.0 };
+        std::atomic<double> drift { 0.0 };
+        std::atomic<double> peakCorrection { 0.0 };
+        std::atomic<double> timingError { 0.0 };
+        std::atomic<std::uint64_t> resyncs { 0 };
+        std::atomic<std::uint64_t> saturatedUpdates { 0 };
+    };
+}
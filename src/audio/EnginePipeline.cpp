@@ -0,0 +1,216 @@
+#include "audio/EnginePipeline.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace host::audio
+{
+    namespace
+    {
+        constexpr int kStopTimeoutMs = 1000;
+
+        // Copy `numSamples` of every channel between a linear block and a
+        // FIFO region, given as the two segments AbstractFifo hands out.
+        template <typename CopyFn>
+        void forEachSegment(int start1, int size1, int start2, int size2, CopyFn&& copy)
+        {
+            if (size1 > 0)
+                copy(start1, 0, size1);
+            if (size2 > 0)
+                copy(start2, size1, size2);
+        }
+    }
+
+    class EnginePipeline::EngineThread final : public juce::Thread
+    {
+    public:
+        explicit EngineThread(EnginePipeline& pipelineIn)
+            : juce::Thread("Engine pipeline")
+            , pipeline(pipelineIn)
+        {
+        }
+
+        void run() override
+        {
+            pipeline.engineLoop(*this);
+        }
+
+    private:
+        EnginePipeline& pipeline;
+    };
+
+    EnginePipeline::EnginePipeline(int numChannelsIn, int blockSizeIn, int depthIn, RenderFunction renderIn)
+        : numChannels(std::max(1, numChannelsIn))
+        , blockSize(std::max(1, blockSizeIn))
+        , depth(std::max(1, depthIn))
+        , render(std::move(renderIn))
+        // Room for the primed blocks, one in flight on each side and a
+        // device buffer of up to twice the block size.
+        , inputFifo(blockSize * (depth + 3) + 1)
+        , outputFifo(blockSize * (depth + 3) + 1)
+    {
+        inputStorage.setSize(numChannels, inputFifo.getTotalSize());
+        outputStorage.setSize(numChannels, outputFifo.getTotalSize());
+        renderInput.setSize(numChannels, blockSize);
+        renderOutput.setSize(numChannels, blockSize);
+        inputStorage.clear();
+        outputStorage.clear();
+
+        // Both threads touch the FIFO storage, so they work on raw channel
+        // pointers taken once here rather than on the AudioBuffers, whose
+        // isClear flag is not thread-safe.
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            inputData.push_back(inputStorage.getWritePointer(ch));
+            outputData.push_back(outputStorage.getWritePointer(ch));
+        }
+
+        // Prime the output with `depth` blocks of silence: the slack the
+        // engine thread renders ahead with.
+        int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
+        outputFifo.prepareToWrite(blockSize * depth, start1, size1, start2, size2);
+        outputFifo.finishedWrite(size1 + size2);
+
+        thread = std::make_unique<EngineThread>(*this);
+        // Same deadline as the device callback, so ask for the same class of
+        // scheduling; fall back to the highest normal priority without it.
+        if (! thread->startRealtimeThread(juce::Thread::RealtimeOptions {}))
+            thread->startThread(juce::Thread::Priority::highest);
+    }
+
+    EnginePipeline::~EnginePipeline()
+    {
+        stop();
+    }
+
+    void EnginePipeline::stop()
+    {
+        if (thread == nullptr)
+            return;
+
+        stopping.store(true, std::memory_order_release);
+        thread->signalThreadShouldExit();
+        wakeCounter.fetch_add(1, std::memory_order_release);
+        wakeCounter.notify_all();
+        thread->stopThread(kStopTimeoutMs);
+        thread.reset();
+    }
+
+    void EnginePipeline::exchange(const float* const* inputs,
+                                  int numInputChannels,
+                                  float* const* outputs,
+                                  int numOutputChannels,
+                                  int numSamples) noexcept
+    {
+        if (numSamples <= 0)
+            return;
+
+        int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
+
+        if (inputFifo.getFreeSpace() < numSamples)
+        {
+            // The engine thread has fallen a whole FIFO behind; drop this
+            // block rather than wait for it.
+            overruns.store(overruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+        else
+        {
+            inputFifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+            forEachSegment(start1, size1, start2, size2, [&](int fifoPos, int offset, int count)
+            {
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    const float* source = (inputs != nullptr && ch < numInputChannels) ? inputs[ch] : nullptr;
+                    auto* dest = inputData[static_cast<size_t>(ch)] + fifoPos;
+                    if (source != nullptr)
+                        juce::FloatVectorOperations::copy(dest, source + offset, count);
+                    else
+                        juce::FloatVectorOperations::clear(dest, count);
+                }
+            });
+            inputFifo.finishedWrite(size1 + size2);
+        }
+
+        const int ready = std::min(outputFifo.getNumReady(), numSamples);
+        outputFifo.prepareToRead(ready, start1, size1, start2, size2);
+        forEachSegment(start1, size1, start2, size2, [&](int fifoPos, int offset, int count)
+        {
+            for (int ch = 0; ch < std::min(numChannels, numOutputChannels); ++ch)
+            {
+                if (outputs != nullptr && outputs[ch] != nullptr)
+                    juce::FloatVectorOperations::copy(outputs[ch] + offset, outputData[static_cast<size_t>(ch)] + fifoPos, count);
+            }
+        });
+        outputFifo.finishedRead(size1 + size2);
+
+        if (ready < numSamples)
+        {
+            underruns.store(underruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            for (int ch = 0; ch < numOutputChannels; ++ch)
+            {
+                if (outputs != nullptr && outputs[ch] != nullptr)
+                    juce::FloatVectorOperations::clear(outputs[ch] + ready, numSamples - ready);
+            }
+        }
+
+        wakeCounter.fetch_add(1, std::memory_order_release);
+        wakeCounter.notify_one();
+    }
+
+    EnginePipeline::Stats EnginePipeline::getStats() const noexcept
+    {
+        Stats stats;
+        stats.blocksRendered = blocksRendered.load(std::memory_order_relaxed);
+        stats.underruns = underruns.load(std::memory_order_relaxed);
+        stats.overruns = overruns.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    void EnginePipeline::engineLoop(EngineThread& engineThread)
+    {
+        while (! engineThread.threadShouldExit() && ! stopping.load(std::memory_order_acquire))
+        {
+            // Read the counter before rendering so a callback that lands
+            // meanwhile makes the wait below return straight away.
+            const auto seen = wakeCounter.load(std::memory_order_acquire);
+            renderAvailableBlocks();
+            wakeCounter.wait(seen, std::memory_order_acquire);
+        }
+    }
+
+    void EnginePipeline::renderAvailableBlocks() noexcept
+    {
+        int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
+
+        while (! stopping.load(std::memory_order_relaxed)
+               && inputFifo.getNumReady() >= blockSize
+               && outputFifo.getFreeSpace() >= blockSize)
+        {
+            inputFifo.prepareToRead(blockSize, start1, size1, start2, size2);
+            forEachSegment(start1, size1, start2, size2, [&](int fifoPos, int offset, int count)
+            {
+                for (int ch = 0; ch < numChannels; ++ch)
+                    juce::FloatVectorOperations::copy(renderInput.getWritePointer(ch, offset),
+                                                      inputData[static_cast<size_t>(ch)] + fifoPos,
+                                                      count);
+            });
+            inputFifo.finishedRead(size1 + size2);
+
+            renderOutput.clear();
+            if (render)
+                render(renderInput.getArrayOfReadPointers(), renderOutput.getArrayOfWritePointers(), numChannels, blockSize);
+
+            outputFifo.prepareToWrite(blockSize, start1, size1, start2, size2);
+            forEachSegment(start1, size1, start2, size2, [&](int fifoPos, int offset, int count)
+            {
+                for (int ch = 0; ch < numChannels; ++ch)
+                    juce::FloatVectorOperations::copy(outputData[static_cast<size_t>(ch)] + fifoPos,
+                                                      renderOutput.getReadPointer(ch, offset),
+                                                      count);
+            });
+            outputFifo.finishedWrite(size1 + size2);
+
+            blocksRendered.store(blocksRendered.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+    }
+}
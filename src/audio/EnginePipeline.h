@@ -0,0 +1,93 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace host::audio
+{
+    /// Decouples graph rendering from the device callback. The callback only
+    /// swaps audio with two lock-free SPSC FIFOs (juce::AbstractFifo); a
+    /// realtime engine thread drains the input FIFO in fixed blocks, renders
+    /// them and fills the output FIFO.
+    ///
+    /// The output FIFO starts `depth` blocks full of silence. That is the
+    /// latency the pipeline adds, and it is what gives the engine thread a
+    /// whole device period (plus a block per extra unit of depth) to render
+    /// instead of whatever is left of the callback.
+    class EnginePipeline
+    {
+    public:
+        /// Engine thread: render numSamples from inputs into outputs. Every
+        /// output channel must be written.
+        using RenderFunction = std::function<void(const float* const* inputs,
+                                                  float* const* outputs,
+                                                  int numChannels,
+                                                  int numSamples)>;
+
+        struct Stats
+        {
+            std::uint64_t blocksRendered { 0 };
+            std::uint64_t underruns { 0 }; ///< Callbacks the output FIFO could not fill
+            std::uint64_t overruns { 0 };  ///< Callbacks whose input did not fit
+        };
+
+        EnginePipeline(int numChannels, int blockSize, int depth, RenderFunction render);
+        ~EnginePipeline();
+
+        EnginePipeline(const EnginePipeline&) = delete;
+        EnginePipeline& operator=(const EnginePipeline&) = delete;
+
+        /// Message thread: stop and join the engine thread. Afterwards
+        /// exchange() just plays silence. Called before the owning state is
+        /// dropped so a device callback holding the last reference never has
+        /// to join a thread.
+        void stop();
+
+        /// Device callback: queue the input, hand back rendered output (or
+        /// silence on underrun) and wake the engine thread. Never blocks.
+        void exchange(const float* const* inputs,
+                      int numInputChannels,
+                      float* const* outputs,
+                      int numOutputChannels,
+                      int numSamples) noexcept;
+
+        [[nodiscard]] int getBlockSize() const noexcept { return blockSize; }
+        [[nodiscard]] int getDepth() const noexcept { return depth; }
+        [[nodiscard]] int getLatencySamples() const noexcept { return blockSize * depth; }
+        [[nodiscard]] Stats getStats() const noexcept;
+
+    private:
+        class EngineThread;
+
+        void engineLoop(EngineThread& thread);
+        void renderAvailableBlocks() noexcept;
+
+        const int numChannels;
+        const int blockSize;
+        const int depth;
+        RenderFunction render;
+
+        juce::AbstractFifo inputFifo;
+        juce::AbstractFifo outputFifo;
+        juce::AudioBuffer<float> inputStorage;
+        juce::AudioBuffer<float> outputStorage;
+        std::vector<float*> inputData;
+        std::vector<float*> outputData;
+        juce::AudioBuffer<float> renderInput;
+        juce::AudioBuffer<float> renderOutput;
+
+        std::atomic<std::uint32_t> wakeCounter { 0 };
+        std::atomic<bool> stopping { false };
+        std::atomic<std::uint64_t> blocksRendered { 0 };
+        std::atomic<std::uint64_t> underruns { 0 };
+        std::atomic<std::uint64_t> overruns { 0 };
+
+        std::unique_ptr<EngineThread> thread;
+    };
+}
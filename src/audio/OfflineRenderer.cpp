@@ -0,0 +1,287 @@
+#include "audio/OfflineRenderer.h"
+
+#include <juce_audio_formats/juce_audio_formats.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <utility>
+
+namespace host::audio
+{
+    namespace
+    {
+        constexpr double defaultSampleRate = 48000.0;
+        constexpr double sweepStartHz = 20.0;
+        // How often (in rendered audio) the progress callback is asked.
+        constexpr double progressIntervalSeconds = 1.0;
+
+        class SignalGenerator final : public juce::AudioSource
+        {
+        public:
+            SignalGenerator(const OfflineRenderOptions& options, double sampleRateIn, juce::int64 lengthIn)
+                : signal(options.signal)
+                , sampleRate(sampleRateIn)
+                , length(lengthIn)
+                , gain(juce::Decibels::decibelsToGain(options.signalGainDb))
+                , frequency(std::clamp(options.signalFrequencyHz, 1.0, sampleRateIn * 0.49))
+                , sweepEndHz(sampleRateIn * 0.45)
+            {
+            }
+
+            void prepareToPlay(int, double) override {}
+            void releaseResources() override {}
+
+            void getNextAudioBlock(const juce::AudioSourceChannelInfo& info) override
+            {
+                auto& buffer = *info.buffer;
+                buffer.clear(info.startSample, info.numSamples);
+                if (signal == TestSignal::silence || buffer.getNumChannels() == 0)
+                {
+                    position += info.numSamples;
+                    return;
+                }
+
+                // Generate the first channel, then copy it: every channel
+                // carries the same signal.
+                auto* first = buffer.getWritePointer(0, info.startSample);
+                for (int i = 0; i < info.numSamples; ++i, ++position)
+                    first[i] = gain * nextSample();
+
+                for (int ch = 1; ch < buffer.getNumChannels(); ++ch)
+                    buffer.copyFrom(ch, info.startSample, buffer, 0, info.startSample, info.numSamples);
+            }
+
+        private:
+            float nextSample() noexcept
+            {
+                const double t = static_cast<double>(position) / sampleRate;
+                switch (signal)
+                {
+                    case TestSignal::sine:
+                        return static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * frequency * t));
+                    case TestSignal::whiteNoise:
+                        return random.nextFloat() * 2.0f - 1.0f;
+                    case TestSignal::impulse:
+                        return position == 0 ? 1.0f : 0.0f;
+                    case TestSignal::sweep:
+                    {
+                        // Exponential sweep: phase = 2*pi*f0*T/k * (e^(k*t/T) - 1),
+                        // k = ln(f1/f0).
+                        const double duration = std::max(1.0, static_cast<double>(length)) / sampleRate;
+                        const double k = std::log(sweepEndHz / sweepStartHz);
+                        const double phase = juce::MathConstants<double>::twoPi * sweepStartHz * duration / k
+                                           * (std::exp(k * t / duration) - 1.0);
+                        return static_cast<float>(std::sin(phase));
+                    }
+                    case TestSignal::silence:
+                        break;
+                }
+                return 0.0f;
+            }
+
+            const TestSignal signal;
+            const double sampleRate;
+            const juce::int64 length;
+            const float gain;
+            const double frequency;
+            const double sweepEndHz;
+            juce::int64 position { 0 };
+            juce::Random random { 0x5eed };
+        };
+
+        [[nodiscard]] std::unique_ptr<juce::AudioFormat> formatForFile(const juce::File& file)
+        {
+            const auto extension = file.getFileExtension().toLowerCase();
+            if (extension == ".wav")
+                return std::make_unique<juce::WavAudioFormat>();
+            if (extension == ".flac")
+                return std::make_unique<juce::FlacAudioFormat>();
+            return {};
+        }
+    }
+
+    OfflineRenderer::OfflineRenderer(std::shared_ptr<host::graph::GraphEngine> graphIn)
+        : graph(std::move(graphIn))
+    {
+    }
+
+    OfflineRenderResult OfflineRenderer::render(const OfflineRenderOptions& options, const ProgressCallback& progress)
+    {
+        OfflineRenderResult result;
+        if (graph == nullptr)
+        {
+            result.error = "No graph to render";
+            return result;
+        }
+
+        const int numChannels = std::max(1, options.numChannels);
+        const int blockSize = std::max(1, options.blockSize);
+
+        // Source: the input file (resampled when the render rate differs) or
+        // a generator.
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        std::unique_ptr<juce::AudioFormatReaderSource> fileSource;
+        std::unique_ptr<juce::AudioSource> source;
+        double sampleRate = options.sampleRate;
+        juce::int64 sourceLength = 0;
+
+        if (options.inputFile != juce::File())
+        {
+            auto* reader = formatManager.createReaderFor(options.inputFile);
+            if (reader == nullptr)
+            {
+                result.error = "Cannot read input file " + options.inputFile.getFullPathName();
+                return result;
+            }
+
+            const double fileRate = reader->sampleRate;
+            const auto fileLength = reader->lengthInSamples;
+            fileSource = std::make_unique<juce::AudioFormatReaderSource>(reader, true);
+            if (sampleRate <= 0.0)
+                sampleRate = fileRate;
+
+            if (std::abs(sampleRate - fileRate) > 1.0e-6)
+            {
+                auto resampler = std::make_unique<juce::ResamplingAudioSource>(fileSource.get(), false, numChannels);
+                resampler->setResamplingRatio(fileRate / sampleRate);
+                source = std::move(resampler);
+                sourceLength = static_cast<juce::int64>(std::ceil(static_cast<double>(fileLength) * sampleRate / fileRate));
+            }
+            else
+            {
+                sourceLength = fileLength;
+            }
+        }
+        else
+        {
+            if (sampleRate <= 0.0)
+                sampleRate = defaultSampleRate;
+            sourceLength = static_cast<juce::int64>(std::max(0.0, options.signalSeconds) * sampleRate);
+            source = std::make_unique<SignalGenerator>(options, sampleRate, sourceLength);
+        }
+
+        auto* input = source != nullptr ? source.get() : static_cast<juce::AudioSource*>(fileSource.get());
+        input->prepareToPlay(blockSize, sampleRate);
+        result.sampleRate = sampleRate;
+
+        // Destination.
+        std::unique_ptr<juce::AudioFormatWriter> writer;
+        if (options.outputFile != juce::File())
+        {
+            auto format = formatForFile(options.outputFile);
+            if (format == nullptr)
+            {
+                result.error = "Unsupported output format (use .wav or .flac): " + options.outputFile.getFullPathName();
+                return result;
+            }
+
+            const auto bitDepths = format->getPossibleBitDepths();
+            int bits = bitDepths.contains(options.bitsPerSample) ? options.bitsPerSample : 24;
+            if (! bitDepths.contains(bits) && ! bitDepths.isEmpty())
+                bits = bitDepths.getLast();
+
+            options.outputFile.deleteFile();
+            auto stream = options.outputFile.createOutputStream();
+            if (stream == nullptr)
+            {
+                result.error = "Cannot create output file " + options.outputFile.getFullPathName();
+                return result;
+            }
+
+            writer.reset(format->createWriterFor(stream.get(), sampleRate, static_cast<unsigned int>(numChannels),
+                                                 bits, {}, 0));
+            if (writer == nullptr)
+            {
+                result.error = "Cannot write " + juce::String(bits) + "-bit " + format->getFormatName()
+                             + " at " + juce::String(sampleRate) + " Hz";
+                return result;
+            }
+            stream.release(); // Owned by the writer now
+        }
+
+        // Graph. Non-realtime has to be set before prepare(), which is when
+        // hosted plug-ins pick it up.
+        try
+        {
+            graph->setNonRealtime(true);
+            graph->setEngineFormat(sampleRate, blockSize);
+            graph->setBusChannels(numChannels);
+            graph->setWorkerCount(std::max(0, options.workerThreads));
+            graph->prepare();
+        }
+        catch (const std::exception& e)
+        {
+            graph->setNonRealtime(false);
+            result.error = "Failed to prepare the graph: " + juce::String(e.what());
+            return result;
+        }
+
+        const int latency = options.trimLatency ? std::max(0, graph->getRuntimeStats().latencySamples) : 0;
+        const auto tailLength = static_cast<juce::int64>(std::max(0.0, options.tailSeconds) * sampleRate);
+        const auto totalLength = sourceLength + tailLength + latency;
+        const auto progressInterval = static_cast<juce::int64>(progressIntervalSeconds * sampleRate);
+        result.latencySamples = latency;
+
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+        juce::int64 nextProgress = 0;
+        bool cancelled = false;
+
+        const auto started = std::chrono::steady_clock::now();
+        while (result.samplesRendered < totalLength)
+        {
+            const auto position = result.samplesRendered;
+            const int numSamples = static_cast<int>(std::min<juce::int64>(blockSize, totalLength - position));
+            buffer.setSize(numChannels, numSamples, false, false, true);
+
+            const int fromSource = static_cast<int>(std::clamp<juce::int64>(sourceLength - position, 0, numSamples));
+            if (fromSource > 0)
+                input->getNextAudioBlock(juce::AudioSourceChannelInfo(&buffer, 0, fromSource));
+            if (fromSource < numSamples)
+                buffer.clear(fromSource, numSamples - fromSource);
+
+            static_cast<void>(graph->process(buffer));
+            result.samplesRendered += numSamples;
+
+            // The first `latency` samples are the graph filling up.
+            const int skip = static_cast<int>(std::clamp<juce::int64>(latency - position, 0, numSamples));
+            if (writer != nullptr && skip < numSamples)
+                writer->writeFromAudioSampleBuffer(buffer, skip, numSamples - skip);
+            result.samplesWritten += numSamples - skip;
+
+            if (progress && result.samplesRendered >= nextProgress)
+            {
+                nextProgress = result.samplesRendered + progressInterval;
+                if (! progress(static_cast<double>(result.samplesRendered) / static_cast<double>(std::max<juce::int64>(1, totalLength))))
+                {
+                    cancelled = true;
+                    break;
+                }
+            }
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - started;
+
+        writer.reset(); // Flushes and finalises the file header
+        input->releaseResources();
+        graph->setNonRealtime(false);
+
+        result.wallSeconds = std::chrono::duration<double>(elapsed).count();
+        if (result.wallSeconds > 0.0)
+            result.realtimeFactor = static_cast<double>(result.samplesRendered) / sampleRate / result.wallSeconds;
+
+        if (cancelled)
+        {
+            result.error = "Render cancelled";
+            return result;
+        }
+
+        if (progress)
+            progress(1.0);
+
+        result.succeeded = true;
+        return result;
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+
+#include <functional>
+#include <memory>
+
+#include "graph/GraphEngine.h"
+
+namespace host::audio
+{
+    /// Generated input for renders without an input file.
+    enum class TestSignal
+    {
+        silence,
+        sine,
+        whiteNoise,
+        impulse, ///< One full-scale sample at the start, then silence
+        sweep    ///< Exponential sine sweep from 20 Hz to 90% of Nyquist
+    };
+
+    struct OfflineRenderOptions
+    {
+        // Input: an audio file in any format JUCE reads, or a generated
+        // signal when inputFile is left empty.
+        juce::File inputFile;
+        TestSignal signal { TestSignal::sine };
+        double signalSeconds { 10.0 };
+        double signalFrequencyHz { 1000.0 };
+        float signalGainDb { -12.0f };
+
+        // Output: .wav or .flac, chosen by extension. Left empty, the render
+        // runs and the audio is dropped, which is what benchmarks want.
+        juce::File outputFile;
+        int bitsPerSample { 24 };
+
+        // 0 = the input file's rate, or 48 kHz for generated signals. A file
+        // at another rate is resampled on the way in.
+        double sampleRate { 0.0 };
+        int blockSize { 512 };
+        int numChannels { 2 };
+        // GraphEngine worker threads for independent branches (see
+        // GraphEngine::setWorkerCount). 0 = render on the calling thread.
+        int workerThreads { 0 };
+        // Keep rendering this long after the input ends so reverb and delay
+        // tails make it into the file.
+        double tailSeconds { 2.0 };
+        // Drop the graph's latency from the start of the output so it lines
+        // up sample for sample with the input.
+        bool trimLatency { true };
+    };
+
+    struct OfflineRenderResult
+    {
+        bool succeeded { false };
+        juce::String error;
+        double sampleRate { 0.0 };
+        int latencySamples { 0 };
+        juce::int64 samplesRendered { 0 }; ///< Processed by the graph, latency and tail included
+        juce::int64 samplesWritten { 0 };
+        double wallSeconds { 0.0 };
+        double realtimeFactor { 0.0 };     ///< Seconds of audio rendered per second of wall time
+    };
+
+    /// Drives a GraphEngine from a file or a generated signal as fast as the
+    /// CPU allows, instead of from a device callback, and writes the result
+    /// through JUCE's audio formats. Nodes are switched to non-realtime mode
+    /// for the render (see Node::setNonRealtime), so hosted plug-ins may
+    /// use their offline quality settings.
+    ///
+    /// render() prepares the graph for the render format itself, so the
+    /// graph must not be playing on a device at the same time. Afterwards it
+    /// is left prepared for that format; prepare it again before handing it
+    /// back to a device.
+    class OfflineRenderer
+    {
+    public:
+        /// Called between blocks with the progress in [0, 1]. Returning false
+        /// cancels the render.
+        using ProgressCallback = std::function<bool(double progress)>;
+
+        explicit OfflineRenderer(std::shared_ptr<host::graph::GraphEngine> graph);
+
+        [[nodiscard]] OfflineRenderResult render(const OfflineRenderOptions& options,
+                                                 const ProgressCallback& progress = {});
+
+    private:
+        std::shared_ptr<host::graph::GraphEngine> graph;
+    };
+}
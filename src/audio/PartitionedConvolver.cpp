@@ -0,0 +1,261 @@
+#include "audio/PartitionedConvolver.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace host::audio
+{
+    PartitionedConvolver::Kernel::Kernel(const float* impulse, int length, int partitionSizeIn)
+        : partitionSize(std::max(1, partitionSizeIn))
+    {
+        length = impulse != nullptr ? std::max(0, length) : 0;
+        numPartitions = std::max(1, (length + partitionSize - 1) / partitionSize);
+
+        const int fftSize = 2 * partitionSize;
+        const int bins = partitionSize + 1;
+        juce::dsp::FFT transform(fftOrderFor(fftSize));
+        std::vector<float> buffer(static_cast<size_t>(2 * fftSize));
+        spectra.resize(static_cast<size_t>(numPartitions) * static_cast<size_t>(2 * bins));
+
+        for (int p = 0; p < numPartitions; ++p)
+        {
+            // Each partition zero-padded to the FFT size, so the overlap-save
+            // window's circular wrap lands only in the discarded half.
+            std::fill(buffer.begin(), buffer.end(), 0.0f);
+            const int offset = p * partitionSize;
+            const int count = std::clamp(length - offset, 0, partitionSize);
+            if (count > 0)
+                std::memcpy(buffer.data(), impulse + offset, static_cast<size_t>(count) * sizeof(float));
+
+            transform.performRealOnlyForwardTransform(buffer.data(), true);
+            std::memcpy(spectra.data() + static_cast<size_t>(p) * static_cast<size_t>(2 * bins), buffer.data(),
+                        static_cast<size_t>(2 * bins) * sizeof(float));
+        }
+    }
+
+    void PartitionedConvolver::prepare(int partitionSizeIn, int maxPartitionsIn, int maxChannels)
+    {
+        const int newPartitionSize = 1 << fftOrderFor(std::max(1, partitionSizeIn));
+        if (kernel != nullptr && kernel->partitionSize != newPartitionSize)
+            kernel.reset();
+
+        partitionSize = newPartitionSize;
+        numBins = partitionSize + 1;
+        maxPartitions = std::max(1, maxPartitionsIn);
+        fft = std::make_unique<juce::dsp::FFT>(fftOrderFor(2 * partitionSize));
+
+        channels.resize(static_cast<size_t>(std::max(1, maxChannels)));
+        for (auto& channel : channels)
+        {
+            channel.window.assign(static_cast<size_t>(2 * partitionSize), 0.0f);
+            channel.output.assign(static_cast<size_t>(partitionSize), 0.0f);
+            channel.history.assign(static_cast<size_t>(maxPartitions) * static_cast<size_t>(2 * numBins), 0.0f);
+        }
+        fftBuffer.assign(static_cast<size_t>(4 * partitionSize), 0.0f);
+        fadeBuffer.assign(static_cast<size_t>(4 * partitionSize), 0.0f);
+        position = 0;
+        historyHead = 0;
+        activeChannels = 0;
+    }
+
+    void PartitionedConvolver::reset() noexcept
+    {
+        for (auto& channel : channels)
+        {
+            std::fill(channel.window.begin(), channel.window.end(), 0.0f);
+            std::fill(channel.output.begin(), channel.output.end(), 0.0f);
+            std::fill(channel.history.begin(), channel.history.end(), 0.0f);
+        }
+        position = 0;
+        historyHead = 0;
+    }
+
+    void PartitionedConvolver::setKernel(std::unique_ptr<Kernel> newKernel)
+    {
+        if (newKernel != nullptr && partitionSize > 0 && newKernel->partitionSize != partitionSize)
+            newKernel.reset();
+
+        // A kernel still in flight from publishKernel() is older than this one.
+        handoff.clear();
+        kernel = std::move(newKernel);
+    }
+
+    void PartitionedConvolver::publishKernel(std::unique_ptr<Kernel> newKernel)
+    {
+        if (newKernel == nullptr || newKernel->partitionSize != partitionSize)
+        {
+            handoff.collect();
+            return;
+        }
+        handoff.publish(std::move(newKernel));
+    }
+
+    void PartitionedConvolver::process(const float* const* inputs, float* const* outputs, int numChannels, int numSamples) noexcept
+    {
+        if (outputs == nullptr || numSamples <= 0)
+            return;
+
+        activeChannels = partitionSize > 0 ? std::clamp(numChannels, 0, static_cast<int>(channels.size())) : 0;
+        for (int ch = activeChannels; ch < numChannels; ++ch)
+        {
+            if (outputs[ch] != nullptr)
+                juce::FloatVectorOperations::clear(outputs[ch], numSamples);
+        }
+        if (activeChannels == 0)
+            return;
+
+        int done = 0;
+        while (done < numSamples)
+        {
+            const int count = std::min(partitionSize - position, numSamples - done);
+
+            // Every input of the chunk is read before any output is written,
+            // which keeps in-place calls and shared input channels correct.
+            for (int ch = 0; ch < activeChannels; ++ch)
+            {
+                float* collected = channels[static_cast<size_t>(ch)].window.data() + partitionSize + position;
+                const float* source = inputs != nullptr ? inputs[ch] : nullptr;
+                if (source != nullptr)
+                    std::memcpy(collected, source + done, static_cast<size_t>(count) * sizeof(float));
+                else
+                    std::fill(collected, collected + count, 0.0f);
+            }
+
+            for (int ch = 0; ch < activeChannels; ++ch)
+            {
+                if (float* dest = outputs[ch])
+                    std::memcpy(dest + done, channels[static_cast<size_t>(ch)].output.data() + position,
+                                static_cast<size_t>(count) * sizeof(float));
+            }
+
+            position += count;
+            done += count;
+            if (position == partitionSize)
+            {
+                processPartition();
+                position = 0;
+            }
+        }
+    }
+
+    void PartitionedConvolver::processBlock(const float* const* inputs, float* const* outputs, int numChannels) noexcept
+    {
+        if (outputs == nullptr || partitionSize <= 0)
+            return;
+
+        activeChannels = std::clamp(numChannels, 0, static_cast<int>(channels.size()));
+        const auto bytes = static_cast<size_t>(partitionSize) * sizeof(float);
+        for (int ch = 0; ch < activeChannels; ++ch)
+        {
+            float* collected = channels[static_cast<size_t>(ch)].window.data() + partitionSize;
+            const float* source = inputs != nullptr ? inputs[ch] : nullptr;
+            if (source != nullptr)
+                std::memcpy(collected, source, bytes);
+            else
+                std::fill(collected, collected + partitionSize, 0.0f);
+        }
+
+        processPartition();
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            if (float* dest = outputs[ch])
+            {
+                if (ch < activeChannels)
+                    std::memcpy(dest, channels[static_cast<size_t>(ch)].output.data(), bytes);
+                else
+                    juce::FloatVectorOperations::clear(dest, partitionSize);
+            }
+        }
+    }
+
+    int PartitionedConvolver::fftOrderFor(int size) noexcept
+    {
+        int order = 0;
+        while ((1 << order) < size)
+            ++order;
+        return order;
+    }
+
+    void PartitionedConvolver::processPartition() noexcept
+    {
+        // Take a newly published kernel, unless the last swapped-out one has
+        // not been collected yet; it is then taken at a later partition.
+        Kernel* outgoing = nullptr;
+        bool swapped = false;
+        if (auto* next = handoff.take())
+        {
+            outgoing = kernel.release();
+            kernel.reset(next);
+            swapped = true;
+        }
+
+        historyHead = (historyHead + 1) % maxPartitions;
+        const auto binFloats = static_cast<size_t>(2 * numBins);
+        for (int ch = 0; ch < activeChannels; ++ch)
+        {
+            auto& channel = channels[static_cast<size_t>(ch)];
+
+            std::memcpy(fftBuffer.data(), channel.window.data(), static_cast<size_t>(2 * partitionSize) * sizeof(float));
+            std::fill(fftBuffer.begin() + 2 * partitionSize, fftBuffer.end(), 0.0f);
+            fft->performRealOnlyForwardTransform(fftBuffer.data(), true);
+            std::memcpy(channel.history.data() + static_cast<size_t>(historyHead) * binFloats, fftBuffer.data(),
+                        binFloats * sizeof(float));
+
+            // The partition just collected becomes the first half of the
+            // next window.
+            std::memcpy(channel.window.data(), channel.window.data() + partitionSize,
+                        static_cast<size_t>(partitionSize) * sizeof(float));
+
+            if (kernel == nullptr)
+            {
+                std::fill(channel.output.begin(), channel.output.end(), 0.0f);
+                continue;
+            }
+
+            // Overlap-save: the second half of the inverse transform is the
+            // valid linear convolution output.
+            convolve(*kernel, channel, fftBuffer.data());
+            const float* result = fftBuffer.data() + partitionSize;
+            if (outgoing == nullptr)
+            {
+                std::memcpy(channel.output.data(), result, static_cast<size_t>(partitionSize) * sizeof(float));
+                continue;
+            }
+
+            convolve(*outgoing, channel, fadeBuffer.data());
+            const float* previous = fadeBuffer.data() + partitionSize;
+            const float step = 1.0f / static_cast<float>(partitionSize);
+            for (int i = 0; i < partitionSize; ++i)
+            {
+                const float mix = static_cast<float>(i + 1) * step;
+                channel.output[static_cast<size_t>(i)] = previous[i] + (result[i] - previous[i]) * mix;
+            }
+        }
+
+        if (swapped)
+            handoff.retire(outgoing);
+    }
+
+    void PartitionedConvolver::convolve(const Kernel& source, const Channel& channel, float* result) noexcept
+    {
+        // Interleaved re/im arithmetic rather than std::complex, whose
+        // operator* goes through the slow inf/NaN-checking path without
+        // -ffast-math.
+        std::fill(result, result + 4 * partitionSize, 0.0f);
+        const int parts = std::min(source.numPartitions, maxPartitions);
+        const auto binFloats = static_cast<size_t>(2 * numBins);
+        for (int p = 0; p < parts; ++p)
+        {
+            const int slot = (historyHead - p + maxPartitions) % maxPartitions;
+            const float* x = channel.history.data() + static_cast<size_t>(slot) * binFloats;
+            const float* h = source.spectra.data() + static_cast<size_t>(p) * binFloats;
+            for (int k = 0; k < 2 * numBins; k += 2)
+            {
+                result[k] += x[k] * h[k] - x[k + 1] * h[k + 1];
+                result[k + 1] += x[k] * h[k + 1] + x[k + 1] * h[k];
+            }
+        }
+        fft->performRealOnlyInverseTransform(result);
+    }
+}
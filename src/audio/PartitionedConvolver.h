@@ -0,0 +1,114 @@
+#pragma once
+
+#include "audio/RealtimeHandoff.h"
+
+#include <juce_dsp/juce_dsp.h>
+
+#include <memory>
+#include <vector>
+
+namespace host::audio
+{
+    /// Multi-channel uniformly partitioned FFT convolution (overlap-save with
+    /// a frequency-domain delay line). The impulse is cut into partitions of
+    /// partitionSize samples, each transformed once when the Kernel is built;
+    /// per partition of input the audio thread does one forward FFT, one
+    /// complex multiply-add per kernel partition and one inverse FFT per
+    /// channel. Input is collected in a FIFO, so the latency is exactly
+    /// partitionSize samples whatever the host block size.
+    ///
+    /// Kernels are built on any thread and handed over without locks: the
+    /// audio thread picks a published kernel up at the next partition
+    /// boundary and crossfades from the old one across that partition. The
+    /// delay line holds input spectra only, so both kernels see the same
+    /// history and the swap is click-free. The old kernel goes back to the
+    /// publishing thread for deletion; nothing is freed on the audio thread.
+    class PartitionedConvolver
+    {
+    public:
+        /// Transformed impulse response. Immutable once built.
+        class Kernel
+        {
+        public:
+            /// Allocates and runs the FFTs; call off the audio thread.
+            /// partitionSize must be a power of two.
+            Kernel(const float* impulse, int length, int partitionSize);
+
+            [[nodiscard]] int getPartitionSize() const noexcept { return partitionSize; }
+            [[nodiscard]] int getNumPartitions() const noexcept { return numPartitions; }
+
+        private:
+            friend class PartitionedConvolver;
+
+            int partitionSize { 0 };
+            int numPartitions { 0 };
+            // numPartitions rows of partitionSize + 1 interleaved re/im bins.
+            std::vector<float> spectra;
+        };
+
+        PartitionedConvolver() = default;
+
+        PartitionedConvolver(const PartitionedConvolver&) = delete;
+        PartitionedConvolver& operator=(const PartitionedConvolver&) = delete;
+
+        /// Allocates for kernels of up to maxPartitions partitions and up to
+        /// maxChannels channels, and clears the state. partitionSize must be a
+        /// power of two. Keeps the current kernel if its partition size still
+        /// matches.
+        void prepare(int partitionSize, int maxPartitions, int maxChannels);
+        void reset() noexcept;
+
+        /// Not while process() may run (e.g. from prepare()): installs the
+        /// kernel at once, without a crossfade.
+        void setKernel(std::unique_ptr<Kernel> kernel);
+        /// Any one other thread, while process() runs. Replaces a kernel
+        /// published earlier that the audio thread has not picked up yet,
+        /// and frees the one it last swapped out. Kernels with the wrong
+        /// partition size are dropped.
+        void publishKernel(std::unique_ptr<Kernel> kernel);
+
+        /// Audio thread, allocation-free. In place is fine, including outputs
+        /// reading the same input channel. Null inputs count as silence;
+        /// channels past the prepared maximum are cleared. Kernel partitions
+        /// past the prepared maximum are ignored.
+        void process(const float* const* inputs, float* const* outputs, int numChannels, int numSamples) noexcept;
+
+        /// Audio or worker thread, for callers that collect whole partitions
+        /// themselves: convolves exactly getPartitionSize() samples per
+        /// channel and returns their own output, without the FIFO's latency.
+        /// Use either this or process() on one convolver, not both.
+        void processBlock(const float* const* inputs, float* const* outputs, int numChannels) noexcept;
+
+        [[nodiscard]] int getLatencySamples() const noexcept { return partitionSize; }
+        [[nodiscard]] int getPartitionSize() const noexcept { return partitionSize; }
+
+        /// Order of the smallest power-of-two FFT that holds size samples.
+        [[nodiscard]] static int fftOrderFor(int size) noexcept;
+
+    private:
+        struct Channel
+        {
+            std::vector<float> window; // Previous partition, then the one being collected
+            std::vector<float> output; // Output of the last full partition
+            std::vector<float> history; // maxPartitions input spectra, ring ordered by historyHead
+        };
+
+        void processPartition() noexcept;
+        void convolve(const Kernel& kernel, const Channel& channel, float* result) noexcept;
+
+        std::unique_ptr<juce::dsp::FFT> fft;
+        int partitionSize { 0 };
+        int numBins { 0 };
+        int maxPartitions { 0 };
+        int position { 0 };
+        int historyHead { 0 };
+        int activeChannels { 0 };
+
+        std::vector<Channel> channels;
+        std::vector<float> fftBuffer;  // 2 * FFT size: real data or interleaved bins
+        std::vector<float> fadeBuffer; // Same, for the outgoing kernel during a swap
+
+        std::unique_ptr<Kernel> kernel; // Processing thread once running
+        RealtimeHandoff<Kernel> handoff;
+    };
+}
@@ -0,0 +1,292 @@
+#include "audio/PolyphaseResampler.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace host::audio
+{
+    namespace
+    {
+        // Fraction of the (lower) Nyquist frequency the passband reaches. At
+        // 44.1 kHz that is ~20 kHz, with the transition band above it.
+        constexpr double kPassband = 0.91;
+        // Kaiser window shape: ~80 dB stopband at the tap counts used here.
+        constexpr double kKaiserBeta = 8.0;
+
+        // Modified Bessel function of the first kind, order zero. Power series;
+        // std::cyl_bessel_i is not available in every standard library we ship on.
+        [[nodiscard]] double besselI0(double x) noexcept
+        {
+            double sum = 1.0;
+            double term = 1.0;
+            const double halfX = 0.5 * x;
+            for (int k = 1; k < 64; ++k)
+            {
+                term *= (halfX / k) * (halfX / k);
+                sum += term;
+                if (term < sum * 1.0e-16)
+                    break;
+            }
+            return sum;
+        }
+    }
+
+    void PolyphaseResampler::prepare(int numChannelsIn,
+                                     double speedRatio,
+                                     int maxInputChunk,
+                                     int maxOutputChunk,
+                                     bool variableRatio)
+    {
+        numChannels = std::max(0, numChannelsIn);
+        numGroups = std::max(1, (numChannels + kLanes - 1) / kLanes);
+        ratio = speedRatio > 0.0 ? speedRatio : 1.0;
+
+        // Downsampling narrows the cutoff by the ratio, so the filter needs
+        // proportionally more taps to keep the same transition band.
+        numTaps = std::clamp(kBaseTaps * static_cast<int>(std::ceil(std::max(1.0, ratio))), kBaseTaps, kMaxTaps);
+
+        exact = false;
+        numPhases = kFractionalPhases;
+        phaseStep = 0;
+        for (int steps = 1; ! variableRatio && steps <= kMaxExactPhases; ++steps)
+        {
+            const auto inputs = std::llround(ratio * steps);
+            if (inputs > 0 && std::abs(static_cast<double>(inputs) / steps - ratio) <= ratio * 1.0e-12)
+            {
+                exact = true;
+                numPhases = steps;
+                phaseStep = static_cast<int>(inputs);
+                break;
+            }
+        }
+
+        buildTable();
+        interpolatedRow.assign(static_cast<size_t>(numTaps), 0.0f);
+
+        const int maxInput = std::max(maxInputChunk, 1);
+        const int maxOutput = std::max(maxOutputChunk, 1);
+        const int base = std::max(static_cast<int>(std::ceil(maxOutput * ratio)) + numTaps + 8, maxInput);
+        capacity = std::max(base * 2, maxInput * 4);
+
+        ring.assign(static_cast<size_t>(capacity) * 2 * static_cast<size_t>(numGroups), Register::expand(0.0f));
+        accumulators.assign(static_cast<size_t>(numGroups), Register::expand(0.0f));
+
+        reset();
+    }
+
+    void PolyphaseResampler::reset() noexcept
+    {
+        std::fill(ring.begin(), ring.end(), Register::expand(0.0f));
+        readPos = 0;
+        stored = 0;
+        phase = 0;
+        fraction = 0.0;
+        overflows.store(0, std::memory_order_relaxed);
+        underflows.store(0, std::memory_order_relaxed);
+
+        // Prime with the filter's history so the first output is centred on
+        // the first input sample instead of starting half a kernel late.
+        if (capacity > 0)
+            writeFrames(nullptr, 0, std::min(numTaps / 2 - 1, capacity));
+    }
+
+    void PolyphaseResampler::setRatio(double speedRatio) noexcept
+    {
+        // The cutoff stays where prepare() put it; steering only moves the
+        // ratio by fractions of a percent.
+        if (! exact && speedRatio > 0.0)
+            ratio = speedRatio;
+    }
+
+    void PolyphaseResampler::buildTable()
+    {
+        const int rows = exact ? numPhases : numPhases + 1;
+        table.assign(static_cast<size_t>(rows) * static_cast<size_t>(numTaps), 0.0f);
+
+        const double cutoff = 0.5 * std::min(1.0, 1.0 / ratio) * kPassband;
+        const double halfLength = 0.5 * numTaps;
+        const double windowNorm = 1.0 / besselI0(kKaiserBeta);
+
+        std::vector<double> row(static_cast<size_t>(numTaps));
+        for (int r = 0; r < rows; ++r)
+        {
+            // Tap k sits (halfLength - 1 - k) samples before the output point
+            // plus the phase offset into the current frame.
+            const double frac = static_cast<double>(r) / numPhases;
+            double sum = 0.0;
+            for (int k = 0; k < numTaps; ++k)
+            {
+                const double x = (halfLength - 1.0) + frac - k;
+                const double arg = 2.0 * cutoff * x;
+                const double sinc = std::abs(arg) < 1.0e-9
+                    ? 1.0
+                    : std::sin(juce::MathConstants<double>::pi * arg) / (juce::MathConstants<double>::pi * arg);
+                const double normalised = x / halfLength;
+                const double window = std::abs(normalised) >= 1.0
+                    ? 0.0
+                    : besselI0(kKaiserBeta * std::sqrt(1.0 - normalised * normalised)) * windowNorm;
+                row[static_cast<size_t>(k)] = 2.0 * cutoff * sinc * window;
+                sum += row[static_cast<size_t>(k)];
+            }
+
+            // Unity DC gain for every phase, so a constant input never ripples.
+            const double gain = sum != 0.0 ? 1.0 / sum : 0.0;
+            auto* dest = table.data() + static_cast<size_t>(r) * static_cast<size_t>(numTaps);
+            for (int k = 0; k < numTaps; ++k)
+                dest[k] = static_cast<float>(row[static_cast<size_t>(k)] * gain);
+        }
+    }
+
+    void PolyphaseResampler::push(const float* const* inputs, int numSamples) noexcept
+    {
+        if (numSamples <= 0 || capacity <= 0)
+            return;
+
+        // Realtime-safe: a push that does not fit drops the oldest frames by
+        // advancing the read position.
+        int offset = 0;
+        if (numSamples > capacity)
+        {
+            offset = numSamples - capacity;
+            numSamples = capacity;
+        }
+
+        if (stored + numSamples > capacity)
+        {
+            consume(stored + numSamples - capacity);
+            overflows.store(overflows.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        writeFrames(inputs, offset, numSamples);
+    }
+
+    bool PolyphaseResampler::canProcess(int numOutputSamples) const noexcept
+    {
+        if (numOutputSamples <= 0 || capacity <= 0)
+            return false;
+
+        // Frames the read position moves before the last requested output,
+        // plus that output's window.
+        std::int64_t advanceBeforeLast = 0;
+        if (exact)
+            advanceBeforeLast = (phase + static_cast<std::int64_t>(numOutputSamples - 1) * phaseStep) / numPhases;
+        else
+            advanceBeforeLast = static_cast<std::int64_t>(std::floor(fraction + (numOutputSamples - 1) * ratio));
+
+        return stored >= advanceBeforeLast + numTaps;
+    }
+
+    int PolyphaseResampler::process(float* const* outputs, int numOutputSamples) noexcept
+    {
+        if (outputs == nullptr || numOutputSamples <= 0)
+            return 0;
+
+        int produced = 0;
+        for (; produced < numOutputSamples && stored >= numTaps; ++produced)
+        {
+            const float* coefficients = currentCoefficients();
+            const Register* window = ring.data() + static_cast<size_t>(readPos) * static_cast<size_t>(numGroups);
+
+            for (auto& acc : accumulators)
+                acc = Register::expand(0.0f);
+
+            for (int k = 0; k < numTaps; ++k)
+            {
+                const auto coefficient = Register::expand(coefficients[k]);
+                const Register* frame = window + static_cast<size_t>(k) * static_cast<size_t>(numGroups);
+                for (int g = 0; g < numGroups; ++g)
+                    accumulators[static_cast<size_t>(g)] = Register::multiplyAdd(accumulators[static_cast<size_t>(g)], frame[g], coefficient);
+            }
+
+            const auto* lanes = reinterpret_cast<const float*>(accumulators.data());
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                if (auto* dest = outputs[ch])
+                    dest[produced] = lanes[ch];
+            }
+
+            advance();
+        }
+
+        if (produced < numOutputSamples)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                if (auto* dest = outputs[ch])
+                    std::fill(dest + produced, dest + numOutputSamples, 0.0f);
+            }
+            underflows.store(underflows.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        return produced;
+    }
+
+    void PolyphaseResampler::writeFrames(const float* const* inputs, int inputOffset, int numFrames) noexcept
+    {
+        int writePos = readPos + stored;
+        if (writePos >= capacity)
+            writePos -= capacity;
+
+        for (int i = 0; i < numFrames; ++i)
+        {
+            auto* primary = frameData(writePos);
+            auto* mirror = frameData(writePos + capacity);
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const float value = (inputs != nullptr && inputs[ch] != nullptr) ? inputs[ch][inputOffset + i] : 0.0f;
+                primary[ch] = value;
+                mirror[ch] = value;
+            }
+
+            if (++writePos == capacity)
+                writePos = 0;
+        }
+
+        stored += numFrames;
+    }
+
+    void PolyphaseResampler::consume(int numFrames) noexcept
+    {
+        numFrames = std::min(numFrames, stored);
+        if (numFrames <= 0)
+            return;
+
+        stored -= numFrames;
+        readPos += numFrames;
+        if (readPos >= capacity)
+            readPos -= capacity;
+    }
+
+    const float* PolyphaseResampler::currentCoefficients() noexcept
+    {
+        if (exact)
+            return table.data() + static_cast<size_t>(phase) * static_cast<size_t>(numTaps);
+
+        const double position = fraction * numPhases;
+        const int row = std::min(static_cast<int>(position), numPhases - 1);
+        const auto t = static_cast<float>(position - row);
+        const float* a = table.data() + static_cast<size_t>(row) * static_cast<size_t>(numTaps);
+        const float* b = a + numTaps;
+        for (int k = 0; k < numTaps; ++k)
+            interpolatedRow[static_cast<size_t>(k)] = a[k] + t * (b[k] - a[k]);
+        return interpolatedRow.data();
+    }
+
+    void PolyphaseResampler::advance() noexcept
+    {
+        int frames = 0;
+        if (exact)
+        {
+            phase += phaseStep;
+            frames = phase / numPhases;
+            phase -= frames * numPhases;
+        }
+        else
+        {
+            fraction += ratio;
+            frames = static_cast<int>(std::floor(fraction));
+            fraction -= frames;
+        }
+        consume(frames);
+    }
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace host::audio
+{
+    /// Multi-channel polyphase FIR resampler. All channels share one FIFO of
+    /// interleaved frames padded to the SIMD width, so each filter tap is one
+    /// coefficient broadcast and a multiply-add per register of channels, and
+    /// the whole block is a single non-virtual call.
+    ///
+    /// The prototype is a Kaiser-windowed sinc. When the ratio is a fraction
+    /// with at most kMaxExactPhases output steps (44.1k <-> 48k is 147/160,
+    /// 48k <-> 96k is 1/2) the table holds exactly one row per phase and an
+    /// integer phase accumulator picks it, so there is no drift and no
+    /// coefficient interpolation. Any other ratio interpolates between
+    /// kFractionalPhases rows.
+    ///
+    /// The FIFO is a mirrored ring like ResamplerChannel's: frames are written
+    /// at their ring position and one capacity further on, so the filter
+    /// window is always contiguous.
+    class PolyphaseResampler
+    {
+    public:
+        static constexpr int kMaxExactPhases = 1024;
+        static constexpr int kFractionalPhases = 256;
+        static constexpr int kBaseTaps = 32;
+        static constexpr int kMaxTaps = 256;
+
+        /// speedRatio is input samples per output sample, as for BlockResampler.
+        /// variableRatio skips the exact-phase table so setRatio() can steer
+        /// the ratio later.
+        void prepare(int numChannels, double speedRatio, int maxInputChunk, int maxOutputChunk, bool variableRatio = false);
+        void reset() noexcept;
+        /// Audio thread. Ignored in exact-phase mode, whose table only fits
+        /// the prepared ratio.
+        void setRatio(double speedRatio) noexcept;
+
+        void push(const float* const* inputs, int numSamples) noexcept;
+        [[nodiscard]] bool canProcess(int numOutputSamples) const noexcept;
+        int process(float* const* outputs, int numOutputSamples) noexcept;
+
+        [[nodiscard]] int getNumChannels() const noexcept { return numChannels; }
+        [[nodiscard]] int getNumTaps() const noexcept { return numTaps; }
+        [[nodiscard]] int getStoredSamples() const noexcept { return stored; }
+        [[nodiscard]] bool usesExactPhases() const noexcept { return exact; }
+        /// Input samples the filter looks ahead of the sample it outputs.
+        [[nodiscard]] int getLookaheadSamples() const noexcept { return numTaps / 2; }
+        [[nodiscard]] std::uint64_t getOverflowCount() const noexcept { return overflows.load(std::memory_order_relaxed); }
+        [[nodiscard]] std::uint64_t getUnderflowCount() const noexcept { return underflows.load(std::memory_order_relaxed); }
+
+    private:
+        using Register = juce::dsp::SIMDRegister<float>;
+        static constexpr int kLanes = static_cast<int>(Register::SIMDNumElements);
+
+        void buildTable();
+        void writeFrames(const float* const* inputs, int inputOffset, int numFrames) noexcept;
+        void consume(int numFrames) noexcept;
+        [[nodiscard]] const float* currentCoefficients() noexcept;
+        void advance() noexcept;
+
+        [[nodiscard]] float* frameData(int frame) noexcept
+        {
+            return reinterpret_cast<float*>(ring.data() + static_cast<size_t>(frame) * static_cast<size_t>(numGroups));
+        }
+
+        int numChannels { 0 };
+        int numGroups { 0 }; // SIMD registers per frame
+        int numTaps { kBaseTaps };
+        double ratio { 1.0 };
+
+        // Phase table: numPhases rows of numTaps coefficients. Fractional mode
+        // keeps one extra row so the last phase can interpolate towards it.
+        bool exact { false };
+        int numPhases { 1 };
+        int phaseStep { 0 }; // Exact mode: phase advance per output, in 1/numPhases
+        std::vector<float> table;
+        std::vector<float> interpolatedRow;
+
+        int phase { 0 };          // Exact mode position within the current frame
+        double fraction { 0.0 };  // Fractional mode position within the current frame
+
+        int capacity { 0 };       // Frames
+        std::vector<Register> ring; // 2 * capacity frames: ring plus its mirror
+        std::vector<Register> accumulators;
+        int readPos { 0 };
+        int stored { 0 };
+
+        std::atomic<std::uint64_t> overflows { 0 };
+        std::atomic<std::uint64_t> underflows { 0 };
+    };
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+namespace host::audio
+{
+    /// Hands heap objects (kernels, impulse responses) from one producer
+    /// thread to the audio thread without locks, and takes the replaced ones
+    /// back so they are freed by the producer rather than on the audio thread.
+    ///
+    /// The producer publish()es; the consumer take()s the newest object and,
+    /// once it no longer reads the one that object replaces, retire()s that.
+    /// Objects published faster than they are taken are dropped unseen. A
+    /// take() waits while the previously retired object has not been
+    /// collected, so the retired slot never holds more than one object.
+    template <typename T>
+    class RealtimeHandoff
+    {
+    public:
+        RealtimeHandoff() = default;
+        ~RealtimeHandoff()
+        {
+            delete pending.exchange(nullptr);
+            delete retired.exchange(nullptr);
+        }
+
+        RealtimeHandoff(const RealtimeHandoff&) = delete;
+        RealtimeHandoff& operator=(const RealtimeHandoff&) = delete;
+
+        /// Producer thread. Also frees whatever the consumer retired since
+        /// the last call.
+        void publish(std::unique_ptr<T> next)
+        {
+            collect();
+            delete pending.exchange(next.release(), std::memory_order_acq_rel);
+        }
+
+        /// Producer thread: free what the consumer retired.
+        void collect()
+        {
+            delete retired.exchange(nullptr, std::memory_order_acquire);
+        }
+
+        /// Not while the consumer may take(): drop anything unpublished.
+        void clear()
+        {
+            delete pending.exchange(nullptr, std::memory_order_acq_rel);
+            collect();
+        }
+
+        /// Consumer thread, lock- and allocation-free: the newest published
+        /// object, now owned by the caller, or nullptr.
+        [[nodiscard]] T* take() noexcept
+        {
+            if (pending.load(std::memory_order_relaxed) == nullptr
+                || retired.load(std::memory_order_acquire) != nullptr)
+                return nullptr;
+            return pending.exchange(nullptr, std::memory_order_acq_rel);
+        }
+
+        /// Consumer thread, once per successful take(): give back the object
+        /// the taken one replaced (may be null).
+        void retire(T* old) noexcept
+        {
+            if (old != nullptr)
+                retired.store(old, std::memory_order_release);
+        }
+
+    private:
+        std::atomic<T*> pending { nullptr };
+        std::atomic<T*> retired { nullptr };
+    };
+}
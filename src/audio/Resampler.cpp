@@ -15,6 +15,7 @@ namespace host::audio
                 return std::make_unique<ResamplerChannel<juce::CatmullRomInterpolator>>();
             case ResamplerQuality::windowedSinc:
                 return std::make_unique<ResamplerChannel<juce::WindowedSincInterpolator>>();
+            case ResamplerQuality::polyphase: // Multi-channel; BlockResampler runs it directly
             case ResamplerQuality::lagrange:
             default:
                 return std::make_unique<ResamplerChannel<juce::LagrangeInterpolator>>();
@@ -3,11 +3,15 @@
 #include <juce_audio_basics/juce_audio_basics.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstdint>
 #include <cstring>
 #include <memory>
 #include <vector>
 
+#include "audio/PolyphaseResampler.h"
+
 namespace host::audio
 {
     /// Quality presets for the device-engine resampler. Index matches the
@@ -17,7 +21,8 @@ namespace host::audio
         linear = 0,
         catmullRom = 1,
         lagrange = 2,
-        windowedSinc = 3
+        windowedSinc = 3,
+        polyphase = 4 ///< Multi-channel SIMD polyphase FIR (PolyphaseResampler)
     };
 
     [[nodiscard]] inline ResamplerQuality resamplerQualityFromIndex(int index) noexcept
@@ -27,6 +32,7 @@ namespace host::audio
             case 0: return ResamplerQuality::linear;
             case 1: return ResamplerQuality::catmullRom;
             case 3: return ResamplerQuality::windowedSinc;
+            case 4: return ResamplerQuality::polyphase;
             case 2:
             default: return ResamplerQuality::lagrange;
         }
@@ -41,17 +47,28 @@ namespace host::audio
         virtual ~IResamplerChannel() = default;
         virtual void prepare(double speedRatio, int bufferCapacity, int safetyMargin = 8) = 0;
         virtual void reset() noexcept = 0;
+        /// Audio thread: change the ratio between blocks without resetting.
+        virtual void setRatio(double speedRatio) noexcept = 0;
         virtual void push(const float* samples, int numSamples) = 0;
         virtual void pushSilence(int numSamples) = 0;
         [[nodiscard]] virtual bool canProcess(int numOutputSamples) const noexcept = 0;
         virtual int process(float* output, int numOutputSamples) noexcept = 0;
         [[nodiscard]] virtual int getStoredSamples() const noexcept = 0;
+        /// Pushes that found the FIFO full and dropped its oldest samples.
+        [[nodiscard]] virtual std::uint64_t getOverflowCount() const noexcept = 0;
+        /// process() calls that could not fill the whole request.
+        [[nodiscard]] virtual std::uint64_t getUnderflowCount() const noexcept = 0;
     };
 
     /// Concrete single-channel resampler built on a JUCE GenericInterpolator.
     /// The FIFO bookkeeping and realtime-safe overflow handling live here so
     /// every quality preset shares identical streaming semantics - only the
     /// interpolation kernel differs.
+    ///
+    /// The FIFO is a mirrored ring: every sample is written twice, at its
+    /// ring position and one capacity further on, so the stored samples are
+    /// always contiguous from the read position and the interpolator reads
+    /// them in place. Consuming or dropping samples only moves an index.
     template <typename Interpolator>
     class ResamplerChannel final : public IResamplerChannel
     {
@@ -60,33 +77,34 @@ namespace host::audio
         {
             ratio = speedRatio > 0.0 ? speedRatio : 1.0;
             margin = std::max(safetyMargin, 4);
-            buffer.resize(static_cast<size_t>(bufferCapacity));
-            stored = 0;
-            interpolator.reset();
+            capacity = std::max(bufferCapacity, 1);
+            buffer.assign(static_cast<size_t>(capacity) * 2, 0.0f);
+            reset();
         }
 
         void reset() noexcept override
         {
+            readPos = 0;
             stored = 0;
+            overflows.store(0, std::memory_order_relaxed);
+            underflows.store(0, std::memory_order_relaxed);
             interpolator.reset();
         }
 
-        void push(const float* samples, int numSamples) override
+        void setRatio(double speedRatio) noexcept override
         {
-            if (numSamples <= 0)
-                return;
+            if (speedRatio > 0.0)
+                ratio = speedRatio;
+        }
 
-            auto* dest = ensureSpace(numSamples);
-            std::memcpy(dest, samples, static_cast<size_t>(numSamples) * sizeof(float));
-            stored += numSamples;
+        void push(const float* samples, int numSamples) override
+        {
+            write(samples, numSamples);
         }
 
         void pushSilence(int numSamples) override
         {
-            if (numSamples <= 0)
-                return;
-            std::fill_n(ensureSpace(numSamples), static_cast<size_t>(numSamples), 0.0f);
-            stored += numSamples;
+            write(nullptr, numSamples);
         }
 
         [[nodiscard]] bool canProcess(int numOutputSamples) const noexcept override
@@ -107,6 +125,7 @@ namespace host::audio
             if (stored <= 0)
             {
                 std::fill_n(output, static_cast<size_t>(numOutputSamples), 0.0f);
+                countUnderflow();
                 return 0;
             }
 
@@ -125,70 +144,123 @@ namespace host::audio
             if (outputsToProduce <= 0)
             {
                 std::fill_n(output, static_cast<size_t>(numOutputSamples), 0.0f);
+                countUnderflow();
                 return 0;
             }
 
-            const int consumed = interpolator.process(ratio, buffer.data(), output, outputsToProduce);
+            const int consumed = interpolator.process(ratio, buffer.data() + readPos, output, outputsToProduce);
             consume(consumed);
 
             if (outputsToProduce < numOutputSamples)
+            {
                 std::fill(output + outputsToProduce, output + numOutputSamples, 0.0f);
+                countUnderflow();
+            }
 
             return outputsToProduce;
         }
 
         [[nodiscard]] int getStoredSamples() const noexcept override { return stored; }
+        [[nodiscard]] std::uint64_t getOverflowCount() const noexcept override { return overflows.load(std::memory_order_relaxed); }
+        [[nodiscard]] std::uint64_t getUnderflowCount() const noexcept override { return underflows.load(std::memory_order_relaxed); }
 
     private:
-        float* ensureSpace(int additional)
+        void write(const float* samples, int numSamples) noexcept
         {
-            // Realtime-safe: capacity is pre-allocated in prepare(). If a push
-            // would overflow, drop the oldest samples via memmove only - never
-            // reallocate from the audio thread.
-            const int capacity = static_cast<int>(buffer.size());
-            if (stored + additional > capacity)
+            if (numSamples <= 0 || buffer.empty())
+                return;
+
+            // Realtime-safe: capacity is pre-allocated in prepare(). A push
+            // that does not fit drops the oldest samples by advancing the read
+            // position - never reallocate from the audio thread.
+            if (numSamples > capacity)
             {
-                const int excess = (stored + additional) - capacity;
-                if (excess >= stored)
-                {
-                    stored = 0;
-                }
-                else
-                {
-                    std::memmove(buffer.data(),
-                                 buffer.data() + excess,
-                                 static_cast<size_t>(stored - excess) * sizeof(float));
-                    stored -= excess;
-                }
+                if (samples != nullptr)
+                    samples += numSamples - capacity;
+                numSamples = capacity;
             }
 
-            return buffer.data() + stored;
+            if (stored + numSamples > capacity)
+            {
+                consume(stored + numSamples - capacity);
+                overflows.store(overflows.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+
+            int writePos = readPos + stored;
+            if (writePos >= capacity)
+                writePos -= capacity;
+
+            // Up to two runs: to the end of the ring, then from its start.
+            const int firstRun = std::min(numSamples, capacity - writePos);
+            writeRun(writePos, samples, firstRun);
+            if (firstRun < numSamples)
+                writeRun(0, samples != nullptr ? samples + firstRun : nullptr, numSamples - firstRun);
+
+            stored += numSamples;
+        }
+
+        void writeRun(int position, const float* samples, int numSamples) noexcept
+        {
+            auto* primary = buffer.data() + position;
+            auto* mirror = primary + capacity;
+            if (samples != nullptr)
+            {
+                std::memcpy(primary, samples, static_cast<size_t>(numSamples) * sizeof(float));
+                std::memcpy(mirror, samples, static_cast<size_t>(numSamples) * sizeof(float));
+            }
+            else
+            {
+                std::fill_n(primary, static_cast<size_t>(numSamples), 0.0f);
+                std::fill_n(mirror, static_cast<size_t>(numSamples), 0.0f);
+            }
         }
 
-        void consume(int numSamples)
+        void consume(int numSamples) noexcept
         {
             if (numSamples <= 0)
                 return;
 
-            stored = std::max(0, stored - numSamples);
-            if (stored > 0)
-                std::memmove(buffer.data(), buffer.data() + numSamples, static_cast<size_t>(stored) * sizeof(float));
+            numSamples = std::min(numSamples, stored);
+            stored -= numSamples;
+            readPos += numSamples;
+            if (readPos >= capacity)
+                readPos -= capacity;
+        }
+
+        void countUnderflow() noexcept
+        {
+            underflows.store(underflows.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
         }
 
         double ratio { 1.0 };
         int margin { 8 };
-        std::vector<float> buffer;
+        int capacity { 0 };
+        std::vector<float> buffer; // 2 * capacity: ring plus its mirror
+        int readPos { 0 };
         int stored { 0 };
+        // Written by the audio thread only; atomics so the UI can poll them.
+        std::atomic<std::uint64_t> overflows { 0 };
+        std::atomic<std::uint64_t> underflows { 0 };
         Interpolator interpolator;
     };
 
     /// Factory: build a single-channel resampler for the requested quality.
     std::unique_ptr<IResamplerChannel> createResamplerChannel(ResamplerQuality quality);
 
-    /** Multi-channel wrapper around the single-channel resampler. */
+    /** Multi-channel wrapper around the single-channel resampler. The
+        polyphase quality is multi-channel by construction, so it bypasses the
+        per-channel objects and runs as one PolyphaseResampler. */
     class BlockResampler
     {
     public:
+        /// FIFO health since the last prepare()/reset(). Channels advance in
+        /// lockstep, so these are the worst counts of any channel.
+        struct FifoStats
+        {
+            std::uint64_t overflows { 0 };
+            std::uint64_t underflows { 0 };
+        };
+
         BlockResampler() = default;
 
         void prepare(int numChannels,
@@ -196,13 +268,25 @@ namespace host::audio
                      int maxInputChunk,
                      int maxOutputChunk,
                      ResamplerQuality quality,
-                     int safetyMargin = 8)
+                     int safetyMargin = 8,
+                     bool variableRatio = false)
         {
-            channels.resize(static_cast<size_t>(std::max(0, numChannels)));
             ratio = speedRatio > 0.0 ? speedRatio : 1.0;
             margin = std::max(safetyMargin, 4);
             maxInput = std::max(maxInputChunk, 1);
             maxOutput = std::max(maxOutputChunk, 1);
+
+            if (quality == ResamplerQuality::polyphase)
+            {
+                channels.clear();
+                discardBuffer.clear();
+                polyphase = std::make_unique<PolyphaseResampler>();
+                polyphase->prepare(numChannels, ratio, maxInput, maxOutput, variableRatio);
+                return;
+            }
+
+            polyphase.reset();
+            channels.resize(static_cast<size_t>(std::max(0, numChannels)));
             discardBuffer.resize(static_cast<size_t>(maxOutput));
 
             const int capacity = computeCapacity();
@@ -215,12 +299,44 @@ namespace host::audio
 
         void reset()
         {
+            if (polyphase != nullptr)
+                polyphase->reset();
+
             for (auto& ch : channels)
                 ch->reset();
         }
 
+        /// Audio thread: steer the ratio, e.g. for drift compensation. The
+        /// polyphase engine only follows when prepared with variableRatio.
+        void setRatio(double speedRatio) noexcept
+        {
+            if (speedRatio <= 0.0)
+                return;
+
+            ratio = speedRatio;
+            if (polyphase != nullptr)
+                polyphase->setRatio(speedRatio);
+
+            for (auto& ch : channels)
+                ch->setRatio(speedRatio);
+        }
+
+        /// Input samples waiting in the FIFO (channels advance in lockstep).
+        [[nodiscard]] int getStoredSamples() const noexcept
+        {
+            if (polyphase != nullptr)
+                return polyphase->getStoredSamples();
+            return channels.empty() ? 0 : channels.front()->getStoredSamples();
+        }
+
         void push(const float* const* inputs, int numSamples)
         {
+            if (polyphase != nullptr)
+            {
+                polyphase->push(inputs, numSamples);
+                return;
+            }
+
             if (channels.empty() || numSamples <= 0)
                 return;
 
@@ -236,6 +352,9 @@ namespace host::audio
 
         [[nodiscard]] bool canProcess(int numOutputSamples) const
         {
+            if (polyphase != nullptr)
+                return polyphase->canProcess(numOutputSamples);
+
             if (channels.empty())
                 return false;
 
@@ -249,6 +368,9 @@ namespace host::audio
 
         int process(float* const* outputs, int numOutputSamples)
         {
+            if (polyphase != nullptr)
+                return polyphase->process(outputs, numOutputSamples);
+
             if (channels.empty() || outputs == nullptr)
                 return 0;
 
@@ -266,7 +388,36 @@ namespace host::audio
             return produced;
         }
 
-        [[nodiscard]] int getNumChannels() const noexcept { return static_cast<int>(channels.size()); }
+        [[nodiscard]] int getNumChannels() const noexcept
+        {
+            return polyphase != nullptr ? polyphase->getNumChannels() : static_cast<int>(channels.size());
+        }
+
+        /// Input samples held back ahead of the sample being output: the
+        /// FIR half-length for the polyphase engine, the safety margin for the
+        /// JUCE interpolators.
+        [[nodiscard]] int getLookaheadSamples() const noexcept
+        {
+            return polyphase != nullptr ? polyphase->getLookaheadSamples() : margin;
+        }
+
+        /// Safe to call from any thread while the audio thread streams.
+        [[nodiscard]] FifoStats getFifoStats() const noexcept
+        {
+            FifoStats stats;
+            if (polyphase != nullptr)
+            {
+                stats.overflows = polyphase->getOverflowCount();
+                stats.underflows = polyphase->getUnderflowCount();
+            }
+
+            for (const auto& ch : channels)
+            {
+                stats.overflows = std::max(stats.overflows, ch->getOverflowCount());
+                stats.underflows = std::max(stats.underflows, ch->getUnderflowCount());
+            }
+            return stats;
+        }
 
     private:
         [[nodiscard]] int computeCapacity() const
@@ -277,6 +428,7 @@ namespace host::audio
         }
 
         std::vector<std::unique_ptr<IResamplerChannel>> channels;
+        std::unique_ptr<PolyphaseResampler> polyphase;
         double ratio { 1.0 };
         int margin { 8 };
         int maxInput { 0 };
@@ -0,0 +1,556 @@
+// Microbenchmarks for the built-in nodes, the device-engine resampler and the
+// graph runtime. Results go to stdout (or --output) as JSON or CSV so CI can
+// compare them against a stored baseline; progress goes to stderr.
+//
+//   VSTHostBench [--filter text] [--time seconds] [--format json|csv] [--output file] [--quick]
+//
+// Option values follow the option or are joined to it with '=' (--time=2).
+// Only Release builds give meaningful numbers.
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "audio/Resampler.h"
+#include "bench/BenchRunner.h"
+#include "graph/GraphEngine.h"
+#include "graph/NodeFactory.h"
+#include "graph/Nodes/ConvolutionReverbNode.h"
+#include "util/CommandLineOptions.h"
+
+namespace
+{
+    using host::bench::BenchResult;
+    using host::bench::BenchRunner;
+    using host::graph::GraphEngine;
+    using host::graph::Node;
+
+    constexpr double kSampleRate = 48000.0;
+    constexpr float kSignalLevel = 0.25f;
+
+    /// Which configurations each suite sweeps. --quick keeps one point per
+    /// axis for a fast smoke run.
+    struct Matrix
+    {
+        std::vector<int> blockSizes;
+        std::vector<int> channelCounts;
+        std::vector<int> chainLengths;
+        std::vector<int> fanWidths;
+        std::vector<int> workerCounts;
+    };
+
+    [[nodiscard]] Matrix makeMatrix(bool quick)
+    {
+        const int workers = std::clamp(static_cast<int>(std::thread::hardware_concurrency()) - 1, 1, 4);
+        if (quick)
+            return { { 256 }, { 2 }, { 8 }, { 8 }, { 0 } };
+        return { { 32, 128, 512, 2048 }, { 1, 2, 8 }, { 1, 8, 32 }, { 4, 16, 64 }, { 0, workers } };
+    }
+
+    void fillNoise(juce::AudioBuffer<float>& buffer)
+    {
+        juce::Random random(1234);
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            auto* data = buffer.getWritePointer(ch);
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                data[i] = (random.nextFloat() * 2.0f - 1.0f) * kSignalLevel;
+        }
+    }
+
+    void setParameter(Node& node, const std::string& id, double value)
+    {
+        auto params = node.getParameters();
+        for (auto& p : params)
+        {
+            if (p.id == id)
+                p.value = value;
+        }
+        node.setParameters(params);
+    }
+
+    /// Sets each node up so its real DSP path runs: EQ bands boosted and cut
+    /// (flat bands skip the filter maths), the compressor well into gain
+    /// reduction, and so on.
+    void configureForWork(Node& node)
+    {
+        const auto type = node.typeId();
+        if (type == "Equalizer" || type == "LinearPhaseEQ")
+        {
+            auto params = node.getParameters();
+            bool boost = true;
+            for (auto& p : params)
+            {
+                if (p.id.size() > 5 && p.id.compare(p.id.size() - 5, 5, "_gain") == 0)
+                {
+                    p.value = boost ? 4.0 : -4.0;
+                    boost = ! boost;
+                }
+            }
+            node.setParameters(params);
+        }
+        else if (type == "Compressor")
+        {
+            setParameter(node, "threshold", -30.0);
+        }
+        else if (type == "Gain")
+        {
+            setParameter(node, "gain", 0.8);
+        }
+        else if (auto* reverb = dynamic_cast<host::graph::nodes::ConvolutionReverbNode*>(&node))
+        {
+            // A generated IR keeps the bench free of files; 2 s is long
+            // enough that the tail worker does most of the work. The bench
+            // runs faster than real time, so wait for every tail job like an
+            // offline render instead of dropping the late ones.
+            reverb->setNonRealtime(true);
+            std::vector<std::vector<float>> impulse(2, std::vector<float>(static_cast<size_t>(2.0 * kSampleRate)));
+            juce::Random random(5678);
+            for (auto& channel : impulse)
+            {
+                for (size_t i = 0; i < channel.size(); ++i)
+                    channel[i] = (random.nextFloat() * 2.0f - 1.0f)
+                               * std::exp(-3.0f * static_cast<float>(i) / static_cast<float>(channel.size()));
+            }
+            reverb->setImpulseResponse(std::move(impulse), kSampleRate);
+        }
+    }
+
+    [[nodiscard]] std::unique_ptr<Node> createNode(const std::string& typeId)
+    {
+        auto node = host::graph::NodeFactory::create(typeId);
+        if (node != nullptr)
+            configureForWork(*node);
+        return node;
+    }
+
+    /// Fixed delay that reports its length as latency, so graphs built from
+    /// it exercise plug-in delay compensation without hosting a plug-in.
+    class LatencyNode final : public Node
+    {
+    public:
+        explicit LatencyNode(int latencyIn) : latency(std::max(1, latencyIn)) {}
+
+        void prepare(double, int) override
+        {
+            for (auto& line : lines)
+                line.assign(static_cast<size_t>(latency), 0.0f);
+            writePos = 0;
+        }
+
+        void process(host::graph::ProcessContext& context) override
+        {
+            const int frames = std::max(0, context.numFrames);
+            const int channels = std::min(std::max(0, context.numOutputChannels), kMaxChannels);
+            const int inputs = std::max(0, context.numInputChannels);
+            int pos = writePos;
+            for (int ch = 0; ch < channels; ++ch)
+            {
+                const float* src = inputs > 0 ? context.inputChannels[ch % inputs] : nullptr;
+                float* dest = context.outputChannels[ch];
+                auto& line = lines[static_cast<size_t>(ch)];
+                pos = writePos;
+                for (int i = 0; i < frames; ++i)
+                {
+                    const float in = src != nullptr ? src[i] : 0.0f;
+                    dest[i] = line[static_cast<size_t>(pos)];
+                    line[static_cast<size_t>(pos)] = in;
+                    if (++pos == latency)
+                        pos = 0;
+                }
+            }
+            writePos = pos;
+        }
+
+        int latencySamples() const override { return latency; }
+        int tailSamples() const override { return latency; }
+        std::string name() const override { return "Latency"; }
+
+    private:
+        static constexpr int kMaxChannels = 8;
+
+        int latency;
+        int writePos { 0 };
+        std::array<std::vector<float>, kMaxChannels> lines;
+    };
+
+    [[nodiscard]] juce::String caseId(const std::string& suite, const juce::String& name, int blockSize, int channels)
+    {
+        return juce::String(suite) + "/" + name + "/b" + juce::String(blockSize) + "/c" + juce::String(channels);
+    }
+
+    // ---------------------------------------------------------------- nodes
+
+    void benchNodes(BenchRunner& runner, const Matrix& matrix)
+    {
+        const std::vector<std::string> types { "Gain", "Equalizer", "LinearPhaseEQ", "Compressor", "Reverb", "ConvolutionReverb",
+                                               "Delay", "Mix", "Merge", "Split", "ChannelTap" };
+
+        for (const auto& type : types)
+        {
+            for (const int blockSize : matrix.blockSizes)
+            {
+                for (const int channels : matrix.channelCounts)
+                {
+                    const auto id = caseId("node", type, blockSize, channels);
+                    if (! runner.wants(id))
+                        continue;
+
+                    auto node = createNode(type);
+                    if (node == nullptr)
+                        continue;
+                    node->prepare(kSampleRate, blockSize);
+
+                    // Out of place, like most nodes in a graph that fans out.
+                    juce::AudioBuffer<float> input(channels, blockSize);
+                    juce::AudioBuffer<float> output(channels, blockSize);
+                    fillNoise(input);
+
+                    host::graph::ProcessContext context { output };
+                    context.inputChannels = const_cast<float**>(input.getArrayOfWritePointers());
+                    context.outputChannels = const_cast<float**>(output.getArrayOfWritePointers());
+                    context.numInputChannels = channels;
+                    context.numOutputChannels = channels;
+                    context.sampleRate = kSampleRate;
+                    context.blockSize = blockSize;
+                    context.numFrames = blockSize;
+
+                    BenchResult result;
+                    result.suite = "node";
+                    result.id = id.toStdString();
+                    result.blockSize = blockSize;
+                    result.channels = channels;
+                    result.params = { { "node", juce::var(juce::String(type)) } };
+
+                    runner.run(std::move(result), blockSize, [&]
+                    {
+                        context.outputSilent = false;
+                        node->process(context);
+                    });
+                }
+            }
+        }
+    }
+
+    // ------------------------------------------------------------ resampler
+
+    struct RatioCase
+    {
+        const char* name;
+        double inputRate;
+        double outputRate;
+    };
+
+    void benchResampler(BenchRunner& runner, const Matrix& matrix)
+    {
+        using host::audio::ResamplerQuality;
+
+        const std::vector<std::pair<const char*, ResamplerQuality>> qualities {
+            { "linear", ResamplerQuality::linear },
+            { "catmullRom", ResamplerQuality::catmullRom },
+            { "lagrange", ResamplerQuality::lagrange },
+            { "windowedSinc", ResamplerQuality::windowedSinc },
+            { "polyphase", ResamplerQuality::polyphase },
+        };
+        const std::vector<RatioCase> ratios {
+            { "44k1-48k", 44100.0, 48000.0 },
+            { "48k-44k1", 48000.0, 44100.0 },
+            { "48k-96k", 48000.0, 96000.0 },
+            { "96k-48k", 96000.0, 48000.0 },
+            { "48k-48k", 48000.0, 48000.0 },
+        };
+
+        for (const auto& [qualityName, quality] : qualities)
+        {
+            for (const auto& ratioCase : ratios)
+            {
+                for (const int blockSize : matrix.blockSizes)
+                {
+                    for (const int channels : matrix.channelCounts)
+                    {
+                        const auto name = juce::String(qualityName) + "/" + ratioCase.name;
+                        const auto id = caseId("resampler", name, blockSize, channels);
+                        if (! runner.wants(id))
+                            continue;
+
+                        // Input samples consumed per output sample, as DeviceEngine
+                        // prepares it (source rate / destination rate).
+                        const double ratio = ratioCase.inputRate / ratioCase.outputRate;
+                        const int maxInput = static_cast<int>(std::ceil(blockSize * ratio)) + 2;
+
+                        host::audio::BlockResampler resampler;
+                        resampler.prepare(channels, ratio, maxInput, blockSize, quality);
+                        resampler.reset();
+
+                        juce::AudioBuffer<float> input(channels, maxInput);
+                        juce::AudioBuffer<float> output(channels, blockSize);
+                        fillNoise(input);
+
+                        // Prime past the lookahead so every call produces a
+                        // full block; afterwards push exactly what is consumed.
+                        resampler.push(input.getArrayOfReadPointers(), std::min(maxInput, resampler.getLookaheadSamples() + 4));
+                        double pending = 0.0;
+
+                        BenchResult result;
+                        result.suite = "resampler";
+                        result.id = id.toStdString();
+                        result.blockSize = blockSize;
+                        result.channels = channels;
+                        result.params = { { "quality", juce::var(juce::String(qualityName)) },
+                                          { "ratio", juce::var(ratio) } };
+
+                        runner.run(std::move(result), blockSize, [&]
+                        {
+                            pending += blockSize * ratio;
+                            const int toPush = std::min(maxInput, static_cast<int>(pending));
+                            pending -= toPush;
+                            resampler.push(input.getArrayOfReadPointers(), toPush);
+                            if (resampler.canProcess(blockSize))
+                                juce::ignoreUnused(resampler.process(output.getArrayOfWritePointers(), blockSize));
+                        });
+                    }
+                }
+            }
+        }
+    }
+
+    // ---------------------------------------------------------------- graph
+
+    /// Adds In -> ... -> Out around the body the builder returns, then
+    /// prepares the graph at the given format.
+    template <typename BuildBody>
+    std::unique_ptr<GraphEngine> makeGraph(int blockSize, int channels, int workers, BuildBody&& buildBody)
+    {
+        auto graph = std::make_unique<GraphEngine>();
+        const auto in = graph->addNode(host::graph::NodeFactory::create("AudioIn"));
+        const auto out = graph->addNode(host::graph::NodeFactory::create("AudioOut"));
+        buildBody(*graph, in, out);
+        graph->setIO(in, out);
+        graph->setBusChannels(channels);
+        graph->setEngineFormat(kSampleRate, blockSize);
+        graph->setWorkerCount(workers);
+        graph->prepare();
+        return graph;
+    }
+
+    void runGraphCase(BenchRunner& runner, BenchResult result, GraphEngine& graph)
+    {
+        juce::AudioBuffer<float> source(result.channels, result.blockSize);
+        juce::AudioBuffer<float> buffer(result.channels, result.blockSize);
+        fillNoise(source);
+
+        const int blockSize = result.blockSize;
+        runner.run(std::move(result), blockSize, [&]
+        {
+            // process() renders in place, so restore the input each call.
+            // The copy is a few hundred bytes against a whole graph pass.
+            for (int ch = 0; ch < source.getNumChannels(); ++ch)
+                buffer.copyFrom(ch, 0, source, ch, 0, blockSize);
+            juce::ignoreUnused(graph.process(buffer));
+        });
+    }
+
+    void benchGraph(BenchRunner& runner, const Matrix& matrix)
+    {
+        // Gain nodes keep the DSP cheap so the numbers are dominated by the
+        // runtime itself: scheduling, buffer routing, summing and PDC.
+        for (const int blockSize : matrix.blockSizes)
+        {
+            for (const int channels : matrix.channelCounts)
+            {
+                for (const int length : matrix.chainLengths)
+                {
+                    const auto id = caseId("graph", "serial" + juce::String(length), blockSize, channels);
+                    if (! runner.wants(id))
+                        continue;
+
+                    auto graph = makeGraph(blockSize, channels, 0, [length](GraphEngine& g, auto in, auto out)
+                    {
+                        auto previous = in;
+                        for (int i = 0; i < length; ++i)
+                        {
+                            const auto node = g.addNode(createNode("Gain"));
+                            g.connect(previous, node);
+                            previous = node;
+                        }
+                        g.connect(previous, out);
+                    });
+
+                    BenchResult result { "graph", id.toStdString(), blockSize, channels,
+                                         { { "topology", "serial" }, { "nodes", length } } };
+                    runGraphCase(runner, std::move(result), *graph);
+                }
+
+                for (const int width : matrix.fanWidths)
+                {
+                    for (const int workers : matrix.workerCounts)
+                    {
+                        const auto id = caseId("graph", "fan" + juce::String(width) + "/w" + juce::String(workers),
+                                               blockSize, channels);
+                        if (! runner.wants(id))
+                            continue;
+
+                        auto graph = makeGraph(blockSize, channels, workers, [width](GraphEngine& g, auto in, auto out)
+                        {
+                            const auto mix = g.addNode(createNode("Mix"));
+                            for (int i = 0; i < width; ++i)
+                            {
+                                const auto node = g.addNode(createNode("Gain"));
+                                g.connect(in, node);
+                                g.connect(node, mix);
+                            }
+                            g.connect(mix, out);
+                        });
+
+                        BenchResult result { "graph", id.toStdString(), blockSize, channels,
+                                             { { "topology", "fan" }, { "nodes", width }, { "workers", workers } } };
+                        runGraphCase(runner, std::move(result), *graph);
+                    }
+                }
+
+                // Branches of unequal latency joined at one mix, so delay
+                // compensation has to pad every branch but the slowest.
+                for (const int width : matrix.fanWidths)
+                {
+                    constexpr int kDepth = 4;
+                    const auto id = caseId("graph", "pdc" + juce::String(width) + "x" + juce::String(kDepth),
+                                           blockSize, channels);
+                    if (! runner.wants(id))
+                        continue;
+
+                    auto graph = makeGraph(blockSize, channels, 0, [width](GraphEngine& g, auto in, auto out)
+                    {
+                        const auto mix = g.addNode(createNode("Mix"));
+                        for (int branch = 0; branch < width; ++branch)
+                        {
+                            auto previous = in;
+                            for (int i = 0; i < kDepth; ++i)
+                            {
+                                const auto node = g.addNode(std::make_unique<LatencyNode>((branch + 1) * (i + 1) * 8));
+                                g.connect(previous, node);
+                                previous = node;
+                            }
+                            g.connect(previous, mix);
+                        }
+                        g.connect(mix, out);
+                    });
+
+                    BenchResult result { "graph", id.toStdString(), blockSize, channels,
+                                         { { "topology", "pdc" }, { "nodes", width * kDepth } } };
+                    runGraphCase(runner, std::move(result), *graph);
+                }
+            }
+        }
+    }
+
+    // --------------------------------------------------------------- output
+
+    [[nodiscard]] juce::String toJson(const std::vector<BenchResult>& results)
+    {
+        auto* machine = new juce::DynamicObject();
+        machine->setProperty("cpu", juce::SystemStats::getCpuModel());
+        machine->setProperty("cores", juce::SystemStats::getNumCpus());
+        machine->setProperty("os", juce::SystemStats::getOperatingSystemName());
+        machine->setProperty("juce", juce::SystemStats::getJUCEVersion());
+       #if defined(NDEBUG)
+        machine->setProperty("build", "release");
+       #else
+        machine->setProperty("build", "debug");
+       #endif
+
+        juce::Array<juce::var> cases;
+        for (const auto& r : results)
+        {
+            auto* item = new juce::DynamicObject();
+            item->setProperty("suite", juce::String(r.suite));
+            item->setProperty("id", juce::String(r.id));
+            item->setProperty("blockSize", r.blockSize);
+            item->setProperty("channels", r.channels);
+            for (const auto& [key, value] : r.params)
+                item->setProperty(juce::Identifier(key), value);
+            item->setProperty("nsPerSample", r.nsPerSample);
+            item->setProperty("nsPerSampleMin", r.nsPerSampleMin);
+            item->setProperty("samplesPerSecond", r.samplesPerSecond);
+            item->setProperty("samplesMeasured", static_cast<juce::int64>(r.samplesMeasured));
+            cases.add(juce::var(item));
+        }
+
+        auto* root = new juce::DynamicObject();
+        root->setProperty("machine", juce::var(machine));
+        root->setProperty("results", cases);
+        return juce::JSON::toString(juce::var(root));
+    }
+
+    [[nodiscard]] juce::String toCsv(const std::vector<BenchResult>& results)
+    {
+        juce::String csv = "suite,id,blockSize,channels,params,nsPerSample,nsPerSampleMin,samplesPerSecond\n";
+        for (const auto& r : results)
+        {
+            juce::StringArray params;
+            for (const auto& [key, value] : r.params)
+                params.add(juce::String(key) + "=" + value.toString());
+
+            csv << r.suite << "," << r.id << "," << r.blockSize << "," << r.channels << ","
+                << params.joinIntoString(";") << "," << juce::String(r.nsPerSample, 4) << ","
+                << juce::String(r.nsPerSampleMin, 4) << "," << juce::String(r.samplesPerSecond, 0) << "\n";
+        }
+        return csv;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const juce::ArgumentList args(argc, argv);
+    if (args.containsOption("--help|-h"))
+    {
+        std::cout << "Usage: VSTHostBench [--filter text] [--time seconds] [--format json|csv]\n"
+                     "                    [--output file] [--quick]\n"
+                     "Values follow the option (--time 2) or are joined to it with '=' (--time=2).\n";
+        return 0;
+    }
+
+    host::util::CommandLineOptions cmd(args);
+    host::bench::BenchOptions options;
+    options.filter = cmd.text("--filter");
+    options.secondsPerCase = cmd.number("--time", options.secondsPerCase, 0.01, 3600.0);
+    const bool csv = cmd.choice("--format", { "json", "csv" }, "json") == "csv";
+    const auto outputPath = cmd.text("--output");
+    if (! cmd.ok())
+    {
+        for (const auto& error : cmd.getErrors())
+            std::cerr << error << std::endl;
+        return 1;
+    }
+
+    const auto matrix = makeMatrix(cmd.has("--quick"));
+
+    BenchRunner runner(options);
+    benchNodes(runner, matrix);
+    benchResampler(runner, matrix);
+    benchGraph(runner, matrix);
+
+    const auto report = csv ? toCsv(runner.getResults()) : toJson(runner.getResults());
+
+    if (outputPath.isNotEmpty())
+    {
+        const auto file = juce::File::getCurrentWorkingDirectory().getChildFile(outputPath);
+        if (! file.replaceWithText(report))
+        {
+            std::cerr << "Cannot write " << file.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        std::cout << report << std::endl;
+    }
+    return 0;
+}
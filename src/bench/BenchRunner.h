@@ -0,0 +1,103 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace host::bench
+{
+    struct BenchOptions
+    {
+        double secondsPerCase { 0.3 }; ///< Measured time per case, warm-up excluded
+        int batches { 7 };             ///< The case time is split into this many timed batches
+        juce::String filter;           ///< Only cases whose id contains this text
+    };
+
+    /// One measured case. Throughput is counted in sample frames (one sample
+    /// on every channel), the unit the device callback deadline is set in;
+    /// divide by channels for per-channel figures.
+    struct BenchResult
+    {
+        std::string suite;
+        std::string id;
+        int blockSize { 0 };
+        int channels { 0 };
+        std::vector<std::pair<std::string, juce::var>> params;
+        double nsPerSample { 0.0 };    ///< Median over batches
+        double nsPerSampleMin { 0.0 }; ///< Fastest batch, the least noisy figure
+        double samplesPerSecond { 0.0 };
+        std::int64_t samplesMeasured { 0 };
+    };
+
+    /// Times a callable that renders a fixed number of sample frames per
+    /// call. Warms it up first, sizes the batches from the warm-up speed,
+    /// then reports the median and the fastest batch so a noisy neighbour
+    /// shifts the median without hiding the best case.
+    class BenchRunner
+    {
+    public:
+        explicit BenchRunner(BenchOptions optionsIn) : options(std::move(optionsIn)) {}
+
+        [[nodiscard]] bool wants(const juce::String& id) const
+        {
+            return options.filter.isEmpty() || id.containsIgnoreCase(options.filter);
+        }
+
+        template <typename Body>
+        void run(BenchResult result, int samplesPerCall, Body&& body)
+        {
+            using Clock = std::chrono::steady_clock;
+
+            const auto warmUpEnd = Clock::now() + std::chrono::milliseconds(kWarmUpMs);
+            std::int64_t warmUpCalls = 0;
+            const auto warmUpStart = Clock::now();
+            while (warmUpCalls < kMinWarmUpCalls || Clock::now() < warmUpEnd)
+            {
+                body();
+                ++warmUpCalls;
+            }
+            const double nsPerCall = std::chrono::duration<double, std::nano>(Clock::now() - warmUpStart).count()
+                                     / static_cast<double>(warmUpCalls);
+
+            const int batches = std::max(1, options.batches);
+            const double batchNs = options.secondsPerCase * 1.0e9 / batches;
+            const auto callsPerBatch = std::max<std::int64_t>(1, static_cast<std::int64_t>(batchNs / std::max(1.0, nsPerCall)));
+
+            std::vector<double> nsPerSample;
+            nsPerSample.reserve(static_cast<size_t>(batches));
+            for (int batch = 0; batch < batches; ++batch)
+            {
+                const auto start = Clock::now();
+                for (std::int64_t call = 0; call < callsPerBatch; ++call)
+                    body();
+                const double elapsedNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+                nsPerSample.push_back(elapsedNs / static_cast<double>(callsPerBatch * samplesPerCall));
+            }
+
+            std::sort(nsPerSample.begin(), nsPerSample.end());
+            result.nsPerSample = nsPerSample[nsPerSample.size() / 2];
+            result.nsPerSampleMin = nsPerSample.front();
+            result.samplesPerSecond = result.nsPerSample > 0.0 ? 1.0e9 / result.nsPerSample : 0.0;
+            result.samplesMeasured = callsPerBatch * batches * samplesPerCall;
+
+            std::cerr << juce::String(result.id).paddedRight(' ', 48) << juce::String(result.nsPerSample, 2).paddedLeft(' ', 10)
+                      << " ns/sample" << std::endl;
+            results.push_back(std::move(result));
+        }
+
+        [[nodiscard]] const std::vector<BenchResult>& getResults() const noexcept { return results; }
+
+    private:
+        static constexpr int kWarmUpMs = 30;
+        static constexpr std::int64_t kMinWarmUpCalls = 8;
+
+        BenchOptions options;
+        std::vector<BenchResult> results;
+    };
+}
@@ -0,0 +1,358 @@
+// Headless host: loads a project and renders it offline or against a null
+// audio device, then prints throughput and per-node timings. Meant for
+// render boxes and CI, where there is neither a display nor a sound card.
+//
+//   VSTHostCli project.json [--output out.wav] [--input in.wav | --signal sine] ...
+//   VSTHostCli project.json --device 30 [--free-run] [--pipeline 1] ...
+//
+// Run with --help for every option.
+
+#include <juce_audio_devices/juce_audio_devices.h>
+#include <juce_events/juce_events.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+#include "audio/DeviceEngine.h"
+#include "audio/OfflineRenderer.h"
+#include "cli/NullAudioDevice.h"
+#include "graph/GraphEngine.h"
+#include "graph/RealtimeChecker.h"
+#include "host/PluginScanner.h"
+#include "persist/Project.h"
+#include "persist/ProjectGraphBuilder.h"
+#include "util/CommandLineOptions.h"
+
+namespace
+{
+    using host::graph::GraphEngine;
+    using host::util::CommandLineOptions;
+
+    constexpr const char* kUsage =
+        "Usage: VSTHostCli <project.json> [options]\n"
+        "\n"
+        "Option values follow the option (--block 256) or are joined to it with\n"
+        "'=' (--block=256).\n"
+        "\n"
+        "Offline render (default):\n"
+        "  --input <file>          Audio file fed to the graph input\n"
+        "  --signal <name>         Generated input when --input is absent:\n"
+        "                          sine (default), noise, impulse, sweep, silence\n"
+        "  --seconds <s>           Length of the generated input (default 10)\n"
+        "  --frequency <hz>        Sine frequency (default 1000)\n"
+        "  --output <file>         .wav or .flac; omit to render without writing\n"
+        "  --bits <n>              Output bit depth (default 24)\n"
+        "  --tail <s>              Render this long past the input (default 2)\n"
+        "  --keep-latency          Do not trim the graph latency from the output\n"
+        "\n"
+        "Null audio device:\n"
+        "  --device <s>            Run the live engine path for this many seconds\n"
+        "  --free-run              Call back as fast as possible, not in real time\n"
+        "  --pipeline <n>          Engine pipeline depth in blocks (default 0)\n"
+        "  --device-rate <hz>      Device sample rate (default: the engine rate)\n"
+        "  --device-block <n>      Device buffer size (default: the engine block)\n"
+        "  --quality <0-4>         Resampler quality when the rates differ (default 2)\n"
+        "\n"
+        "Common:\n"
+        "  --rate <hz>             Engine sample rate (default: input file, or 48000)\n"
+        "  --block <n>             Engine block size (default 512)\n"
+        "  --channels <n>          Bus channels (default 2)\n"
+        "  --workers <n>           Graph worker threads (default 0)\n"
+        "  --plugin-cache <file>   Plug-in scan cache used to locate project plug-ins\n"
+        "                          (default: the app's cache)\n"
+        "  --json                  Print the report as JSON\n";
+
+    struct Report
+    {
+        juce::String mode;
+        double sampleRate { 0.0 };
+        int blockSize { 0 };
+        double audioSeconds { 0.0 };
+        double wallSeconds { 0.0 };
+        double realtimeFactor { 0.0 };
+        int latencySamples { 0 };
+        juce::var extra; // Mode-specific figures
+        std::vector<GraphEngine::NodeTiming> timings;
+    };
+
+    [[nodiscard]] host::audio::TestSignal parseSignal(const juce::String& name)
+    {
+        if (name == "noise")
+            return host::audio::TestSignal::whiteNoise;
+        if (name == "impulse")
+            return host::audio::TestSignal::impulse;
+        if (name == "sweep")
+            return host::audio::TestSignal::sweep;
+        if (name == "silence")
+            return host::audio::TestSignal::silence;
+        return host::audio::TestSignal::sine;
+    }
+
+    [[nodiscard]] juce::File resolveFile(const juce::String& path)
+    {
+        return juce::File::getCurrentWorkingDirectory().getChildFile(path);
+    }
+
+    [[nodiscard]] juce::String nodeName(const GraphEngine& graph, const GraphEngine::NodeId& id)
+    {
+        if (auto node = graph.getNode(id))
+            return juce::String(node->name());
+        return id.toString();
+    }
+
+    bool buildGraph(const juce::File& projectFile, const juce::File& pluginCache, GraphEngine& graph)
+    {
+        host::persist::Project project;
+        if (! project.load(projectFile))
+        {
+            std::cerr << "Cannot load project " << projectFile.getFullPathName() << std::endl;
+            return false;
+        }
+
+        host::plugin::PluginScanner scanner;
+        if (pluginCache.existsAsFile())
+            scanner.loadCache(pluginCache);
+
+        host::persist::ProjectGraphBuilder builder(&scanner);
+        builder.instantiate(project);
+        for (const auto& missing : builder.getMissingPlugins())
+            std::cerr << "Missing plug-in " << missing << std::endl;
+
+        graph.clear();
+        builder.populate(graph);
+        return true;
+    }
+
+    /// Prints what did not parse; true when everything did.
+    bool checkOptions(const CommandLineOptions& cmd)
+    {
+        for (const auto& error : cmd.getErrors())
+            std::cerr << error << std::endl;
+        return cmd.ok();
+    }
+
+    [[nodiscard]] int runOffline(CommandLineOptions& cmd, std::shared_ptr<GraphEngine> graph, Report& report)
+    {
+        host::audio::OfflineRenderOptions options;
+        if (cmd.has("--input"))
+            options.inputFile = resolveFile(cmd.text("--input"));
+        options.signal = parseSignal(cmd.choice("--signal", { "sine", "noise", "impulse", "sweep", "silence" }, "sine"));
+        options.signalSeconds = cmd.number("--seconds", 10.0, 0.0, 24.0 * 3600.0);
+        options.signalFrequencyHz = cmd.number("--frequency", 1000.0, 0.0, 1.0e6);
+        if (cmd.has("--output"))
+            options.outputFile = resolveFile(cmd.text("--output"));
+        options.bitsPerSample = cmd.integer("--bits", 24, 8, 32);
+        options.sampleRate = cmd.number("--rate", 0.0, 1000.0, 1.0e6);
+        options.blockSize = cmd.integer("--block", 512, 1, 65536);
+        options.numChannels = cmd.integer("--channels", 2, 1, 64);
+        options.workerThreads = cmd.integer("--workers", 0, 0, 64);
+        options.tailSeconds = cmd.number("--tail", 2.0, 0.0, 3600.0);
+        options.trimLatency = ! cmd.has("--keep-latency");
+        if (! checkOptions(cmd))
+            return 1;
+
+        host::audio::OfflineRenderer renderer(graph);
+        const auto result = renderer.render(options);
+        if (! result.succeeded)
+        {
+            std::cerr << result.error << std::endl;
+            return 1;
+        }
+
+        report.mode = "offline";
+        report.sampleRate = result.sampleRate;
+        report.blockSize = options.blockSize;
+        report.audioSeconds = static_cast<double>(result.samplesRendered) / result.sampleRate;
+        report.wallSeconds = result.wallSeconds;
+        report.realtimeFactor = result.realtimeFactor;
+        report.latencySamples = result.latencySamples;
+
+        auto* extra = new juce::DynamicObject();
+        extra->setProperty("samplesWritten", result.samplesWritten);
+        if (options.outputFile != juce::File())
+            extra->setProperty("output", options.outputFile.getFullPathName());
+        report.extra = juce::var(extra);
+        return 0;
+    }
+
+    [[nodiscard]] int runDevice(CommandLineOptions& cmd, std::shared_ptr<GraphEngine> graph, Report& report)
+    {
+        host::audio::EngineConfig config;
+        config.sampleRate = cmd.number("--rate", 48000.0, 1000.0, 1.0e6);
+        config.blockSize = cmd.integer("--block", 512, 1, 65536);
+        config.workerThreads = cmd.integer("--workers", 0, 0, 64);
+        config.pipelineDepth = cmd.integer("--pipeline", 0, 0, 16);
+        config.resamplerQuality = cmd.integer("--quality", 2, 0, 4);
+
+        const double deviceRate = cmd.number("--device-rate", config.sampleRate, 1000.0, 1.0e6);
+        const int deviceBlock = cmd.integer("--device-block", config.blockSize, 1, 65536);
+        const int numChannels = cmd.integer("--channels", 2, 1, 64);
+        const double seconds = cmd.number("--device", 0.0, 0.1, 24.0 * 3600.0);
+        const bool freeRunning = cmd.has("--free-run");
+        if (! checkOptions(cmd))
+            return 1;
+
+        host::audio::DeviceEngine engine;
+        engine.setEngineConfig(config);
+        engine.setGraph(graph);
+
+        host::cli::NullAudioDevice device(deviceRate, deviceBlock, numChannels, freeRunning);
+        juce::BigInteger channels;
+        channels.setRange(0, numChannels, true);
+        device.open(channels, channels, deviceRate, deviceBlock);
+
+        const auto started = std::chrono::steady_clock::now();
+        device.start(&engine);
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+        device.stop();
+        const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+        const auto callbacks = device.getCallbackCount();
+        const auto deadline = engine.getDeadlineStats();
+        const auto load = engine.getCallbackLoad();
+        const auto pipeline = engine.getPipelineStats();
+
+        report.mode = freeRunning ? "device-free-run" : "device";
+        report.sampleRate = deviceRate;
+        report.blockSize = deviceBlock;
+        report.audioSeconds = static_cast<double>(callbacks) * deviceBlock / deviceRate;
+        report.wallSeconds = elapsed;
+        report.realtimeFactor = elapsed > 0.0 ? report.audioSeconds / elapsed : 0.0;
+        report.latencySamples = engine.getLatencyReport().totalSamples;
+
+        auto* extra = new juce::DynamicObject();
+        extra->setProperty("callbacks", static_cast<juce::int64>(callbacks));
+        extra->setProperty("droppedPeriods", static_cast<juce::int64>(device.getDroppedPeriods()));
+        extra->setProperty("loadPercent", load.loadPercent);
+        extra->setProperty("overruns", static_cast<juce::int64>(deadline.overruns));
+        extra->setProperty("lateCallbacks", static_cast<juce::int64>(deadline.lateCallbacks));
+        extra->setProperty("meanCallbackUs", deadline.meanDurationUs);
+        extra->setProperty("worstCallbackUs", deadline.worstDurationUs);
+        extra->setProperty("deadlineUs", deadline.deadlineUs);
+        extra->setProperty("worstJitterUs", deadline.worstJitterUs);
+        if (config.pipelineDepth > 0)
+        {
+            extra->setProperty("pipelineUnderruns", static_cast<juce::int64>(pipeline.underruns));
+            extra->setProperty("pipelineOverruns", static_cast<juce::int64>(pipeline.overruns));
+        }
+        report.extra = juce::var(extra);
+        return 0;
+    }
+
+    void printReport(const Report& report, const GraphEngine& graph, bool asJson)
+    {
+        if (asJson)
+        {
+            auto* root = new juce::DynamicObject();
+            root->setProperty("mode", report.mode);
+            root->setProperty("sampleRate", report.sampleRate);
+            root->setProperty("blockSize", report.blockSize);
+            root->setProperty("audioSeconds", report.audioSeconds);
+            root->setProperty("wallSeconds", report.wallSeconds);
+            root->setProperty("realtimeFactor", report.realtimeFactor);
+            root->setProperty("latencySamples", report.latencySamples);
+            root->setProperty("details", report.extra);
+
+            juce::Array<juce::var> nodes;
+            for (const auto& timing : report.timings)
+            {
+                auto* node = new juce::DynamicObject();
+                node->setProperty("id", timing.id.toString());
+                node->setProperty("name", nodeName(graph, timing.id));
+                node->setProperty("calls", static_cast<juce::int64>(timing.calls));
+                node->setProperty("meanUs", timing.meanUs);
+                node->setProperty("p99Us", timing.p99Us);
+                node->setProperty("maxUs", timing.maxUs);
+                node->setProperty("loadPercent", timing.meanLoadPercent);
+                nodes.add(juce::var(node));
+            }
+            root->setProperty("nodes", nodes);
+
+            std::cout << juce::JSON::toString(juce::var(root)) << std::endl;
+            return;
+        }
+
+        std::cout << "Mode:        " << report.mode << "\n"
+                  << "Format:      " << report.sampleRate << " Hz, " << report.blockSize << " samples\n"
+                  << "Audio:       " << juce::String(report.audioSeconds, 2) << " s in "
+                  << juce::String(report.wallSeconds, 3) << " s wall ("
+                  << juce::String(report.realtimeFactor, 1) << "x real time)\n"
+                  << "Latency:     " << report.latencySamples << " samples\n";
+
+        if (auto* extra = report.extra.getDynamicObject())
+        {
+            for (const auto& property : extra->getProperties())
+                std::cout << "  " << property.name.toString() << ": " << property.value.toString() << "\n";
+        }
+
+        std::cout << "\nNode timings (us)\n"
+                  << juce::String("node").paddedRight(' ', 28) << juce::String("calls").paddedLeft(' ', 10)
+                  << juce::String("mean").paddedLeft(' ', 10) << juce::String("p99").paddedLeft(' ', 10)
+                  << juce::String("max").paddedLeft(' ', 10) << juce::String("load %").paddedLeft(' ', 10) << "\n";
+        for (const auto& timing : report.timings)
+        {
+            std::cout << nodeName(graph, timing.id).substring(0, 27).paddedRight(' ', 28)
+                      << juce::String(static_cast<juce::int64>(timing.calls)).paddedLeft(' ', 10)
+                      << juce::String(timing.meanUs, 1).paddedLeft(' ', 10)
+                      << juce::String(timing.p99Us, 1).paddedLeft(' ', 10)
+                      << juce::String(timing.maxUs, 1).paddedLeft(' ', 10)
+                      << juce::String(timing.meanLoadPercent, 2).paddedLeft(' ', 10) << "\n";
+        }
+        std::cout.flush();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    // Hosted plug-ins expect a message manager to exist.
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const juce::ArgumentList args(argc, argv);
+    if (args.size() == 0 || args.containsOption("--help|-h") || args[0].isOption())
+    {
+        std::cout << kUsage;
+        return args.size() == 0 ? 1 : 0;
+    }
+
+    CommandLineOptions cmd(args);
+    const auto projectFile = resolveFile(args[0].text);
+    const auto pluginCache = cmd.has("--plugin-cache")
+        ? resolveFile(cmd.text("--plugin-cache"))
+        : juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+              .getChildFile("VSTHost")
+              .getChildFile("plugin-cache.json");
+
+    auto graph = std::make_shared<GraphEngine>();
+    if (! buildGraph(projectFile, pluginCache, *graph))
+        return 1;
+
+    graph->setProfilingEnabled(true);
+
+    Report report;
+    const int status = cmd.has("--device") ? runDevice(cmd, graph, report)
+                                           : runOffline(cmd, graph, report);
+    if (status != 0)
+        return status;
+
+    if constexpr (host::graph::RealtimeChecker::isAvailable())
+    {
+        const auto counts = host::graph::RealtimeChecker::getCounts();
+        if (auto* extra = report.extra.getDynamicObject())
+        {
+            extra->setProperty("realtimeAllocations", static_cast<juce::int64>(counts.allocations));
+            extra->setProperty("realtimeDeallocations", static_cast<juce::int64>(counts.deallocations));
+            extra->setProperty("realtimeLocks", static_cast<juce::int64>(counts.locks));
+        }
+        host::graph::RealtimeChecker::logNewViolations(graph.get());
+    }
+
+    report.timings = graph->getNodeTimings();
+    std::sort(report.timings.begin(), report.timings.end(),
+              [](const auto& a, const auto& b) { return a.meanUs > b.meanUs; });
+
+    printReport(report, *graph, args.containsOption("--json"));
+    return 0;
+}
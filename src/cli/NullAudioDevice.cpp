@@ -0,0 +1,147 @@
+#include "cli/NullAudioDevice.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace host::cli
+{
+    namespace
+    {
+        constexpr int kStopTimeoutMs = 2000;
+        constexpr float kInputNoiseLevel = 0.01f; // -40 dBFS: keeps silence detection out of the measurement
+    }
+
+    NullAudioDevice::NullAudioDevice(double sampleRateIn, int bufferSizeIn, int numChannelsIn, bool freeRunningIn)
+        : juce::AudioIODevice("Null device", "Null")
+        , juce::Thread("Null audio device")
+        , sampleRate(sampleRateIn > 0.0 ? sampleRateIn : 48000.0)
+        , bufferSize(std::max(1, bufferSizeIn))
+        , numChannels(std::max(1, numChannelsIn))
+        , freeRunning(freeRunningIn)
+    {
+    }
+
+    NullAudioDevice::~NullAudioDevice()
+    {
+        close();
+    }
+
+    juce::StringArray NullAudioDevice::getOutputChannelNames()
+    {
+        juce::StringArray names;
+        for (int ch = 0; ch < numChannels; ++ch)
+            names.add("Output " + juce::String(ch + 1));
+        return names;
+    }
+
+    juce::StringArray NullAudioDevice::getInputChannelNames()
+    {
+        juce::StringArray names;
+        for (int ch = 0; ch < numChannels; ++ch)
+            names.add("Input " + juce::String(ch + 1));
+        return names;
+    }
+
+    juce::Array<double> NullAudioDevice::getAvailableSampleRates()
+    {
+        return { sampleRate };
+    }
+
+    juce::Array<int> NullAudioDevice::getAvailableBufferSizes()
+    {
+        return { bufferSize };
+    }
+
+    juce::String NullAudioDevice::open(const juce::BigInteger&, const juce::BigInteger&, double, int)
+    {
+        // Always runs at the format it was constructed with.
+        opened = true;
+        return {};
+    }
+
+    void NullAudioDevice::close()
+    {
+        stop();
+        opened = false;
+    }
+
+    void NullAudioDevice::start(juce::AudioIODeviceCallback* callback)
+    {
+        stop();
+        if (callback == nullptr || ! opened)
+            return;
+
+        activeCallback = callback;
+        activeCallback->audioDeviceAboutToStart(this);
+        if (! startRealtimeThread(juce::Thread::RealtimeOptions {}))
+            startThread(juce::Thread::Priority::highest);
+    }
+
+    void NullAudioDevice::stop()
+    {
+        if (activeCallback == nullptr)
+            return;
+
+        stopThread(kStopTimeoutMs);
+        activeCallback->audioDeviceStopped();
+        activeCallback = nullptr;
+    }
+
+    juce::BigInteger NullAudioDevice::getActiveOutputChannels() const
+    {
+        juce::BigInteger channels;
+        channels.setRange(0, numChannels, true);
+        return channels;
+    }
+
+    juce::BigInteger NullAudioDevice::getActiveInputChannels() const
+    {
+        juce::BigInteger channels;
+        channels.setRange(0, numChannels, true);
+        return channels;
+    }
+
+    void NullAudioDevice::run()
+    {
+        using Clock = std::chrono::steady_clock;
+
+        juce::AudioBuffer<float> inputs(numChannels, bufferSize);
+        juce::AudioBuffer<float> outputs(numChannels, bufferSize);
+        juce::Random random;
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto* data = inputs.getWritePointer(ch);
+            for (int i = 0; i < bufferSize; ++i)
+                data[i] = (random.nextFloat() * 2.0f - 1.0f) * kInputNoiseLevel;
+        }
+
+        const auto period = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(static_cast<double>(bufferSize) / sampleRate));
+        auto nextCallback = Clock::now();
+        const juce::AudioIODeviceCallbackContext context {};
+
+        while (! threadShouldExit())
+        {
+            if (! freeRunning)
+                std::this_thread::sleep_until(nextCallback);
+
+            activeCallback->audioDeviceIOCallbackWithContext(inputs.getArrayOfReadPointers(), numChannels,
+                                                             outputs.getArrayOfWritePointers(), numChannels,
+                                                             bufferSize, context);
+            callbacks.store(callbacks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+            nextCallback += period;
+            const auto now = Clock::now();
+            if (! freeRunning && now > nextCallback + period)
+            {
+                // A real driver would have played a period of garbage by now;
+                // skip ahead instead of bursting callbacks to catch up.
+                const auto behind = (now - nextCallback) / period;
+                droppedPeriods.store(droppedPeriods.load(std::memory_order_relaxed) + static_cast<std::uint64_t>(behind),
+                                     std::memory_order_relaxed);
+                nextCallback += period * behind;
+            }
+        }
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <juce_audio_devices/juce_audio_devices.h>
+
+#include <atomic>
+#include <cstdint>
+
+namespace host::cli
+{
+    /// Audio device without hardware. A thread calls the callback with
+    /// low-level noise on every input, either paced like a real device (one
+    /// buffer per buffer duration) or free-running as fast as the callback
+    /// returns. Lets the whole DeviceEngine path (resamplers, pipeline,
+    /// deadline monitor) run on machines with no sound card.
+    ///
+    /// Paced mode behaves like a driver that drops a period when a callback
+    /// overruns: the schedule skips ahead rather than trying to catch up.
+    class NullAudioDevice final : public juce::AudioIODevice,
+                                  private juce::Thread
+    {
+    public:
+        NullAudioDevice(double sampleRate, int bufferSize, int numChannels, bool freeRunning);
+        ~NullAudioDevice() override;
+
+        juce::StringArray getOutputChannelNames() override;
+        juce::StringArray getInputChannelNames() override;
+        juce::Array<double> getAvailableSampleRates() override;
+        juce::Array<int> getAvailableBufferSizes() override;
+        int getDefaultBufferSize() override { return bufferSize; }
+
+        juce::String open(const juce::BigInteger& inputChannels,
+                          const juce::BigInteger& outputChannels,
+                          double sampleRate,
+                          int bufferSizeSamples) override;
+        void close() override;
+        bool isOpen() override { return opened; }
+        void start(juce::AudioIODeviceCallback* callback) override;
+        void stop() override;
+        bool isPlaying() override { return isThreadRunning(); }
+        juce::String getLastError() override { return {}; }
+
+        int getCurrentBufferSizeSamples() override { return bufferSize; }
+        double getCurrentSampleRate() override { return sampleRate; }
+        int getCurrentBitDepth() override { return 32; }
+        juce::BigInteger getActiveOutputChannels() const override;
+        juce::BigInteger getActiveInputChannels() const override;
+        int getOutputLatencyInSamples() override { return 0; }
+        int getInputLatencyInSamples() override { return 0; }
+
+        [[nodiscard]] std::uint64_t getCallbackCount() const noexcept { return callbacks.load(std::memory_order_relaxed); }
+        /// Periods the paced schedule skipped because a callback overran.
+        [[nodiscard]] std::uint64_t getDroppedPeriods() const noexcept { return droppedPeriods.load(std::memory_order_relaxed); }
+
+    private:
+        void run() override;
+
+        double sampleRate;
+        int bufferSize;
+        int numChannels;
+        bool freeRunning;
+        bool opened { false };
+        juce::AudioIODeviceCallback* activeCallback { nullptr };
+
+        std::atomic<std::uint64_t> callbacks { 0 };
+        std::atomic<std::uint64_t> droppedPeriods { 0 };
+    };
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+namespace host::graph
+{
+/// Body of a node's background thread that rebuilds derived state (an FIR
+/// kernel, a resampled impulse response) from settings the message thread
+/// changes. Call it from the thread's run().
+///
+/// The owner guards its settings and a generation counter with `mutex`,
+/// bumps the counter on every change and then notify()s the thread. Each
+/// pass takes snapshot() under the lock, runs build() on the copy without
+/// it, and hands the result to install() only if the generation has not
+/// moved meanwhile; otherwise the result is already stale and the pass
+/// starts over, so changes arriving mid-build just cost another pass.
+template <typename Snapshot, typename Build, typename Install>
+void runBackgroundRebuild(juce::Thread& thread, std::mutex& mutex, const std::uint64_t& generation,
+                          Snapshot&& snapshot, Build&& build, Install&& install)
+{
+    while (! thread.threadShouldExit())
+    {
+        thread.wait(-1);
+
+        while (! thread.threadShouldExit())
+        {
+            auto [settings, started] = [&]
+            {
+                const std::lock_guard<std::mutex> lock(mutex);
+                return std::make_pair(snapshot(), generation);
+            }();
+
+            auto result = build(settings);
+
+            {
+                const std::lock_guard<std::mutex> lock(mutex);
+                if (started != generation)
+                    continue;
+            }
+            install(std::move(result));
+            break;
+        }
+    }
+}
+} // namespace host::graph
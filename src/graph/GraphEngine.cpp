@@ -1,9 +1,17 @@
 #include "graph/GraphEngine.h"
 
+#include "graph/RealtimeChecker.h"
+#include "graph/WorkerPool.h"
+
 #include <algorithm>
 #include <array>
+#include <bit>
+#include <chrono>
+#include <iterator>
+#include <limits>
 #include <queue>
 #include <stdexcept>
+#include <thread>
 
 namespace host::graph
 {
@@ -12,11 +20,14 @@ namespace
 constexpr double defaultSampleRate = 48000.0;
 constexpr int defaultBlockSize = 256;
 constexpr int maxProcessChannels = 64;
+// Longest the message thread waits for a gap between callbacks before
+// leaving retired runtimes for the next publish.
+constexpr juce::uint32 reclaimTimeoutMs = 50;
 } // namespace
 
-std::string GraphEngine::toKey(const NodeId& id)
+void GraphEngine::eraseValue(std::vector<std::uint32_t>& values, std::uint32_t value)
 {
-    return id.toString().toStdString();
+    values.erase(std::remove(values.begin(), values.end(), value), values.end());
 }
 
 void GraphEngine::waitForInFlightCallbacks() const
@@ -39,26 +50,69 @@ void GraphEngine::resumeProcessingUnlocked()
     processingSuspended_.store(false, std::memory_order_release);
 }
 
-void GraphEngine::invalidateRuntimeUnlocked()
+void GraphEngine::publishRuntimeUnlocked(std::shared_ptr<RuntimeState> next)
+{
+    // process() picks the pointer up at its next block; a callback already
+    // running finishes on the old state, which is therefore only retired
+    // here and freed later on this thread, never on the audio thread.
+    liveRuntime_.store(next.get(), std::memory_order_seq_cst);
+    if (ownedRuntime_ != nullptr)
+        retiredRuntimes_.push_back(std::move(ownedRuntime_));
+    ownedRuntime_ = std::move(next);
+}
+
+void GraphEngine::reclaimRetiredRuntimes()
 {
-    runtimeState_.store(nullptr, std::memory_order_release);
+    // Take the states out so the wait below does not hold mutex_ and block
+    // graph edits on other threads. Every one of them was swapped out before
+    // this point.
+    std::vector<std::shared_ptr<RuntimeState>> retired;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        retired.swap(retiredRuntimes_);
+    }
+    if (retired.empty())
+        return;
+
+    // Callbacks bump inFlightProcessCallbacks_ before loading liveRuntime_.
+    // Seeing the count at zero after the swap therefore means no callback
+    // can still hold a retired state. Callbacks are short and periodic, so a
+    // gap comes quickly; if none does, the states wait for the next publish.
+    const auto deadline = juce::Time::getMillisecondCounter() + reclaimTimeoutMs;
+    while (inFlightProcessCallbacks_.load(std::memory_order_seq_cst) != 0)
+    {
+        if (juce::Time::getMillisecondCounter() >= deadline)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            retiredRuntimes_.insert(retiredRuntimes_.end(),
+                                    std::make_move_iterator(retired.begin()),
+                                    std::make_move_iterator(retired.end()));
+            return;
+        }
+        std::this_thread::yield();
+    }
+
+    // Freed here, outside the lock: node and worker pool teardown can be slow.
 }
 
 void GraphEngine::clear()
 {
+    const DeferredReclaim reclaim { *this };
     std::lock_guard<std::mutex> lock(mutex_);
-    suspendProcessingAndDrainUnlocked();
 
-    nodes_.clear();
-    indexById_.clear();
+    // Output goes silent from the next block; the nodes themselves are
+    // released with the retired runtime, off the audio thread.
+    publishRuntimeUnlocked(nullptr);
+
+    slots_.clear();
+    freeSlots_.clear();
+    handleById_.clear();
+    numNodes_ = 0;
     schedule_.clear();
     inputNode_ = {};
     outputNode_ = {};
     sampleRate_ = defaultSampleRate;
     blockSize_ = defaultBlockSize;
-    invalidateRuntimeUnlocked();
-
-    resumeProcessingUnlocked();
 }
 
 GraphEngine::NodeId GraphEngine::addNode(std::unique_ptr<Node> node)
@@ -82,155 +136,179 @@ GraphEngine::NodeId GraphEngine::addNodeWithId(const NodeId& id, std::unique_ptr
 GraphEngine::NodeId GraphEngine::addNodeUnlocked(std::unique_ptr<Node> node, std::optional<NodeId> requestedId)
 {
     NodeId id;
-    std::string key;
 
     if (requestedId.has_value())
     {
         id = requestedId.value();
-        key = toKey(id);
-        if (indexById_.find(key) != indexById_.end())
+        if (handleById_.find(id) != handleById_.end())
             throw std::invalid_argument("GraphEngine::addNodeWithId: id already exists");
     }
     else
     {
-        id = NodeId();
-        key = toKey(id);
-        while (indexById_.find(key) != indexById_.end())
-        {
+        while (handleById_.find(id) != handleById_.end())
             id = NodeId();
-            key = toKey(id);
-        }
     }
 
-    NodeEntry entry;
-    entry.id = id;
-    entry.node = std::shared_ptr<Node>(std::move(node));
+    // Reuse a freed slot when there is one so the table stays dense; its
+    // generation was bumped on removal, which keeps old handles stale.
+    std::uint32_t index;
+    if (! freeSlots_.empty())
+    {
+        index = freeSlots_.back();
+        freeSlots_.pop_back();
+    }
+    else
+    {
+        index = static_cast<std::uint32_t>(slots_.size());
+        slots_.emplace_back();
+    }
+
+    auto& slot = slots_[index];
+    slot.id = id;
+    slot.node = std::shared_ptr<Node>(std::move(node));
+    slot.profile = std::make_shared<NodeProfile>();
+    slot.occupied = true;
+    if (nonRealtime_)
+        slot.node->setNonRealtime(true);
 
-    indexById_[key] = nodes_.size();
-    nodes_.push_back(std::move(entry));
-    invalidateRuntimeUnlocked();
+    handleById_[id] = NodeHandle { index, slot.generation };
+    ++numNodes_;
 
     return id;
 }
 
-std::shared_ptr<Node> GraphEngine::getNode(const NodeId& id) const
+GraphEngine::NodeHandle GraphEngine::findHandle(const NodeId& id) const
 {
     std::lock_guard<std::mutex> lock(mutex_);
-    return getNodeUnlocked(id);
+    return findHandleUnlocked(id);
 }
 
-void GraphEngine::removeNode(NodeId id)
+GraphEngine::NodeId GraphEngine::getNodeId(NodeHandle handle) const
 {
     std::lock_guard<std::mutex> lock(mutex_);
+    const auto* slot = resolveUnlocked(handle);
+    return slot != nullptr ? slot->id : NodeId::null();
+}
 
-    if (! hasNodeUnlocked(id))
-        return;
-
-    suspendProcessingAndDrainUnlocked();
-
-    try
-    {
-        const auto key = toKey(id);
-        const auto indexIt = indexById_.find(key);
-        if (indexIt == indexById_.end())
-        {
-            resumeProcessingUnlocked();
-            return;
-        }
-
-        const auto index = indexIt->second;
-        if (index >= nodes_.size())
-        {
-            resumeProcessingUnlocked();
-            return;
-        }
+std::shared_ptr<Node> GraphEngine::getNode(const NodeId& id) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto* slot = resolveUnlocked(findHandleUnlocked(id));
+    return slot != nullptr ? slot->node : nullptr;
+}
 
-        for (auto& entry : nodes_)
-        {
-            auto& outputs = entry.outputs;
-            outputs.erase(std::remove(outputs.begin(), outputs.end(), id), outputs.end());
-        }
+std::shared_ptr<Node> GraphEngine::getNode(NodeHandle handle) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto* slot = resolveUnlocked(handle);
+    return slot != nullptr ? slot->node : nullptr;
+}
 
-        nodes_.erase(nodes_.begin() + static_cast<std::ptrdiff_t>(index));
-        indexById_.erase(indexIt);
+void GraphEngine::removeNode(NodeId id)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    removeNodeUnlocked(findHandleUnlocked(id));
+}
 
-        // Decrement indices that pointed past the removed node so the map
-        // stays consistent without an O(n) full rebuild.
-        for (auto& idxEntry : indexById_)
-        {
-            if (idxEntry.second > index)
-                idxEntry.second -= 1;
-        }
+void GraphEngine::removeNode(NodeHandle handle)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    removeNodeUnlocked(handle);
+}
 
-        if (inputNode_ == id)
-            inputNode_ = {};
-        if (outputNode_ == id)
-            outputNode_ = {};
+void GraphEngine::removeNodeUnlocked(NodeHandle handle)
+{
+    if (resolveUnlocked(handle) == nullptr)
+        return;
 
-        invalidateRuntimeUnlocked();
-        resumeProcessingUnlocked();
-    }
-    catch (...)
-    {
-        resumeProcessingUnlocked();
-        throw;
-    }
+    const auto index = handle.index;
+    auto& slot = slots_[index];
+
+    // Both adjacency lists are kept, so unlinking touches only the node's
+    // own neighbours. The live runtime holds its own reference to the node
+    // and keeps playing it until the next prepare() swaps in one without it.
+    for (const auto source : slot.inputs)
+        eraseValue(slots_[source].outputs, index);
+    for (const auto target : slot.outputs)
+        eraseValue(slots_[target].inputs, index);
+
+    handleById_.erase(slot.id);
+    slot.id = {};
+    slot.node.reset();
+    slot.profile.reset();
+    slot.inputs.clear();
+    slot.outputs.clear();
+    slot.occupied = false;
+    ++slot.generation;
+    freeSlots_.push_back(index);
+    --numNodes_;
+
+    if (inputNode_ == handle)
+        inputNode_ = {};
+    if (outputNode_ == handle)
+        outputNode_ = {};
 }
 
 void GraphEngine::setIO(NodeId inputNode, NodeId outputNode)
 {
     std::lock_guard<std::mutex> lock(mutex_);
 
-    if (! hasNodeUnlocked(inputNode) || ! hasNodeUnlocked(outputNode))
+    const auto inputHandle = findHandleUnlocked(inputNode);
+    const auto outputHandle = findHandleUnlocked(outputNode);
+    if (! inputHandle.isValid() || ! outputHandle.isValid())
         throw std::invalid_argument("GraphEngine::setIO: invalid node id");
 
-    inputNode_ = inputNode;
-    outputNode_ = outputNode;
-    invalidateRuntimeUnlocked();
+    inputNode_ = inputHandle;
+    outputNode_ = outputHandle;
 }
 
 void GraphEngine::connect(NodeId from, NodeId to)
 {
-    if (from == to)
-        throw std::invalid_argument("GraphEngine::connect: cannot connect node to itself");
+    std::lock_guard<std::mutex> lock(mutex_);
+    connectUnlocked(findHandleUnlocked(from), findHandleUnlocked(to));
+}
 
+void GraphEngine::connect(NodeHandle from, NodeHandle to)
+{
     std::lock_guard<std::mutex> lock(mutex_);
+    connectUnlocked(from, to);
+}
 
-    if (! hasNodeUnlocked(from) || ! hasNodeUnlocked(to))
+void GraphEngine::connectUnlocked(NodeHandle from, NodeHandle to)
+{
+    if (resolveUnlocked(from) == nullptr || resolveUnlocked(to) == nullptr)
         throw std::invalid_argument("GraphEngine::connect: invalid node id");
 
-    const auto fromKey = toKey(from);
-    const auto fromIndex = indexById_.at(fromKey);
-    auto& outputs = nodes_[fromIndex].outputs;
+    if (from.index == to.index)
+        throw std::invalid_argument("GraphEngine::connect: cannot connect node to itself");
 
-    const bool alreadyConnected = std::any_of(outputs.begin(), outputs.end(),
-                                              [&to](const NodeId& existing) { return existing == to; });
-    if (! alreadyConnected)
-        outputs.push_back(to);
+    auto& outputs = slots_[from.index].outputs;
+    if (std::find(outputs.begin(), outputs.end(), to.index) != outputs.end())
+        return;
 
-    invalidateRuntimeUnlocked();
+    outputs.push_back(to.index);
+    slots_[to.index].inputs.push_back(from.index);
 }
 
 void GraphEngine::disconnect(NodeId from, NodeId to)
 {
-    if (from == to)
-        return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    disconnectUnlocked(findHandleUnlocked(from), findHandleUnlocked(to));
+}
 
+void GraphEngine::disconnect(NodeHandle from, NodeHandle to)
+{
     std::lock_guard<std::mutex> lock(mutex_);
+    disconnectUnlocked(from, to);
+}
 
-    if (! hasNodeUnlocked(from) || ! hasNodeUnlocked(to))
+void GraphEngine::disconnectUnlocked(NodeHandle from, NodeHandle to)
+{
+    if (resolveUnlocked(from) == nullptr || resolveUnlocked(to) == nullptr || from.index == to.index)
         return;
 
-    const auto fromKey = toKey(from);
-    const auto fromIndex = indexById_.at(fromKey);
-    auto& outputs = nodes_[fromIndex].outputs;
-
-    const auto newEnd = std::remove(outputs.begin(), outputs.end(), to);
-    if (newEnd != outputs.end())
-    {
-        outputs.erase(newEnd, outputs.end());
-        invalidateRuntimeUnlocked();
-    }
+    eraseValue(slots_[from.index].outputs, to.index);
+    eraseValue(slots_[to.index].inputs, from.index);
 }
 
 void GraphEngine::setEngineFormat(double sampleRate, int blockSize)
@@ -239,95 +317,395 @@ void GraphEngine::setEngineFormat(double sampleRate, int blockSize)
 
     sampleRate_ = (sampleRate > 0.0) ? sampleRate : defaultSampleRate;
     blockSize_ = (blockSize > 0) ? blockSize : defaultBlockSize;
-    invalidateRuntimeUnlocked();
+}
+
+void GraphEngine::setBusChannels(int numChannels)
+{
+    const int clamped = std::clamp(numChannels, 1, maxProcessChannels);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    busChannels_ = clamped;
 }
 
 void GraphEngine::setPdcEnabled(bool enabled)
 {
     std::lock_guard<std::mutex> lock(mutex_);
-    if (pdcEnabled_ == enabled)
-        return;
     pdcEnabled_ = enabled;
-    invalidateRuntimeUnlocked();
 }
 
-void GraphEngine::prepare()
+void GraphEngine::setWorkerCount(int numWorkers)
 {
+    const int maxWorkers = std::max(0, juce::SystemStats::getNumCpus() - 1);
+    const int clamped = std::clamp(numWorkers, 0, maxWorkers);
+
     std::lock_guard<std::mutex> lock(mutex_);
-    suspendProcessingAndDrainUnlocked();
+    const int current = workerPool_ != nullptr ? workerPool_->getNumWorkers() : 0;
+    if (clamped == current)
+        return;
 
-    try
+    // The live runtime keeps its reference to the old pool until the next
+    // prepare() replaces it; the pool's threads are joined when that runtime
+    // is reclaimed on the message thread.
+    workerPool_ = clamped > 0 ? std::make_shared<WorkerPool>(clamped) : nullptr;
+}
+
+int GraphEngine::getWorkerCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return workerPool_ != nullptr ? workerPool_->getNumWorkers() : 0;
+}
+
+void GraphEngine::setTailSleepEnabled(bool enabled) noexcept
+{
+    tailSleepEnabled_.store(enabled, std::memory_order_relaxed);
+}
+
+bool GraphEngine::isTailSleepEnabled() const noexcept
+{
+    return tailSleepEnabled_.load(std::memory_order_relaxed);
+}
+
+void GraphEngine::setNonRealtime(bool isNonRealtime)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (nonRealtime_ == isNonRealtime)
+        return;
+
+    nonRealtime_ = isNonRealtime;
+    for (auto& slot : slots_)
+    {
+        if (slot.occupied && slot.node != nullptr)
+            slot.node->setNonRealtime(isNonRealtime);
+    }
+
+    // Plug-ins take the mode at prepare time; prepare() treats the switch
+    // like a format change and prepares every node again.
+}
+
+bool GraphEngine::isNonRealtime() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return nonRealtime_;
+}
+
+void GraphEngine::setProfilingEnabled(bool enabled) noexcept
+{
+    profilingEnabled_.store(enabled, std::memory_order_relaxed);
+}
+
+bool GraphEngine::isProfilingEnabled() const noexcept
+{
+    return profilingEnabled_.load(std::memory_order_relaxed);
+}
+
+std::vector<GraphEngine::NodeTiming> GraphEngine::getNodeTimings() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::vector<NodeTiming> timings;
+    timings.reserve(numNodes_);
+    for (const auto& slot : slots_)
     {
-        buildScheduleUnlocked();
+        if (! slot.occupied || slot.profile == nullptr)
+            continue;
 
-        if (schedule_.empty())
+        const auto& profile = *slot.profile;
+        const auto calls = profile.calls.load(std::memory_order_relaxed);
+        if (calls == 0)
+            continue;
+
+        NodeTiming timing;
+        timing.id = slot.id;
+        timing.calls = calls;
+
+        const auto lastNs = profile.lastNs.load(std::memory_order_relaxed);
+        const auto lastBudgetNs = profile.lastBudgetNs.load(std::memory_order_relaxed);
+        const auto totalNs = profile.totalNs.load(std::memory_order_relaxed);
+        const auto totalSamples = profile.totalSamples.load(std::memory_order_relaxed);
+
+        timing.lastUs = static_cast<double>(lastNs) * 1.0e-3;
+        timing.meanUs = static_cast<double>(totalNs) * 1.0e-3 / static_cast<double>(calls);
+        timing.maxUs = static_cast<double>(profile.maxNs.load(std::memory_order_relaxed)) * 1.0e-3;
+        if (lastBudgetNs > 0)
+            timing.lastLoadPercent = 100.0 * static_cast<double>(lastNs) / static_cast<double>(lastBudgetNs);
+        if (totalSamples > 0 && sampleRate_ > 0.0)
+            timing.meanLoadPercent = 100.0 * static_cast<double>(totalNs) * 1.0e-9 * sampleRate_ / static_cast<double>(totalSamples);
+
+        // Walk the histogram up to the 99th percentile call.
+        std::uint64_t counted = 0;
+        std::uint64_t histogramCalls = 0;
+        for (const auto& bucket : profile.histogram)
+            histogramCalls += bucket.load(std::memory_order_relaxed);
+        const auto threshold = histogramCalls - histogramCalls / 100;
+        for (int b = 0; b < NodeProfile::kHistogramBuckets && histogramCalls > 0; ++b)
         {
-            invalidateRuntimeUnlocked();
-            resumeProcessingUnlocked();
-            return;
+            counted += profile.histogram[static_cast<size_t>(b)].load(std::memory_order_relaxed);
+            if (counted >= threshold)
+            {
+                timing.p99Us = static_cast<double>(NodeProfile::bucketUpperBoundNs(b)) * 1.0e-3;
+                break;
+            }
         }
+        timing.p99Us = std::min(timing.p99Us, timing.maxUs);
+
+        timings.push_back(timing);
+    }
+
+    return timings;
+}
+
+void GraphEngine::resetNodeTimings()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& slot : slots_)
+    {
+        if (slot.profile != nullptr)
+            slot.profile->reset();
+    }
+}
+
+GraphEngine::SlowestNode GraphEngine::getSlowestNode() const noexcept
+{
+    SlowestNode slowest;
+    const auto packed = slowestNodeHandle_.load(std::memory_order_relaxed);
+    if (packed != 0)
+    {
+        slowest.handle.index = static_cast<std::uint32_t>(packed >> 32) - 1;
+        slowest.handle.generation = static_cast<std::uint32_t>(packed);
+        slowest.elapsedNs = slowestNodeNs_.load(std::memory_order_relaxed);
+    }
+    return slowest;
+}
+
+GraphEngine::SlowestNode GraphEngine::findSlowestNode(const RuntimeState& runtime, std::uint64_t profileCall) noexcept
+{
+    SlowestNode slowest;
+    for (const auto& runtimeNode : runtime.nodes)
+    {
+        if (runtimeNode.profile == nullptr
+            || runtimeNode.profile->lastCall.load(std::memory_order_relaxed) != profileCall)
+            continue;
+
+        const auto ns = runtimeNode.profile->callNs.load(std::memory_order_relaxed);
+        if (! slowest.handle.isValid() || ns > slowest.elapsedNs)
+        {
+            slowest.handle = runtimeNode.handle;
+            slowest.elapsedNs = ns;
+        }
+    }
+    return slowest;
+}
+
+void GraphEngine::NodeProfile::record(std::uint64_t elapsedNs, int numSamples, double sampleRate, std::uint64_t call) noexcept
+{
+    const auto budgetNs = sampleRate > 0.0
+        ? static_cast<std::uint64_t>(static_cast<double>(numSamples) * 1.0e9 / sampleRate)
+        : 0;
+
+    lastNs.store(elapsedNs, std::memory_order_relaxed);
+    lastBudgetNs.store(budgetNs, std::memory_order_relaxed);
+    totalNs.store(totalNs.load(std::memory_order_relaxed) + elapsedNs, std::memory_order_relaxed);
+    totalSamples.store(totalSamples.load(std::memory_order_relaxed) + static_cast<std::uint64_t>(numSamples),
+                       std::memory_order_relaxed);
+    calls.store(calls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (elapsedNs > maxNs.load(std::memory_order_relaxed))
+        maxNs.store(elapsedNs, std::memory_order_relaxed);
+
+    recordCall(elapsedNs, call);
+
+    auto& bucket = histogram[static_cast<size_t>(bucketFor(elapsedNs))];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void GraphEngine::NodeProfile::recordCall(std::uint64_t elapsedNs, std::uint64_t call) noexcept
+{
+    if (lastCall.load(std::memory_order_relaxed) == call)
+    {
+        callNs.store(callNs.load(std::memory_order_relaxed) + elapsedNs, std::memory_order_relaxed);
+    }
+    else
+    {
+        callNs.store(elapsedNs, std::memory_order_relaxed);
+        lastCall.store(call, std::memory_order_relaxed);
+    }
+}
+
+void GraphEngine::NodeProfile::reset() noexcept
+{
+    // Racing a block in flight can leave that one call half-counted, which
+    // is fine for a statistics reset.
+    lastNs.store(0, std::memory_order_relaxed);
+    lastBudgetNs.store(0, std::memory_order_relaxed);
+    totalNs.store(0, std::memory_order_relaxed);
+    totalSamples.store(0, std::memory_order_relaxed);
+    calls.store(0, std::memory_order_relaxed);
+    maxNs.store(0, std::memory_order_relaxed);
+    callNs.store(0, std::memory_order_relaxed);
+    for (auto& bucket : histogram)
+        bucket.store(0, std::memory_order_relaxed);
+}
+
+int GraphEngine::NodeProfile::bucketFor(std::uint64_t ns) noexcept
+{
+    if (ns < 4)
+        return static_cast<int>(ns);
+
+    // Octave from the top bit, quarter-octave from the two bits below it.
+    const int msb = static_cast<int>(std::bit_width(ns)) - 1;
+    const int quarter = static_cast<int>((ns >> (msb - 2)) & 3u);
+    return std::min(msb * 4 + quarter, kHistogramBuckets - 1);
+}
+
+std::uint64_t GraphEngine::NodeProfile::bucketUpperBoundNs(int bucket) noexcept
+{
+    if (bucket < 4)
+        return static_cast<std::uint64_t>(bucket) + 1;
+
+    // bucketFor() maps 4..7 ns straight to octave 2, so buckets 4..7 stay
+    // empty; they end where the exact buckets do.
+    const int msb = bucket / 4;
+    if (msb < 2)
+        return 4;
+
+    const auto quarter = static_cast<std::uint64_t>(bucket % 4);
+    return (4 + quarter + 1) << (msb - 2);
+}
 
-        for (const auto& id : schedule_)
+void GraphEngine::prepare()
+{
+    const DeferredReclaim reclaim { *this };
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // A cycle throws here, before anything is touched: the live runtime just
+    // keeps playing the last valid graph.
+    buildScheduleUnlocked();
+
+    if (schedule_.empty())
+    {
+        publishRuntimeUnlocked(nullptr);
+        return;
+    }
+
+    // Everything below runs while the live runtime keeps processing. Its
+    // nodes are in use on the audio thread and already prepared for the
+    // current format, so only nodes new to the graph get prepare(). A format
+    // (or realtime mode) change has to re-prepare every node; that is the one
+    // case which still stops processing, as the device is being reconfigured
+    // anyway.
+    const auto* live = ownedRuntime_.get();
+    const bool formatChanged = live != nullptr
+        && (live->sampleRate != sampleRate_ || live->blockSize != blockSize_ || live->nonRealtime != nonRealtime_);
+    if (formatChanged)
+    {
+        suspendProcessingAndDrainUnlocked();
+        publishRuntimeUnlocked(nullptr);
+        live = nullptr;
+    }
+
+    try
+    {
+        // The live runtime's node for a slot, if it is still the same node
+        // (same generation) - i.e. one that is already prepared and running.
+        const auto findLive = [live](NodeHandle handle) -> const RuntimeNode*
         {
-            auto node = getNodeUnlocked(id);
-            if (node)
-                node->prepare(sampleRate_, blockSize_);
+            if (live == nullptr || handle.index >= live->indexBySlot.size())
+                return nullptr;
+            const auto index = live->indexBySlot[handle.index];
+            if (index < 0 || live->nodes[static_cast<size_t>(index)].handle != handle)
+                return nullptr;
+            return &live->nodes[static_cast<size_t>(index)];
+        };
+
+        int numPreparedNodes = 0;
+        for (const auto index : schedule_)
+        {
+            const auto& slot = slots_[index];
+            if (findLive({ index, slot.generation }) == nullptr)
+            {
+                slot.node->prepare(sampleRate_, blockSize_);
+                ++numPreparedNodes;
+            }
         }
 
         auto runtime = std::make_shared<RuntimeState>();
         runtime->sampleRate = sampleRate_;
+        runtime->nonRealtime = nonRealtime_;
         runtime->blockSize = blockSize_;
+        runtime->numChannels = busChannels_;
         runtime->nodes.reserve(schedule_.size());
-        runtime->indexByNodeId.reserve(schedule_.size());
+        runtime->indexBySlot.assign(slots_.size(), -1);
 
-        for (const auto& id : schedule_)
+        for (const auto index : schedule_)
         {
-            auto node = getNodeUnlocked(id);
-            if (! node)
-                continue;
+            const auto& slot = slots_[index];
 
             RuntimeNode runtimeNode;
-            runtimeNode.id = id;
-            runtimeNode.node = std::move(node);
-            runtimeNode.receivesHostInput = (! inputNode_.isNull() && id == inputNode_);
-            runtimeNode.buffer.setSize(maxProcessChannels, std::max(1, blockSize_), false, false, true);
-            runtimeNode.inputBuffer.setSize(maxProcessChannels, std::max(1, blockSize_), false, false, true);
-            runtimeNode.buffer.clear();
-            runtimeNode.inputBuffer.clear();
-
-            const auto runtimeIndex = runtime->nodes.size();
-            runtime->indexByNodeId[toKey(id)] = runtimeIndex;
+            runtimeNode.id = slot.id;
+            runtimeNode.handle = { index, slot.generation };
+            runtimeNode.node = slot.node;
+            runtimeNode.profile = slot.profile;
+            runtimeNode.receivesHostInput = (runtimeNode.handle == inputNode_);
+
+            // Resolve the node's channel configuration once. Nodes reporting
+            // 0 are channel-agnostic and inherit the host bus width; buffers
+            // are sized from these, not from the 64-channel maximum.
+            const int reportedInputs = runtimeNode.node->inputChannelCount();
+            const int reportedOutputs = runtimeNode.node->outputChannelCount();
+            runtimeNode.numInputChannels = reportedInputs > 0 ? std::min(reportedInputs, busChannels_) : busChannels_;
+            runtimeNode.numOutputChannels = reportedOutputs > 0 ? std::min(reportedOutputs, busChannels_) : busChannels_;
+
+            runtime->indexBySlot[index] = static_cast<int>(runtime->nodes.size());
             runtime->nodes.push_back(std::move(runtimeNode));
         }
 
-        for (const auto& entry : nodes_)
+        // Every slot in the schedule has a runtime node, so both adjacency
+        // lists translate directly: O(V + E).
+        for (auto& rn : runtime->nodes)
         {
-            const auto targetRuntimeIt = runtime->indexByNodeId.find(toKey(entry.id));
-            if (targetRuntimeIt == runtime->indexByNodeId.end())
-                continue;
+            const auto& slot = slots_[rn.handle.index];
+            rn.inputIndices.reserve(slot.inputs.size());
+            for (const auto source : slot.inputs)
+                rn.inputIndices.push_back(static_cast<size_t>(runtime->indexBySlot[source]));
+            rn.outputIndices.reserve(slot.outputs.size());
+            for (const auto target : slot.outputs)
+                rn.outputIndices.push_back(static_cast<size_t>(runtime->indexBySlot[target]));
+        }
 
-            auto& targetRuntimeNode = runtime->nodes[targetRuntimeIt->second];
-            for (const auto& sourceEntry : nodes_)
+        // Parallel execution: group the schedule into dependency levels to
+        // find how many nodes can ever run at once, and size the per-block
+        // ready-count state so process() never allocates. Inputs always sit
+        // earlier in the schedule, so one forward pass is enough.
+        {
+            const auto nodeCount = runtime->nodes.size();
+            auto& parallel = runtime->parallel;
+            parallel.pendingInputs = std::make_unique<std::atomic<int>[]>(nodeCount);
+            parallel.readySlots = std::make_unique<std::atomic<int>[]>(nodeCount);
+            parallel.roots.clear();
+
+            std::vector<int> level(nodeCount, 0);
+            std::vector<int> levelWidth(nodeCount, 0);
+            for (size_t i = 0; i < nodeCount; ++i)
             {
-                const auto hasEdge = std::any_of(sourceEntry.outputs.begin(), sourceEntry.outputs.end(),
-                                                 [&entry](const NodeId& target) { return target == entry.id; });
-                if (! hasEdge)
-                    continue;
+                const auto& rn = runtime->nodes[i];
+                if (rn.inputIndices.empty())
+                    parallel.roots.push_back(i);
 
-                const auto sourceRuntimeIt = runtime->indexByNodeId.find(toKey(sourceEntry.id));
-                if (sourceRuntimeIt != runtime->indexByNodeId.end())
-                    targetRuntimeNode.inputIndices.push_back(sourceRuntimeIt->second);
+                for (const auto srcIdx : rn.inputIndices)
+                    level[i] = std::max(level[i], level[srcIdx] + 1);
+
+                ++levelWidth[static_cast<size_t>(level[i])];
             }
+
+            parallel.maxLevelWidth = levelWidth.empty()
+                ? 0
+                : *std::max_element(levelWidth.begin(), levelWidth.end());
+            runtime->workers = workerPool_;
         }
 
-        if (! outputNode_.isNull())
+        if (resolveUnlocked(outputNode_) != nullptr)
         {
-            const auto outputRuntimeIt = runtime->indexByNodeId.find(toKey(outputNode_));
-            if (outputRuntimeIt != runtime->indexByNodeId.end())
-            {
-                runtime->hasOutputNode = true;
-                runtime->outputNodeIndex = outputRuntimeIt->second;
-            }
+            runtime->hasOutputNode = true;
+            runtime->outputNodeIndex = static_cast<size_t>(runtime->indexBySlot[outputNode_.index]);
         }
 
         if (! runtime->hasOutputNode && ! runtime->nodes.empty())
@@ -362,30 +740,74 @@ void GraphEngine::prepare()
             const int maxLatency = pathLatency.empty()
                 ? 0
                 : *std::max_element(pathLatency.begin(), pathLatency.end());
+            for (size_t i = 0; i < runtime->nodes.size(); ++i)
+                runtime->nodes[i].compensationSamples = std::max(0, maxLatency - pathLatency[i]);
+        }
+
+        // Latency the host hears at the output node: the slowest path into it,
+        // counting any compensation delay inserted along the way.
+        int outputLatency = 0;
+        {
+            std::vector<int> arrival(runtime->nodes.size(), 0);
             for (size_t i = 0; i < runtime->nodes.size(); ++i)
             {
-                auto& rn = runtime->nodes[i];
-                rn.compensationSamples = std::max(0, maxLatency - pathLatency[i]);
-                if (rn.compensationSamples > 0)
+                const auto& rn = runtime->nodes[i];
+                int latest = 0;
+                for (const auto srcIdx : rn.inputIndices)
                 {
-                    rn.pdcDelayBuffer.setSize(maxProcessChannels,
-                                              rn.compensationSamples + std::max(1, blockSize_),
-                                              false, false, true);
-                    rn.pdcDelayBuffer.clear();
-                    rn.pdcWritePos = 0;
+                    if (srcIdx < arrival.size())
+                        latest = std::max(latest, arrival[srcIdx]);
                 }
+                const int selfLatency = rn.node ? std::max(0, rn.node->latencySamples()) : 0;
+                arrival[i] = latest + (runtime->pdcEnabled ? rn.compensationSamples : 0) + selfLatency;
             }
+            if (runtime->hasOutputNode)
+                outputLatency = arrival[runtime->outputNodeIndex];
         }
 
-        runtimeState_.store(std::move(runtime), std::memory_order_release);
-        resumeProcessingUnlocked();
+        // Carry node state over from the live runtime where the ring it would
+        // need is exactly the one already there; everything else starts
+        // fresh. The live runtime may be writing that state right now, so it
+        // is shared, not copied, and never touched here.
+        int numCarriedOverNodes = 0;
+        for (auto& rn : runtime->nodes)
+        {
+            const auto* previous = findLive(rn.handle);
+            if (previous != nullptr && previous->node == rn.node && previous->numInputChannels == rn.numInputChannels
+                && previous->compensationSamples == rn.compensationSamples)
+            {
+                rn.state = previous->state;
+                ++numCarriedOverNodes;
+                continue;
+            }
+
+            rn.state = std::make_shared<NodeState>();
+            if (rn.compensationSamples > 0)
+            {
+                // The ring wraps at compensationSamples, so that is all the
+                // history it needs.
+                rn.state->pdcDelayBuffer.setSize(rn.numInputChannels, rn.compensationSamples, false, false, true);
+                rn.state->pdcDelayBuffer.clear();
+            }
+        }
+
+        markInPlaceNodes(*runtime);
+        assignBufferPool(*runtime, runtime->workers != nullptr && runtime->parallel.maxLevelWidth > 1, live);
+        runtime->stats.numPreparedNodes = numPreparedNodes;
+        runtime->stats.numCarriedOverNodes = numCarriedOverNodes;
+        runtime->stats.latencySamples = outputLatency;
+
+        publishRuntimeUnlocked(std::move(runtime));
     }
     catch (...)
     {
-        invalidateRuntimeUnlocked();
-        resumeProcessingUnlocked();
+        if (formatChanged)
+            resumeProcessingUnlocked();
         throw;
     }
+
+    if (formatChanged)
+        resumeProcessingUnlocked();
 }
 
 int GraphEngine::process(juce::AudioBuffer<float>& buffer, const std::uint64_t* hostTimeNs)
@@ -417,6 +839,7 @@ int GraphEngine::process(juce::AudioBuffer<float>& buffer, const std::uint64_t*
 
         const decltype(releaseInFlightCallback)& fn;
     } inFlightScopeExit(releaseInFlightCallback);
+    const RealtimeChecker::Scope realtimeScope;
 
     if (processingSuspended_.load(std::memory_order_acquire))
     {
@@ -424,8 +847,8 @@ int GraphEngine::process(juce::AudioBuffer<float>& buffer, const std::uint64_t*
         return 0;
     }
 
-    auto runtime = runtimeState_.load(std::memory_order_acquire);
-    if (! runtime || runtime->nodes.empty() || ! runtime->hasOutputNode)
+    auto* runtime = liveRuntime_.load(std::memory_order_seq_cst);
+    if (runtime == nullptr || runtime->nodes.empty() || ! runtime->hasOutputNode)
     {
         buffer.clear();
         return 0;
@@ -442,152 +865,659 @@ int GraphEngine::process(juce::AudioBuffer<float>& buffer, const std::uint64_t*
         return 0;
     }
 
-    if (numSamples > runtime->blockSize)
+    // Nodes were prepared for at most blockSize samples. Larger host buffers
+    // run as consecutive sub-blocks so the device callback can hand over its
+    // native buffer size without an extra FIFO; smaller ones run as they are.
+    const bool tailSleepEnabled = tailSleepEnabled_.load(std::memory_order_relaxed);
+    // Every call is timed per node so a deadline miss can name the slowest
+    // one; full statistics only while profiling.
+    const bool profiling = profilingEnabled_.load(std::memory_order_relaxed);
+    const std::uint64_t profileCall = profileCallCounter_.fetch_add(1, std::memory_order_relaxed) + 1;
+    for (int startSample = 0; startSample < numSamples; startSample += runtime->blockSize)
     {
-        buffer.clear();
-        return 0;
+        const int chunkSamples = std::min(runtime->blockSize, numSamples - startSample);
+
+        // Later sub-blocks start after the host timestamp by the samples
+        // already rendered.
+        std::uint64_t chunkTimeNs = 0;
+        const std::uint64_t* chunkTimePtr = hostTimeNs;
+        if (hostTimeNs != nullptr && startSample > 0)
+        {
+            chunkTimeNs = *hostTimeNs
+                        + static_cast<std::uint64_t>(static_cast<double>(startSample) * 1.0e9 / runtime->sampleRate);
+            chunkTimePtr = &chunkTimeNs;
+        }
+
+        if (! processBlock(*runtime, buffer, startSample, chunkSamples, chunkTimePtr,
+                           tailSleepEnabled, profileCall, profiling))
+        {
+            buffer.clear();
+            return 0;
+        }
     }
 
-    std::array<float*, static_cast<size_t>(maxProcessChannels)> inPointers {};
-    std::array<float*, static_cast<size_t>(maxProcessChannels)> outPointers {};
+    const auto slowest = findSlowestNode(*runtime, profileCall);
+    const auto packed = slowest.handle.isValid()
+        ? (static_cast<std::uint64_t>(slowest.handle.index + 1) << 32) | slowest.handle.generation
+        : 0;
+    slowestNodeHandle_.store(packed, std::memory_order_relaxed);
+    slowestNodeNs_.store(slowest.elapsedNs, std::memory_order_relaxed);
 
-    for (auto& runtimeNode : runtime->nodes)
-    {
-        // Resolve the node's actual channel configuration. Nodes reporting 0
-        // are channel-agnostic and inherit the host bus width.
-        int nodeInputs = runtimeNode.node ? runtimeNode.node->inputChannelCount() : 0;
-        int nodeOutputs = runtimeNode.node ? runtimeNode.node->outputChannelCount() : 0;
-        if (nodeInputs <= 0)
-            nodeInputs = numChannels;
-        if (nodeOutputs <= 0)
-            nodeOutputs = numChannels;
-        nodeInputs = std::min(nodeInputs, numChannels);
-        nodeOutputs = std::min(nodeOutputs, numChannels);
-        runtimeNode.numInputChannels = nodeInputs;
-        runtimeNode.numOutputChannels = nodeOutputs;
-
-        runtimeNode.buffer.clear();
-        runtimeNode.inputBuffer.clear();
-
-        // Populate the node's input buffer from upstream sources (or the host
-        // bus for the input node). Sources are summed so parallel paths mix.
-        if (runtimeNode.inputIndices.empty())
-        {
-            if (runtimeNode.receivesHostInput)
-            {
-                for (int ch = 0; ch < nodeInputs; ++ch)
-                {
-                    const auto* source = buffer.getReadPointer(ch);
-                    auto* dest = runtimeNode.inputBuffer.getWritePointer(ch);
-                    if (source != nullptr && dest != nullptr)
-                        juce::FloatVectorOperations::copy(dest, source, numSamples);
-                }
-            }
+    return numSamples;
+}
+
+bool GraphEngine::processBlock(RuntimeState& runtime,
+                               juce::AudioBuffer<float>& buffer,
+                               int startSample,
+                               int numSamples,
+                               const std::uint64_t* hostTimeNs,
+                               bool tailSleepEnabled,
+                               std::uint64_t profileCall,
+                               bool profiling)
+{
+    const int numChannels = buffer.getNumChannels();
+
+    // Host input silence seeds the silence tracking; an idle input (or a
+    // graph fed only by generators) lets whole branches be skipped.
+    bool hostInputSilent = true;
+    for (int ch = 0; ch < numChannels && hostInputSilent; ++ch)
+    {
+        const auto range = juce::FloatVectorOperations::findMinAndMax(buffer.getReadPointer(ch, startSample), numSamples);
+        hostInputSilent = range.getStart() == 0.0f && range.getEnd() == 0.0f;
+    }
+
+    const BlockContext block { buffer, startSample, numChannels, numSamples, hostTimeNs, hostInputSilent,
+                               tailSleepEnabled, profileCall, profiling };
+
+    // Hand the block to the worker pool only when some level of the graph has
+    // independent nodes; a plain chain runs faster without the hand-off.
+    if (runtime.workers != nullptr && runtime.parallel.maxLevelWidth > 1)
+    {
+        processParallel(runtime, block);
+    }
+    else
+    {
+        for (auto& runtimeNode : runtime.nodes)
+            processRuntimeNode(runtime, runtimeNode, block);
+    }
+
+    if (runtime.outputNodeIndex >= runtime.nodes.size())
+        return false;
+
+    const auto& outputNode = runtime.nodes[runtime.outputNodeIndex];
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto* dest = buffer.getWritePointer(ch, startSample);
+        if (dest == nullptr)
+            continue;
+
+        if (! outputNode.outputSilent && ch < outputNode.numOutputChannels)
+        {
+            const auto& outputBuffer = *runtime.bufferPool[static_cast<size_t>(outputNode.outputSlot)];
+            juce::FloatVectorOperations::copy(dest, outputBuffer.getReadPointer(ch), numSamples);
         }
         else
         {
-            for (const auto sourceIndex : runtimeNode.inputIndices)
+            juce::FloatVectorOperations::clear(dest, numSamples);
+        }
+    }
+
+    return true;
+}
+
+void GraphEngine::markInPlaceNodes(RuntimeState& runtime)
+{
+    // A node can take over its source's buffer when that edge is the only
+    // thing either side is connected through: one input, a source nobody else
+    // reads, and the same channel count all the way through, so no summing or
+    // width adaptation is needed. The output node's buffer is read after the
+    // schedule has run and is never handed on.
+    for (size_t i = 0; i < runtime.nodes.size(); ++i)
+    {
+        auto& rn = runtime.nodes[i];
+        rn.inPlace = false;
+
+        if (rn.node == nullptr || ! rn.node->supportsInPlace() || rn.receivesHostInput || rn.inputIndices.size() != 1)
+            continue;
+
+        const auto src = rn.inputIndices.front();
+        const auto& source = runtime.nodes[src];
+        if (source.outputIndices.size() != 1)
+            continue;
+        if (runtime.hasOutputNode && src == runtime.outputNodeIndex)
+            continue;
+        if (source.numOutputChannels != rn.numInputChannels || rn.numInputChannels != rn.numOutputChannels)
+            continue;
+
+        rn.inPlace = true;
+    }
+}
+
+void GraphEngine::assignBufferPool(RuntimeState& runtime, bool respectParallelism, const RuntimeState* previous)
+{
+    // Register-allocation style buffer assignment. Walking the schedule, each
+    // node takes a scratch buffer to gather its inputs into and a buffer for
+    // its output; a node's output is released once its last consumer has run
+    // (immediately, for nodes nobody reads) and the scratch as soon as the
+    // node itself is done. Released buffers are reused best-fit, so a deep
+    // graph runs on a handful of cache-resident buffers instead of two
+    // 64-channel buffers per node.
+    //
+    // In parallel mode "released earlier in the schedule" is not enough: the
+    // consumers of a buffer may still be running on another thread. There a
+    // buffer is only reused by a node that every one of its releasing nodes
+    // is an ancestor of, i.e. that is ordered after them by the DAG itself.
+    struct Slot
+    {
+        int channels = 0;
+        bool inUse = false;
+        std::vector<size_t> releasedBy;
+    };
+
+    const auto nodeCount = runtime.nodes.size();
+    const auto blockBytes = static_cast<std::size_t>(std::max(1, runtime.blockSize)) * sizeof(float);
+
+    std::vector<std::vector<std::uint64_t>> ancestors;
+    if (respectParallelism)
+    {
+        const auto words = (nodeCount + 63) / 64;
+        ancestors.assign(nodeCount, std::vector<std::uint64_t>(words, 0));
+        for (size_t i = 0; i < nodeCount; ++i)
+        {
+            for (const auto src : runtime.nodes[i].inputIndices)
             {
-                if (sourceIndex >= runtime->nodes.size())
-                    continue;
+                for (size_t w = 0; w < words; ++w)
+                    ancestors[i][w] |= ancestors[src][w];
+                ancestors[i][src / 64] |= (std::uint64_t { 1 } << (src % 64));
+            }
+        }
+    }
 
-                const auto& sourceNode = runtime->nodes[sourceIndex];
-                const int sourceChannels = sourceNode.numOutputChannels > 0
-                                                ? sourceNode.numOutputChannels
-                                                : numChannels;
-                const int channelsToMix = std::min(sourceChannels, nodeInputs);
+    const auto isAncestor = [&ancestors](size_t candidate, size_t node)
+    {
+        return (ancestors[node][candidate / 64] >> (candidate % 64)) & 1u;
+    };
 
-                for (int ch = 0; ch < channelsToMix; ++ch)
-                {
-                    const auto* source = sourceNode.buffer.getReadPointer(ch);
-                    auto* dest = runtimeNode.inputBuffer.getWritePointer(ch);
-                    if (source != nullptr && dest != nullptr)
-                        juce::FloatVectorOperations::add(dest, source, numSamples);
-                }
+    std::vector<Slot> slots;
+    std::size_t liveChannels = 0;
+    std::size_t peakLiveChannels = 0;
+
+    const auto acquire = [&](size_t nodeIndex, int channels) -> int
+    {
+        int best = -1;
+        for (size_t b = 0; b < slots.size(); ++b)
+        {
+            const auto& slot = slots[b];
+            if (slot.inUse)
+                continue;
+
+            if (respectParallelism
+                && ! std::all_of(slot.releasedBy.begin(), slot.releasedBy.end(),
+                                 [&](size_t releaser) { return isAncestor(releaser, nodeIndex); }))
+                continue;
+
+            // Best fit: the smallest buffer that is wide enough, otherwise the
+            // widest one available (it grows instead of adding a new buffer).
+            if (best < 0)
+            {
+                best = static_cast<int>(b);
+                continue;
             }
+
+            const auto& current = slots[static_cast<size_t>(best)];
+            const bool fits = slot.channels >= channels;
+            const bool currentFits = current.channels >= channels;
+            if ((fits && (! currentFits || slot.channels < current.channels))
+                || (! fits && ! currentFits && slot.channels > current.channels))
+                best = static_cast<int>(b);
+        }
+
+        if (best < 0)
+        {
+            best = static_cast<int>(slots.size());
+            slots.emplace_back();
         }
 
+        auto& slot = slots[static_cast<size_t>(best)];
+        slot.channels = std::max(slot.channels, channels);
+        slot.inUse = true;
+        slot.releasedBy.clear();
+        liveChannels += static_cast<std::size_t>(channels);
+        peakLiveChannels = std::max(peakLiveChannels, liveChannels);
+        return best;
+    };
+
+    const auto release = [&](int slotIndex, int channels, std::vector<size_t> releasedBy)
+    {
+        auto& slot = slots[static_cast<size_t>(slotIndex)];
+        slot.inUse = false;
+        slot.releasedBy = std::move(releasedBy);
+        liveChannels -= static_cast<std::size_t>(channels);
+    };
+
+    std::vector<size_t> pendingConsumers(nodeCount, 0);
+    for (size_t i = 0; i < nodeCount; ++i)
+        pendingConsumers[i] = runtime.nodes[i].outputIndices.size();
+
+    for (size_t i = 0; i < nodeCount; ++i)
+    {
+        auto& rn = runtime.nodes[i];
+        if (rn.inPlace)
+        {
+            // Ownership of the source's buffer moves to this node; it is
+            // released with this node's output, not the source's.
+            const auto src = rn.inputIndices.front();
+            rn.inputSlot = -1;
+            rn.outputSlot = runtime.nodes[src].outputSlot;
+            --pendingConsumers[src];
+        }
+        else
+        {
+            rn.inputSlot = acquire(i, rn.numInputChannels);
+            rn.outputSlot = acquire(i, rn.numOutputChannels);
+            release(rn.inputSlot, rn.numInputChannels, { i });
+        }
+
+        for (const auto src : rn.inputIndices)
+        {
+            if (rn.inPlace)
+                break;
+
+            if (--pendingConsumers[src] > 0)
+                continue;
+
+            // The output node's buffer is read after the whole schedule has
+            // run, so it is never handed on.
+            if (runtime.hasOutputNode && src == runtime.outputNodeIndex)
+                continue;
+
+            const auto& source = runtime.nodes[src];
+            release(source.outputSlot, source.numOutputChannels, source.outputIndices);
+        }
+
+        if (rn.outputIndices.empty() && ! (runtime.hasOutputNode && i == runtime.outputNodeIndex))
+            release(rn.outputSlot, rn.numOutputChannels, { i });
+    }
+
+    // Adopt the previous runtime's buffers best-fit before allocating. They
+    // may be in use by the live runtime, so an adopted buffer is left exactly
+    // as it is; only newly allocated ones are sized and cleared.
+    std::vector<std::shared_ptr<juce::AudioBuffer<float>>> reusable;
+    if (previous != nullptr && previous->blockSize == runtime.blockSize)
+        reusable = previous->bufferPool;
+
+    runtime.bufferPool.clear();
+    runtime.bufferPool.resize(slots.size());
+
+    auto& stats = runtime.stats;
+    stats = {};
+    stats.numNodes = static_cast<int>(nodeCount);
+    stats.numPooledBuffers = static_cast<int>(slots.size());
+
+    for (size_t b = 0; b < slots.size(); ++b)
+    {
+        const int channels = std::max(1, slots[b].channels);
+
+        auto best = reusable.end();
+        for (auto it = reusable.begin(); it != reusable.end(); ++it)
+        {
+            if ((*it)->getNumChannels() >= channels
+                && (best == reusable.end() || (*it)->getNumChannels() < (*best)->getNumChannels()))
+                best = it;
+        }
+
+        auto& buffer = runtime.bufferPool[b];
+        if (best != reusable.end())
+        {
+            buffer = std::move(*best);
+            reusable.erase(best);
+        }
+        else
+        {
+            buffer = std::make_shared<juce::AudioBuffer<float>>(channels, std::max(1, runtime.blockSize));
+            buffer->clear();
+        }
+
+        stats.pooledBufferBytes += static_cast<std::size_t>(buffer->getNumChannels()) * blockBytes;
+    }
+
+    for (const auto& rn : runtime.nodes)
+    {
+        stats.unpooledBufferBytes += static_cast<std::size_t>(rn.numInputChannels + rn.numOutputChannels) * blockBytes;
+        if (rn.compensationSamples > 0)
+        {
+            ++stats.numPdcDelayLines;
+            stats.pdcDelayBytes += static_cast<std::size_t>(rn.state->pdcDelayBuffer.getNumChannels())
+                                   * static_cast<std::size_t>(rn.state->pdcDelayBuffer.getNumSamples()) * sizeof(float);
+        }
+    }
+
+    stats.peakWorkingSetBytes = peakLiveChannels * blockBytes + stats.pdcDelayBytes;
+}
+
+void GraphEngine::processRuntimeNode(RuntimeState& runtime, RuntimeNode& runtimeNode, const BlockContext& block)
+{
+    // Also marks worker threads, which only enter here.
+    const RealtimeChecker::Scope realtimeScope(runtimeNode.handle);
+    const int numSamples = block.numSamples;
+    const int nodeInputs = runtimeNode.numInputChannels;
+    const int nodeOutputs = runtimeNode.numOutputChannels;
+    auto& state = *runtimeNode.state;
+
+    auto& outputBuffer = *runtime.bufferPool[static_cast<size_t>(runtimeNode.outputSlot)];
+    // In-place nodes find their input already sitting in the output buffer,
+    // written there by the source that owned it before them.
+    auto& inputBuffer = runtimeNode.inPlace
+        ? outputBuffer
+        : *runtime.bufferPool[static_cast<size_t>(runtimeNode.inputSlot)];
+
+    // Pointer tables live on the stack of whichever thread runs the node, so
+    // parallel participants never share them.
+    std::array<float*, static_cast<size_t>(maxProcessChannels)> inPointers {};
+    std::array<float*, static_cast<size_t>(maxProcessChannels)> outPointers {};
+
+    // A silent buffer is never read: its contents are whatever the last
+    // writer left there. The input is silent when every source is.
+    bool inputSilent = true;
+    if (runtimeNode.inPlace)
+    {
+        inputSilent = runtime.nodes[runtimeNode.inputIndices.front()].outputSilent;
+    }
+    else if (runtimeNode.inputIndices.empty())
+    {
+        inputSilent = ! runtimeNode.receivesHostInput || block.hostInputSilent;
+    }
+    else
+    {
+        for (const auto sourceIndex : runtimeNode.inputIndices)
+            inputSilent = inputSilent && runtime.nodes[sourceIndex].outputSilent;
+    }
+
+    // A PDC ring keeps emitting the audio it holds for compensationSamples
+    // after its input goes quiet; only then is the delayed input silent too.
+    const bool pdcActive = runtime.pdcEnabled && runtimeNode.compensationSamples > 0;
+    const bool pdcDrained = ! pdcActive || state.pdcSilentSamples >= runtimeNode.compensationSamples;
+    if (pdcActive)
+    {
+        state.pdcSilentSamples = inputSilent
+            ? std::min(state.pdcSilentSamples + numSamples, runtimeNode.compensationSamples)
+            : 0;
+    }
+
+    const bool settledInput = inputSilent && pdcDrained;
+    const auto silentBefore = static_cast<std::int64_t>(state.silentInputSamples);
+    state.silentInputSamples = settledInput
+        ? static_cast<int>(std::min<std::int64_t>(silentBefore + numSamples, std::numeric_limits<int>::max()))
+        : 0;
+
+    if (settledInput && runtimeNode.node != nullptr)
+    {
+        auto& node = *runtimeNode.node;
+        bool skip = node.isSilentForSilentInput();
+
+        // Tail sleep: everything the node could still emit has come out once
+        // it has been fed silence for its tail plus its own latency.
+        if (! skip && block.tailSleepEnabled)
+        {
+            const int tail = node.tailSamples();
+            skip = tail != Node::kInfiniteTail
+                   && silentBefore >= static_cast<std::int64_t>(tail) + std::max(0, node.latencySamples());
+        }
+
+        if (skip)
+        {
+            // Skipped entirely. Queued parameter edits are still consumed so
+            // they neither pile up in the queue nor land late when audio
+            // returns.
+            node.applyParameterChanges();
+            runtimeNode.outputSilent = true;
+            return;
+        }
+    }
+
+    // Populate the node's input buffer from upstream sources (or the host
+    // bus for the input node). Sources are summed so parallel paths mix; the
+    // first one is copied rather than added so the buffer needs no clear.
+    // Only the channels the node reads are touched.
+    if (inputSilent)
+    {
         for (int ch = 0; ch < nodeInputs; ++ch)
-            inPointers[static_cast<size_t>(ch)] = runtimeNode.inputBuffer.getWritePointer(ch);
-        for (int ch = 0; ch < nodeOutputs; ++ch)
-            outPointers[static_cast<size_t>(ch)] = runtimeNode.buffer.getWritePointer(ch);
-
-        // PDC: if this node sits on a shorter path than the longest chain,
-        // delay its input so it aligns sample-for-sample with the longest
-        // path. The delay line persists across blocks via pdcWritePos.
-        if (runtime->pdcEnabled && runtimeNode.compensationSamples > 0)
-        {
-            const int delay = runtimeNode.compensationSamples;
-            const int chCount = std::min(nodeInputs, runtimeNode.pdcDelayBuffer.getNumChannels());
-           for (int ch = 0; ch < chCount; ++ch)
-           {
-               auto* inputPtr = runtimeNode.inputBuffer.getWritePointer(ch);
-               auto* ring = runtimeNode.pdcDelayBuffer.getWritePointer(ch);
-               int writePos = runtimeNode.pdcWritePos;
-
-               // Push the current block into the ring, pulling out the
-               // samples that fall delay-samples behind.
-                for (int s = 0; s < numSamples; ++s)
-                {
-                    const float delayed = ring[writePos];
-                    ring[writePos] = inputPtr[s];
-                    inputPtr[s] = delayed;
-                    if (++writePos >= delay)
-                        writePos = 0;
-                }
-                runtimeNode.pdcWritePos = writePos;
+            juce::FloatVectorOperations::clear(inputBuffer.getWritePointer(ch), numSamples);
+    }
+    else if (runtimeNode.inPlace)
+    {
+        // Nothing to gather: the single source already wrote this buffer.
+    }
+    else if (runtimeNode.inputIndices.empty())
+    {
+        const int hostChannels = std::min(nodeInputs, block.numChannels);
+        for (int ch = 0; ch < nodeInputs; ++ch)
+        {
+            auto* dest = inputBuffer.getWritePointer(ch);
+            if (ch < hostChannels)
+                juce::FloatVectorOperations::copy(dest, block.hostBuffer.getReadPointer(ch, block.hostStartSample), numSamples);
+            else
+                juce::FloatVectorOperations::clear(dest, numSamples);
+        }
+    }
+    else
+    {
+        bool first = true;
+        for (const auto sourceIndex : runtimeNode.inputIndices)
+        {
+            const auto& sourceNode = runtime.nodes[sourceIndex];
+            if (sourceNode.outputSilent)
+                continue;
+
+            const auto& sourceBuffer = *runtime.bufferPool[static_cast<size_t>(sourceNode.outputSlot)];
+            const int channelsToMix = std::min(sourceNode.numOutputChannels, nodeInputs);
+
+            for (int ch = 0; ch < channelsToMix; ++ch)
+            {
+                auto* dest = inputBuffer.getWritePointer(ch);
+                if (first)
+                    juce::FloatVectorOperations::copy(dest, sourceBuffer.getReadPointer(ch), numSamples);
+                else
+                    juce::FloatVectorOperations::add(dest, sourceBuffer.getReadPointer(ch), numSamples);
+            }
+
+            if (first)
+            {
+                for (int ch = channelsToMix; ch < nodeInputs; ++ch)
+                    juce::FloatVectorOperations::clear(inputBuffer.getWritePointer(ch), numSamples);
+                first = false;
             }
         }
+    }
 
-        ProcessContext context {
-            runtimeNode.buffer,
-            inPointers.data(),
-            outPointers.data(),
-            nodeInputs,
-            nodeOutputs,
-            runtime->sampleRate,
-            runtime->blockSize,
-            numSamples,
-            hostTimeNs
-        };
+    for (int ch = 0; ch < nodeInputs; ++ch)
+        inPointers[static_cast<size_t>(ch)] = inputBuffer.getWritePointer(ch);
+    for (int ch = 0; ch < nodeOutputs; ++ch)
+        outPointers[static_cast<size_t>(ch)] = outputBuffer.getWritePointer(ch);
 
-        if (runtimeNode.node != nullptr)
-            runtimeNode.node->process(context);
+    // PDC: if this node sits on a shorter path than the longest chain,
+    // delay its input so it aligns sample-for-sample with the longest
+    // path. The delay line persists across blocks via pdcWritePos. A drained
+    // ring fed silence holds only zeros, so there is nothing to shift.
+    if (pdcActive && ! (inputSilent && pdcDrained))
+    {
+        const int delay = runtimeNode.compensationSamples;
+        const int chCount = std::min(nodeInputs, state.pdcDelayBuffer.getNumChannels());
+        int writePos = state.pdcWritePos;
+        for (int ch = 0; ch < chCount; ++ch)
+        {
+            auto* inputPtr = inputBuffer.getWritePointer(ch);
+            auto* ring = state.pdcDelayBuffer.getWritePointer(ch);
+            writePos = state.pdcWritePos;
+
+            // Push the current block into the ring, pulling out the
+            // samples that fall delay-samples behind.
+            for (int s = 0; s < numSamples; ++s)
+            {
+                const float delayed = ring[writePos];
+                ring[writePos] = inputPtr[s];
+                inputPtr[s] = delayed;
+                if (++writePos >= delay)
+                    writePos = 0;
+            }
+        }
+        state.pdcWritePos = writePos;
+        inputSilent = false;
     }
 
-    if (runtime->outputNodeIndex >= runtime->nodes.size())
+    ProcessContext context {
+        outputBuffer,
+        inPointers.data(),
+        outPointers.data(),
+        nodeInputs,
+        nodeOutputs,
+        runtime.sampleRate,
+        runtime.blockSize,
+        numSamples,
+        block.hostTimeNs
+    };
+    context.inputSilent = inputSilent;
+
+    if (runtimeNode.node == nullptr)
     {
-        buffer.clear();
-        return 0;
+        context.outputSilent = true;
+    }
+    else if (runtimeNode.profile != nullptr)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        runtimeNode.node->process(context);
+        const auto elapsedNs = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        if (block.profiling)
+            runtimeNode.profile->record(elapsedNs, numSamples, runtime.sampleRate, block.profileCall);
+        else
+            runtimeNode.profile->recordCall(elapsedNs, block.profileCall);
+    }
+    else
+    {
+        runtimeNode.node->process(context);
     }
 
-    const auto& outputBuffer = runtime->nodes[runtime->outputNodeIndex].buffer;
-    for (int ch = 0; ch < numChannels; ++ch)
+    runtimeNode.outputSilent = context.outputSilent;
+}
+
+void GraphEngine::ParallelSchedule::push(size_t nodeIndex) noexcept
+{
+    const auto slot = readyTail.fetch_add(1, std::memory_order_relaxed);
+    readySlots[static_cast<size_t>(slot)].store(static_cast<int>(nodeIndex) + 1, std::memory_order_release);
+}
+
+int GraphEngine::ParallelSchedule::tryPop() noexcept
+{
+    auto head = readyHead.load(std::memory_order_relaxed);
+    if (head >= readyTail.load(std::memory_order_acquire))
+        return -1;
+
+    if (! readyHead.compare_exchange_weak(head, head + 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+        return -1;
+
+    // The slot was reserved by push() before it stored the node; wait out
+    // the few instructions between the two.
+    auto& slot = readySlots[static_cast<size_t>(head)];
+    int value = slot.load(std::memory_order_acquire);
+    while (value == 0)
     {
-        auto* dest = buffer.getWritePointer(ch);
-        const auto* src = outputBuffer.getReadPointer(ch);
-        if (dest == nullptr || src == nullptr)
-            continue;
+        cpuRelax();
+        value = slot.load(std::memory_order_acquire);
+    }
+    return value - 1;
+}
 
-        juce::FloatVectorOperations::copy(dest, src, numSamples);
+void GraphEngine::processParallel(RuntimeState& runtime, const BlockContext& block)
+{
+    auto& parallel = runtime.parallel;
+    const auto nodeCount = runtime.nodes.size();
+
+    // Reset the per-block DAG state. Relaxed stores are published to the
+    // workers by WorkerPool::run() before any of them can look at it.
+    for (size_t i = 0; i < nodeCount; ++i)
+    {
+        parallel.pendingInputs[i].store(static_cast<int>(runtime.nodes[i].inputIndices.size()),
+                                        std::memory_order_relaxed);
+        parallel.readySlots[i].store(0, std::memory_order_relaxed);
     }
+    parallel.readyHead.store(0, std::memory_order_relaxed);
+    parallel.readyTail.store(0, std::memory_order_relaxed);
+    parallel.remaining.store(static_cast<int>(nodeCount), std::memory_order_relaxed);
+
+    for (const auto root : parallel.roots)
+        parallel.push(root);
+
+    ParallelJob job { runtime, block };
+    runtime.workers->run(&GraphEngine::runParallelJob, &job);
+}
+
+void GraphEngine::runParallelJob(void* context, int participantIndex)
+{
+    juce::ignoreUnused(participantIndex);
+
+    auto& job = *static_cast<ParallelJob*>(context);
+    auto& runtime = job.runtime;
+    auto& parallel = runtime.parallel;
+
+    // Every participant, including the device thread, loops until the whole
+    // block is done. The acquire on `remaining` reaching zero is what makes
+    // the output node's buffer visible to the caller for the final copy.
+    while (parallel.remaining.load(std::memory_order_acquire) > 0)
+    {
+        int index = parallel.tryPop();
+        if (index < 0)
+        {
+            cpuRelax();
+            continue;
+        }
+
+        // Follow the chain: the first successor this node makes ready stays
+        // on this thread while its input is still hot in cache; any others
+        // are published for idle participants to steal.
+        while (index >= 0)
+        {
+            auto& runtimeNode = runtime.nodes[static_cast<size_t>(index)];
+            processRuntimeNode(runtime, runtimeNode, job.block);
+
+            int next = -1;
+            for (const auto target : runtimeNode.outputIndices)
+            {
+                if (parallel.pendingInputs[target].fetch_sub(1, std::memory_order_acq_rel) != 1)
+                    continue;
+
+                if (next < 0)
+                    next = static_cast<int>(target);
+                else
+                    parallel.push(target);
+            }
 
-    return buffer.getNumSamples();
+            parallel.remaining.fetch_sub(1, std::memory_order_acq_rel);
+            index = next;
+        }
+    }
 }
 
 std::vector<GraphEngine::NodeId> GraphEngine::getSchedule() const
 {
     std::lock_guard<std::mutex> lock(mutex_);
-    return schedule_;
+    std::vector<NodeId> ids;
+    ids.reserve(schedule_.size());
+    for (const auto index : schedule_)
+        ids.push_back(slots_[index].id);
+    return ids;
 }
 
 std::vector<GraphEngine::NodeId> GraphEngine::getNodeIds() const
 {
     std::lock_guard<std::mutex> lock(mutex_);
     std::vector<NodeId> ids;
-    ids.reserve(nodes_.size());
-    for (const auto& entry : nodes_)
-        ids.push_back(entry.id);
+    ids.reserve(numNodes_);
+    for (const auto& slot : slots_)
+    {
+        if (slot.occupied)
+            ids.push_back(slot.id);
+    }
     return ids;
 }
 
@@ -595,10 +1525,10 @@ std::vector<std::pair<GraphEngine::NodeId, GraphEngine::NodeId>> GraphEngine::ge
 {
     std::lock_guard<std::mutex> lock(mutex_);
     std::vector<std::pair<NodeId, NodeId>> connections;
-    for (const auto& node : nodes_)
+    for (const auto& slot : slots_)
     {
-        for (const auto& target : node.outputs)
-            connections.emplace_back(node.id, target);
+        for (const auto target : slot.outputs)
+            connections.emplace_back(slot.id, slots_[target].id);
     }
     return connections;
 }
@@ -606,100 +1536,79 @@ std::vector<std::pair<GraphEngine::NodeId, GraphEngine::NodeId>> GraphEngine::ge
 GraphEngine::NodeId GraphEngine::getInputNode() const
 {
     std::lock_guard<std::mutex> lock(mutex_);
-    return inputNode_;
+    const auto* slot = resolveUnlocked(inputNode_);
+    return slot != nullptr ? slot->id : NodeId::null();
 }
 
 GraphEngine::NodeId GraphEngine::getOutputNode() const
 {
     std::lock_guard<std::mutex> lock(mutex_);
-    return outputNode_;
+    const auto* slot = resolveUnlocked(outputNode_);
+    return slot != nullptr ? slot->id : NodeId::null();
 }
 
-std::shared_ptr<Node> GraphEngine::getNodeUnlocked(const NodeId& id) const
+GraphEngine::RuntimeStats GraphEngine::getRuntimeStats() const
 {
-    const auto key = toKey(id);
-    const auto it = indexById_.find(key);
-    if (it == indexById_.end())
-        return {};
-
-    const auto idx = it->second;
-    if (idx >= nodes_.size())
-        return {};
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ownedRuntime_ != nullptr ? ownedRuntime_->stats : RuntimeStats {};
+}
 
-    return nodes_[idx].node;
+GraphEngine::NodeHandle GraphEngine::findHandleUnlocked(const NodeId& id) const
+{
+    const auto it = handleById_.find(id);
+    return it != handleById_.end() ? it->second : NodeHandle {};
 }
 
-bool GraphEngine::hasNodeUnlocked(const NodeId& id) const
+const GraphEngine::NodeSlot* GraphEngine::resolveUnlocked(NodeHandle handle) const
 {
-    const auto key = toKey(id);
-    return indexById_.find(key) != indexById_.end();
+    if (handle.index >= slots_.size())
+        return nullptr;
+
+    const auto& slot = slots_[handle.index];
+    return slot.occupied && slot.generation == handle.generation ? &slot : nullptr;
 }
 
 void GraphEngine::buildScheduleUnlocked()
 {
+    // Kahn's algorithm straight over the slot table and its adjacency lists:
+    // O(V + E), no lookups.
     schedule_.clear();
 
-    if (nodes_.empty())
+    if (numNodes_ == 0)
         return;
 
-    const size_t nodeCount = nodes_.size();
-    std::vector<int> indegree(nodeCount, 0);
-
-    for (const auto& entry : nodes_)
+    const auto slotCount = slots_.size();
+    std::vector<std::uint32_t> indegree(slotCount, 0);
+    std::queue<std::uint32_t> ready;
+    for (std::uint32_t i = 0; i < slotCount; ++i)
     {
-        for (const auto& targetId : entry.outputs)
-        {
-            const auto key = toKey(targetId);
-            const auto targetIt = indexById_.find(key);
-            if (targetIt == indexById_.end())
-                throw std::runtime_error("GraphEngine::prepare: connection references unknown node");
-
-            const auto targetIdx = targetIt->second;
-            if (targetIdx >= nodeCount)
-                throw std::runtime_error("GraphEngine::prepare: connection index out of range");
-
-            ++indegree[targetIdx];
-        }
-    }
+        if (! slots_[i].occupied)
+            continue;
 
-    std::queue<size_t> ready;
-    for (size_t i = 0; i < nodeCount; ++i)
-    {
+        indegree[i] = static_cast<std::uint32_t>(slots_[i].inputs.size());
         if (indegree[i] == 0)
             ready.push(i);
     }
 
-    std::vector<size_t> order;
-    order.reserve(nodeCount);
+    schedule_.reserve(numNodes_);
 
     while (! ready.empty())
     {
-        const auto idx = ready.front();
+        const auto index = ready.front();
         ready.pop();
-        order.push_back(idx);
+        schedule_.push_back(index);
 
-        for (const auto& targetId : nodes_[idx].outputs)
+        for (const auto target : slots_[index].outputs)
         {
-            const auto targetKey = toKey(targetId);
-            const auto targetIt = indexById_.find(targetKey);
-            if (targetIt == indexById_.end())
-                continue;
-
-            const auto targetIdx = targetIt->second;
-            if (indegree[targetIdx] <= 0)
-                continue;
-
-            --indegree[targetIdx];
-            if (indegree[targetIdx] == 0)
-                ready.push(targetIdx);
+            if (--indegree[target] == 0)
+                ready.push(target);
         }
     }
 
-    if (order.size() != nodeCount)
+    if (schedule_.size() != numNodes_)
+    {
+        schedule_.clear();
         throw std::runtime_error("GraphEngine::prepare: graph contains a cycle");
-
-    schedule_.reserve(nodeCount);
-    for (const auto idx : order)
-        schedule_.push_back(nodes_[idx].id);
+    }
 }
 } // namespace host::graph
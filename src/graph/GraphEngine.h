@@ -4,8 +4,11 @@
 
 #include <juce_core/juce_core.h>
 
+#include <array>
 #include <atomic>
 #include <condition_variable>
+#include <cstdint>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -16,11 +19,69 @@
 
 namespace host::graph
 {
+class WorkerPool;
+
 class GraphEngine
 {
 public:
     using NodeId = juce::Uuid;
 
+    /// Dense, generational reference to a node. The index addresses the
+    /// engine's node table directly and the generation is bumped whenever a
+    /// slot is freed, so a handle to a removed node never resolves to the
+    /// node that later reuses its slot. NodeId (a UUID) remains the stable
+    /// identity for projects and presets; handles are only valid for the
+    /// lifetime of this engine.
+    struct NodeHandle
+    {
+        static constexpr std::uint32_t invalidIndex = std::numeric_limits<std::uint32_t>::max();
+
+        std::uint32_t index = invalidIndex;
+        std::uint32_t generation = 0;
+
+        [[nodiscard]] bool isValid() const noexcept { return index != invalidIndex; }
+        bool operator==(const NodeHandle&) const = default;
+    };
+
+    /// Memory footprint of the prepared runtime, so the effect of buffer
+    /// pooling on the per-block working set can be checked from the UI/logs.
+    struct RuntimeStats
+    {
+        int numNodes = 0;
+        int numPooledBuffers = 0;
+        int numPdcDelayLines = 0;
+        std::size_t pooledBufferBytes = 0;   ///< All pool buffers together
+        std::size_t pdcDelayBytes = 0;       ///< All PDC delay rings together
+        std::size_t peakWorkingSetBytes = 0; ///< Most buffer memory live at one point of the schedule, plus PDC rings
+        std::size_t unpooledBufferBytes = 0; ///< Two private buffers per node at the same channel widths
+        int numPreparedNodes = 0;            ///< Nodes the last prepare() had to call Node::prepare() on
+        int numCarriedOverNodes = 0;         ///< Nodes whose PDC ring and sleep state survived it
+        int latencySamples = 0;              ///< Input-to-output latency at the output node, PDC included
+    };
+
+    /// CPU time one node spent in process(), accumulated while profiling is
+    /// enabled (see setProfilingEnabled). Load figures relate the time to the
+    /// real-time duration of the blocks the node processed.
+    struct NodeTiming
+    {
+        NodeId id;
+        double lastUs = 0.0;
+        double meanUs = 0.0;
+        double p99Us = 0.0;          ///< From a log-spaced histogram (~19% bucket width)
+        double maxUs = 0.0;
+        double lastLoadPercent = 0.0; ///< Last call as a share of its block's duration
+        double meanLoadPercent = 0.0; ///< Total time over total audio duration processed
+        std::uint64_t calls = 0;
+    };
+
+    /// Node that took the longest in the most recent profiled process()
+    /// call, sub-blocks summed. Invalid handle when profiling is off.
+    struct SlowestNode
+    {
+        NodeHandle handle;
+        std::uint64_t elapsedNs = 0;
+    };
+
     GraphEngine() = default;
     ~GraphEngine() = default;
 
@@ -37,19 +98,76 @@ public:
     [[nodiscard]] std::shared_ptr<Node> getNode(const NodeId& id) const;
     void removeNode(NodeId id);
 
+    /// Handle for a node id; invalid when the id is unknown. The NodeId
+    /// overloads below resolve through this same hash lookup.
+    [[nodiscard]] NodeHandle findHandle(const NodeId& id) const;
+    /// Null when the handle is stale.
+    [[nodiscard]] NodeId getNodeId(NodeHandle handle) const;
+    [[nodiscard]] std::shared_ptr<Node> getNode(NodeHandle handle) const;
+    void removeNode(NodeHandle handle);
+
     void setIO(NodeId inputNode, NodeId outputNode);
     void connect(NodeId from, NodeId to);
     void disconnect(NodeId from, NodeId to);
+    void connect(NodeHandle from, NodeHandle to);
+    void disconnect(NodeHandle from, NodeHandle to);
 
     void setEngineFormat(double sampleRate, int blockSize);
+    /// Host bus width the runtime is prepared for. Channel-agnostic nodes run
+    /// at this width and node buffers are sized from it, so it should match
+    /// the buffers later passed to process(). Survives clear().
+    void setBusChannels(int numChannels);
+    /// Build a runtime for the current graph and swap it in at the next block
+    /// boundary. Graph edits and format/PDC/worker settings only take effect
+    /// here; until then the previous runtime keeps playing, so editing a
+    /// running graph does not interrupt the audio. Only nodes new to the
+    /// graph are prepared, unless the sample rate or block size changed.
     void prepare();
     /// Enable/disable Plugin Delay Compensation. When enabled (default) the
     /// runtime inserts delay lines so every path stays aligned with the
     /// longest-latency chain. Disabled = low-latency passthrough, paths drift.
     void setPdcEnabled(bool enabled);
+    /// Number of realtime worker threads used to run independent branches of
+    /// the graph in parallel. 0 (default) processes the schedule serially on
+    /// the calling device thread. Clamped to the available cores minus one;
+    /// takes effect on the next prepare().
+    void setWorkerCount(int numWorkers);
+    [[nodiscard]] int getWorkerCount() const;
+    /// Tail sleep: stop calling process() on a node once its input has been
+    /// silent for longer than its tailSamples() plus latency, and wake it on
+    /// the next non-silent block. Off by default because it trusts the tail
+    /// each node (or hosted plug-in) reports: a plug-in that under-reports is
+    /// cut off mid-tail. A plug-in reporting zero counts as an infinite tail
+    /// unless it declares it has none. Takes effect immediately.
+    void setTailSleepEnabled(bool enabled) noexcept;
+    [[nodiscard]] bool isTailSleepEnabled() const noexcept;
+    /// Tell every node (and nodes added later) whether the graph is rendered
+    /// offline rather than by a device. Call before prepare(); hosted
+    /// plug-ins only pick the mode up when they are prepared.
+    void setNonRealtime(bool isNonRealtime);
+    [[nodiscard]] bool isNonRealtime() const;
+    /// Accumulate the time of every Node::process() call per node. Off by
+    /// default. Each call is timed with steady_clock either way, for
+    /// getSlowestNode(); this only adds the statistics. Takes effect
+    /// immediately.
+    void setProfilingEnabled(bool enabled) noexcept;
+    [[nodiscard]] bool isProfilingEnabled() const noexcept;
+    /// Message thread: timings for every node that has been profiled since
+    /// it was added or since the last resetNodeTimings().
+    [[nodiscard]] std::vector<NodeTiming> getNodeTimings() const;
+    void resetNodeTimings();
+    /// Lock-free and safe on the audio thread, so a caller can attribute a
+    /// late callback to the node that cost the most in it. Tracked whether
+    /// or not profiling is enabled.
+    [[nodiscard]] SlowestNode getSlowestNode() const noexcept;
     // hostTimeNs optional: when provided by the device callback (ASIO), it is
     // forwarded into each node's ProcessContext so time-aware plugins stay in
     // sync with the audio hardware clock.
+    //
+    // Any buffer length is accepted: buffers up to the prepared block size run
+    // as one variable-size block, longer ones are split into blockSize
+    // sub-blocks (with hostTimeNs advanced for each). Returns the number of
+    // samples rendered, or 0 (with the buffer cleared) when nothing is live.
     [[nodiscard]] int process(juce::AudioBuffer<float>& buffer, const std::uint64_t* hostTimeNs = nullptr);
 
     [[nodiscard]] std::vector<NodeId> getSchedule() const;
@@ -57,70 +175,229 @@ public:
     [[nodiscard]] std::vector<std::pair<NodeId, NodeId>> getConnections() const;
     [[nodiscard]] NodeId getInputNode() const;
     [[nodiscard]] NodeId getOutputNode() const;
+    [[nodiscard]] RuntimeStats getRuntimeStats() const;
 
 private:
+    // Per-node state that has to survive a runtime swap: the PDC ring and the
+    // silence counters. Shared by consecutive runtimes while the node and its
+    // compensation are unchanged, so an edit elsewhere in the graph neither
+    // drops the audio held in the ring nor wakes a sleeping node. Runtimes
+    // never process concurrently, so sharing needs no synchronisation.
+    struct NodeState
+    {
+        juce::AudioBuffer<float> pdcDelayBuffer;
+        int pdcWritePos { 0 };
+        // Consecutive silent input samples fed to the ring, capped at the
+        // compensation (= the ring holds nothing but zeros).
+        int pdcSilentSamples { 0 };
+        // Consecutive silent samples the node has been fed (after PDC),
+        // saturating. Drives tail sleep.
+        int silentInputSamples { 0 };
+    };
+
+    // Lock-free timing accumulator for one node. Only the thread running the
+    // node writes it (once per block), so plain relaxed stores suffice; the
+    // message thread reads whatever is there. Owned by the node's slot and
+    // shared with every runtime that plays the node, so it survives swaps.
+    struct NodeProfile
+    {
+        // Four buckets per octave of nanoseconds, up to 2^40 ns.
+        static constexpr int kHistogramBuckets = 160;
+
+        std::atomic<std::uint64_t> lastNs { 0 };
+        std::atomic<std::uint64_t> lastBudgetNs { 0 };
+        std::atomic<std::uint64_t> totalNs { 0 };
+        std::atomic<std::uint64_t> totalSamples { 0 };
+        std::atomic<std::uint64_t> calls { 0 };
+        std::atomic<std::uint64_t> maxNs { 0 };
+        // Time spent in the process() call stamped lastCall, sub-blocks summed.
+        std::atomic<std::uint64_t> lastCall { 0 };
+        std::atomic<std::uint64_t> callNs { 0 };
+        std::array<std::atomic<std::uint32_t>, kHistogramBuckets> histogram {};
+
+        void record(std::uint64_t elapsedNs, int numSamples, double sampleRate, std::uint64_t call) noexcept;
+        /// Only the per-call time getSlowestNode() needs.
+        void recordCall(std::uint64_t elapsedNs, std::uint64_t call) noexcept;
+        void reset() noexcept;
+        [[nodiscard]] static int bucketFor(std::uint64_t ns) noexcept;
+        [[nodiscard]] static std::uint64_t bucketUpperBoundNs(int bucket) noexcept;
+    };
+
     struct RuntimeNode
     {
         NodeId id;
+        NodeHandle handle;
         std::shared_ptr<Node> node;
         std::vector<size_t> inputIndices;
-        juce::AudioBuffer<float> buffer;
-        juce::AudioBuffer<float> inputBuffer;
+        std::vector<size_t> outputIndices;
+        // Indices into RuntimeState::bufferPool. A pool buffer is shared by
+        // every node whose lifetime does not overlap (see assignBufferPool).
+        int outputSlot = -1;
+        int inputSlot = -1;
         // PDC delay line: compensationSamples < 0 means "this node sits on the
         // longest path" and introduces no delay; > 0 means earlier paths are
         // delayed by that many samples to realign with the longest chain.
-        juce::AudioBuffer<float> pdcDelayBuffer;
-        int pdcWritePos { 0 };
         int compensationSamples { 0 };
+        std::shared_ptr<NodeState> state;
+        std::shared_ptr<NodeProfile> profile;
         bool receivesHostInput = false;
+        // Runs directly on its single source's output buffer (outputSlot is
+        // the source's, inputSlot unused). See markInPlaceNodes.
+        bool inPlace = false;
+        // Set each block: the output buffer holds silence and is not read
+        // (its contents are stale). Written by the thread that ran the node
+        // and read by its consumers, which the schedule orders after it.
+        bool outputSilent = false;
+        // Resolved in prepare(): the node's reported bus width, or the host
+        // bus width for channel-agnostic nodes.
         int numInputChannels = 0;
         int numOutputChannels = 0;
     };
 
+    // Ready-count DAG used by the parallel path. pendingInputs[i] counts the
+    // upstream nodes of node i that have not finished in the current block;
+    // whoever drops it to zero owns running node i. Nodes that are not picked
+    // up directly by the finishing thread go to readySlots, a per-block
+    // append-only list that idle participants steal from.
+    struct ParallelSchedule
+    {
+        std::unique_ptr<std::atomic<int>[]> pendingInputs;
+        std::unique_ptr<std::atomic<int>[]> readySlots;
+        std::atomic<int> readyHead { 0 };
+        std::atomic<int> readyTail { 0 };
+        std::atomic<int> remaining { 0 };
+        std::vector<size_t> roots;
+        // Widest dependency level. 1 means the graph is a single chain and
+        // gains nothing from the workers.
+        int maxLevelWidth = 0;
+
+        void push(size_t nodeIndex) noexcept;
+        [[nodiscard]] int tryPop() noexcept;
+    };
+
     struct RuntimeState
     {
         std::vector<RuntimeNode> nodes;
-        std::unordered_map<std::string, size_t> indexByNodeId;
+        // Runtime node index per engine slot, -1 for slots not in this
+        // runtime (free, or added since it was built).
+        std::vector<int> indexBySlot;
         size_t outputNodeIndex = 0;
         bool hasOutputNode = false;
         double sampleRate = 0.0;
+        bool nonRealtime = false;
         int blockSize = 0;
+        int numChannels = 0;
+        // Pool buffers hold no state between blocks, so the next runtime
+        // adopts them instead of allocating its own.
+        std::vector<std::shared_ptr<juce::AudioBuffer<float>>> bufferPool;
+        RuntimeStats stats;
         bool pdcEnabled = true;
+        ParallelSchedule parallel;
+        std::shared_ptr<WorkerPool> workers;
+    };
+
+    struct BlockContext
+    {
+        juce::AudioBuffer<float>& hostBuffer;
+        int hostStartSample = 0;
+        int numChannels = 0;
+        int numSamples = 0;
+        const std::uint64_t* hostTimeNs = nullptr;
+        bool hostInputSilent = false;
+        bool tailSleepEnabled = false;
+        std::uint64_t profileCall = 0; ///< Stamp of the timed process() call
+        bool profiling = false;        ///< Accumulate full per-node statistics too
+    };
+
+    struct ParallelJob
+    {
+        RuntimeState& runtime;
+        const BlockContext& block;
     };
 
-    struct NodeEntry
+    // One entry of the node table. Edges are kept in both directions as slot
+    // indices, in connection order, so scheduling and unlinking never search.
+    struct NodeSlot
     {
         NodeId id;
         std::shared_ptr<Node> node;
-        std::vector<NodeId> outputs;
+        std::shared_ptr<NodeProfile> profile;
+        std::vector<std::uint32_t> outputs;
+        std::vector<std::uint32_t> inputs;
+        std::uint32_t generation = 0;
+        bool occupied = false;
+    };
+
+    // Declared before the lock in methods that publish, so
+    // reclaimRetiredRuntimes() runs once mutex_ has been released.
+    struct DeferredReclaim
+    {
+        GraphEngine& engine;
+        ~DeferredReclaim() { engine.reclaimRetiredRuntimes(); }
     };
 
-    [[nodiscard]] static std::string toKey(const NodeId& id);
-    [[nodiscard]] std::shared_ptr<Node> getNodeUnlocked(const NodeId& id) const;
-    [[nodiscard]] bool hasNodeUnlocked(const NodeId& id) const;
+    static void eraseValue(std::vector<std::uint32_t>& values, std::uint32_t value);
+    [[nodiscard]] NodeHandle findHandleUnlocked(const NodeId& id) const;
+    [[nodiscard]] const NodeSlot* resolveUnlocked(NodeHandle handle) const;
     NodeId addNodeUnlocked(std::unique_ptr<Node> node, std::optional<NodeId> requestedId);
-    void invalidateRuntimeUnlocked();
+    void removeNodeUnlocked(NodeHandle handle);
+    void connectUnlocked(NodeHandle from, NodeHandle to);
+    void disconnectUnlocked(NodeHandle from, NodeHandle to);
+    void publishRuntimeUnlocked(std::shared_ptr<RuntimeState> next);
+    void reclaimRetiredRuntimes();
     void suspendProcessingAndDrainUnlocked();
     void resumeProcessingUnlocked();
     void waitForInFlightCallbacks() const;
     void buildScheduleUnlocked();
+    static void markInPlaceNodes(RuntimeState& runtime);
+    static void assignBufferPool(RuntimeState& runtime, bool respectParallelism, const RuntimeState* previous);
+    static bool processBlock(RuntimeState& runtime,
+                             juce::AudioBuffer<float>& buffer,
+                             int startSample,
+                             int numSamples,
+                             const std::uint64_t* hostTimeNs,
+                             bool tailSleepEnabled,
+                             std::uint64_t profileCall,
+                             bool profiling);
+    static SlowestNode findSlowestNode(const RuntimeState& runtime, std::uint64_t profileCall) noexcept;
+    static void processRuntimeNode(RuntimeState& runtime, RuntimeNode& runtimeNode, const BlockContext& block);
+    static void processParallel(RuntimeState& runtime, const BlockContext& block);
+    static void runParallelJob(void* context, int participantIndex);
 
     mutable std::mutex mutex_;
-    std::vector<NodeEntry> nodes_;
-    std::unordered_map<std::string, size_t> indexById_;
-    std::vector<NodeId> schedule_;
+    std::vector<NodeSlot> slots_;
+    std::vector<std::uint32_t> freeSlots_;
+    std::unordered_map<NodeId, NodeHandle> handleById_;
+    std::size_t numNodes_ = 0;
+    // Slot indices in topological order.
+    std::vector<std::uint32_t> schedule_;
 
-    NodeId inputNode_;
-    NodeId outputNode_;
+    NodeHandle inputNode_;
+    NodeHandle outputNode_;
 
     double sampleRate_ = 0.0;
     int blockSize_ = 0;
+    int busChannels_ = 2;
     bool pdcEnabled_ = true;
+    bool nonRealtime_ = false;
+    std::shared_ptr<WorkerPool> workerPool_;
 
+    std::atomic<bool> tailSleepEnabled_ { false };
+    std::atomic<bool> profilingEnabled_ { false };
+    std::atomic<std::uint64_t> profileCallCounter_ { 0 };
+    std::atomic<std::uint64_t> slowestNodeHandle_ { 0 }; // index << 32 | generation
+    std::atomic<std::uint64_t> slowestNodeNs_ { 0 };
     std::atomic<bool> processingSuspended_ { false };
     std::atomic<int> inFlightProcessCallbacks_ { 0 };
     mutable std::mutex inFlightCallbackMutex_;
     mutable std::condition_variable inFlightCallbackCv_;
-    std::atomic<std::shared_ptr<RuntimeState>> runtimeState_ { nullptr };
+    // Copy-on-write runtime. prepare() builds a new state while the live one
+    // keeps playing and swaps liveRuntime_ at a block boundary. The message
+    // thread owns every state; ones the audio thread may still be reading
+    // sit in retiredRuntimes_ until a gap between callbacks, so nothing is
+    // ever freed on the audio thread.
+    std::atomic<RuntimeState*> liveRuntime_ { nullptr };
+    std::shared_ptr<RuntimeState> ownedRuntime_;
+    std::vector<std::shared_ptr<RuntimeState>> retiredRuntimes_;
 };
 } // namespace host::graph
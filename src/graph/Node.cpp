@@ -23,4 +23,18 @@ void Node::requestParameterChange(const std::string& id, double value)
     if (found)
         setParameters(params);
 }
+
+void Node::requestTextParameterChange(const std::string& id, const std::string& text)
+{
+    auto params = getParameters();
+    for (auto& p : params)
+    {
+        if (p.id == id && p.isText)
+        {
+            p.text = text;
+            setParameters(params);
+            return;
+        }
+    }
+}
 } // namespace host::graph
\ No newline at end of file
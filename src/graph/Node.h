@@ -2,6 +2,7 @@
 
 #include <juce_audio_basics/juce_audio_basics.h>
 
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -21,6 +22,13 @@ struct NodeParameter
     double max { 1.0 };
     double defaultValue { 0.0 };
     bool automatable { false };
+    /// Text parameters (e.g. a file path) carry their value in `text` and
+    /// ignore the numeric fields.
+    bool isText { false };
+    std::string text;
+    /// Only read when the node is prepared (e.g. a latency), so it is saved
+    /// and restored but left out of the live parameter panel.
+    bool loadTimeOnly { false };
 };
 
 struct ProcessContext
@@ -37,14 +45,25 @@ struct ProcessContext
     // callback. nullptr when the device does not supply one. Forwarded to VST
     // plug-ins so time-aware effects (delays, sync) stay sample-accurate.
     const std::uint64_t* hostTimeNs = nullptr;
+    // Every input channel is exactly zero this block. Informational: the node
+    // still writes its outputs as usual.
+    bool inputSilent = false;
+    // Set by the node when its output is silence. Downstream nodes then skip
+    // reading the output channels, so the node need not write them.
+    bool outputSilent = false;
 };
 
 class Node
 {
 public:
+    /// tailSamples() value for nodes whose output may never die away.
+    static constexpr int kInfiniteTail = std::numeric_limits<int>::max();
+
     virtual ~Node() = default;
 
     virtual void prepare(double sampleRate, int blockSize) = 0;
+    // Output channels are not cleared beforehand: process() writes every one
+    // of them, or sets context.outputSilent.
     virtual void process(ProcessContext& context) = 0;
     virtual int latencySamples() const { return 0; }
     virtual std::string name() const = 0;
@@ -55,6 +74,33 @@ public:
     virtual int inputChannelCount() const { return 0; }
     virtual int outputChannelCount() const { return 0; }
 
+    /// True when process() stays correct with inputChannels[ch] ==
+    /// outputChannels[ch], i.e. every output sample is computed from the input
+    /// sample at the same channel and index before it is overwritten. The
+    /// engine then runs the node directly on its source's buffer instead of
+    /// gathering into a scratch buffer first. Default: false.
+    virtual bool supportsInPlace() const { return false; }
+
+    /// Audio thread, asked instead of process() when the whole input block is
+    /// silent. Returning true promises process() would produce nothing but
+    /// silence, so the engine skips it (applyParameterChanges() still runs)
+    /// and downstream nodes treat the output as silent. Nodes with internal
+    /// state such as filters must only answer true once that has settled.
+    /// Default: false.
+    virtual bool isSilentForSilentInput() const { return false; }
+
+    /// How many samples the output can keep ringing after the input goes
+    /// silent (reverb decay, delay repeats), not counting latencySamples().
+    /// With tail sleep enabled the engine stops calling process() once the
+    /// input has been silent for longer than this, and wakes the node on the
+    /// first non-silent block. Default: kInfiniteTail, i.e. never sleeps.
+    virtual int tailSamples() const { return kInfiniteTail; }
+
+    /// Message thread, before prepare(): the graph is about to be rendered
+    /// offline, faster or slower than real time. Nodes wrapping code that
+    /// cares (hosted plug-ins) pass it on. Default: no-op.
+    virtual void setNonRealtime(bool isNonRealtime) { juce::ignoreUnused(isNonRealtime); }
+
     /// Node type tag used for factory instantiation and persistence. Stable
     /// across versions; changing it breaks saved projects.
     virtual std::string typeId() const { return name(); }
@@ -73,6 +119,10 @@ public:
     /// straight through to setParameters for nodes that don't opt into ramping.
     virtual void requestParameterChange(const std::string& id, double value);
 
+    /// requestParameterChange for text parameters. Default impl writes straight
+    /// through to setParameters.
+    virtual void requestTextParameterChange(const std::string& id, const std::string& text);
+
     /// Called by the audio thread at the top of process() to drain pending
     /// parameter changes. Effect nodes override this to pull values from the
     /// queue into smoothed targets. Default: no-op.
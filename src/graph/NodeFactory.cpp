@@ -4,8 +4,10 @@
 #include "graph/Nodes/AudioOut.h"
 #include "graph/Nodes/GainNode.h"
 #include "graph/Nodes/EqualizerNode.h"
+#include "graph/Nodes/LinearPhaseEqNode.h"
 #include "graph/Nodes/CompressorNode.h"
 #include "graph/Nodes/ReverbNode.h"
+#include "graph/Nodes/ConvolutionReverbNode.h"
 #include "graph/Nodes/DelayNode.h"
 #include "graph/Nodes/Merge.h"
 #include "graph/Nodes/Mix.h"
@@ -34,8 +36,10 @@ namespace
             { "AudioOut", "Audio Out", "Routing", 2, 0 },
             { "Gain",     "Gain",      "Effects", 2, 2 },
             { "Equalizer","Equalizer", "Effects", 2, 2 },
+            { "LinearPhaseEQ","Linear Phase EQ","Effects", 2, 2 },
             { "Compressor","Compressor","Effects", 2, 2 },
             { "Reverb",   "Reverb",    "Effects", 2, 2 },
+            { "ConvolutionReverb","Convolution Reverb","Effects", 2, 2 },
             { "Delay",    "Delay",     "Effects", 2, 2 },
             { "Mix",      "Mix",       "Routing", 2, 2 },
             { "Split",    "Split",     "Routing", 2, 2 },
@@ -63,10 +67,14 @@ std::unique_ptr<Node> NodeFactory::create(const std::string& typeId)
         return std::make_unique<nodes::GainNode>();
     if (n == "equalizer" || n == "eq")
         return std::make_unique<nodes::EqualizerNode>();
+    if (n == "linearphaseeq" || n == "linearphaseequalizer")
+        return std::make_unique<nodes::LinearPhaseEqNode>();
     if (n == "compressor" || n == "comp")
         return std::make_unique<nodes::CompressorNode>();
     if (n == "reverb")
         return std::make_unique<nodes::ReverbNode>();
+    if (n == "convolutionreverb" || n == "convolution")
+        return std::make_unique<nodes::ConvolutionReverbNode>();
     if (n == "delay")
         return std::make_unique<nodes::DelayNode>();
     if (n == "mix")
@@ -41,5 +41,6 @@ namespace host::graph::nodes
         }
 
         std::string name() const override { return "Audio In"; }
+        bool isSilentForSilentInput() const override { return true; }
     };
 }
@@ -40,5 +40,6 @@ namespace host::graph::nodes
         }
 
         std::string name() const override { return "Audio Out"; }
+        bool isSilentForSilentInput() const override { return true; }
     };
 }
@@ -61,6 +61,7 @@ namespace host::graph::nodes
         std::string name() const override { return "Channel Tap"; }
 
         std::string typeId() const override { return "ChannelTap"; }
+        bool isSilentForSilentInput() const override { return true; }
 
         std::vector<NodeParameter> getParameters() const override
         {
@@ -32,7 +32,7 @@ namespace host::graph::nodes
         for (auto& c : perChannelCompressors_)
             c.prepare(monoSpec);
         queue_.prepare(static_cast<int>(kParamIds.size()) * 2);
-        drained_.reserve(kParamIds.size() * 2);
+        drained_.reserve(queue_.capacity());
         applyConfig();
     }
 
@@ -62,10 +62,10 @@ namespace host::graph::nodes
                 ? ctx.inputChannels[ch % inputs]
                 : nullptr;
 
-            if (src != nullptr)
-                juce::FloatVectorOperations::copy(dest, src, frames);
-            else
+            if (src == nullptr)
                 juce::FloatVectorOperations::clear(dest, frames);
+            else if (src != dest)
+                juce::FloatVectorOperations::copy(dest, src, frames);
         }
 
         if (stereoLink_.load())
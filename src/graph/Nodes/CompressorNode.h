@@ -20,6 +20,9 @@ public:
     void process(ProcessContext& ctx) override;
     std::string name() const override { return "Compressor"; }
     std::string typeId() const override { return "Compressor"; }
+    bool supportsInPlace() const override { return true; }
+    // Gain reduction only scales the input, so silence in is silence out.
+    int tailSamples() const override { return 0; }
     std::vector<NodeParameter> getParameters() const override;
     void setParameters(const std::vector<NodeParameter>& parameters) override;
     void requestParameterChange(const std::string& id, double value) override;
@@ -0,0 +1,779 @@
+#include "graph/Nodes/ConvolutionReverbNode.h"
+
+#include "audio/PolyphaseResampler.h"
+#include "graph/BackgroundRebuild.h"
+#include "graph/WorkerPool.h"
+
+#include <juce_audio_formats/juce_audio_formats.h>
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace host::graph::nodes
+{
+namespace
+{
+    // Stable parameter id list for the queued parameters. Index into this
+    // array is what the queue stores. Layout: 0=wet,1=dry.
+    const std::array<std::string, 2> kParamIds { "wet", "dry" };
+
+    constexpr int kMinTailPartition = 1024;
+    constexpr int kMaxTailPartition = 8192;
+    // Tail partitions this many times the head's keep the worker's FFTs
+    // few and large while the audio thread's share stays short.
+    constexpr int kTailPartitionFactor = 16;
+    constexpr int kResampleChunk = 4096;
+    // Longest the audio thread waits for a late tail job, as a share of a
+    // block, before it gives that partition up.
+    constexpr double kTailWaitFraction = 0.25;
+    constexpr int kStopTimeoutMs = 2000;
+
+    // 0, or the power of two from kDirectTaps to kMaxLatency at or above the
+    // requested latency.
+    int normaliseLatency(double samples) noexcept
+    {
+        const auto requested = static_cast<int>(std::lround(std::clamp(samples, 0.0, 1.0e6)));
+        if (requested <= 0)
+            return 0;
+        int latency = ConvolutionReverbNode::kDirectTaps;
+        while (latency < requested && latency < ConvolutionReverbNode::kMaxLatency)
+            latency *= 2;
+        return latency;
+    }
+
+    // Tail partitions of at least a host block give the worker at least a
+    // block's time per job and keep it to one handoff per block.
+    int tailPartitionFor(int headPartition, int blockSize) noexcept
+    {
+        int partition = std::clamp(kTailPartitionFactor * headPartition, kMinTailPartition, kMaxTailPartition);
+        while (partition < blockSize)
+            partition *= 2;
+        return partition;
+    }
+
+    // 0 for a path that cannot name a file; decodeImpulse() rejects those.
+    juce::int64 modificationTime(const std::string& path)
+    {
+        const juce::String fullPath(path);
+        if (path.empty() || ! juce::File::isAbsolutePath(fullPath))
+            return 0;
+        return juce::File(fullPath).getLastModificationTime().toMilliseconds();
+    }
+
+    using Kernel = audio::PartitionedConvolver::Kernel;
+
+    // Kernel for impulse[start, end), clipped to the impulse.
+    std::unique_ptr<Kernel> makeKernel(const std::vector<float>* impulse, int start, int end, int partitionSize)
+    {
+        const int size = impulse != nullptr ? static_cast<int>(impulse->size()) : 0;
+        const int count = std::min(end, size) - start;
+        if (count <= 0)
+            return std::make_unique<Kernel>(nullptr, 0, partitionSize);
+        return std::make_unique<Kernel>(impulse->data() + start, count, partitionSize);
+    }
+}
+
+    class ConvolutionReverbNode::TailWorker final : public juce::Thread
+    {
+    public:
+        explicit TailWorker(ConvolutionReverbNode& nodeIn)
+            : juce::Thread("Convolution reverb tail")
+            , node(nodeIn)
+        {
+        }
+
+        void run() override
+        {
+            node.tailWorkerLoop(*this);
+        }
+
+    private:
+        ConvolutionReverbNode& node;
+    };
+
+    ConvolutionReverbNode::ConvolutionReverbNode()
+        : juce::Thread("Convolution reverb loader")
+        , tailWorker_(std::make_unique<TailWorker>(*this))
+    {
+    }
+
+    ConvolutionReverbNode::~ConvolutionReverbNode()
+    {
+        stopThreads();
+    }
+
+    void ConvolutionReverbNode::setImpulseResponse(const std::string& path)
+    {
+        {
+            const std::lock_guard<std::mutex> lock(settingsMutex_);
+            // The same file is reloaded if it changed on disk since it was read.
+            if (path == irPath_ && (path.empty() ? decoded_ == nullptr : isCurrent(decoded_.get(), path)))
+                return;
+            irPath_ = path;
+            if (path.empty())
+                decoded_.reset();
+            ++generation_;
+        }
+        notify();
+    }
+
+    void ConvolutionReverbNode::setImpulseResponse(std::vector<std::vector<float>> channels, double sampleRate)
+    {
+        if (channels.size() > static_cast<size_t>(kWetChannels))
+            channels.resize(static_cast<size_t>(kWetChannels));
+        size_t length = 0;
+        for (const auto& channel : channels)
+            length = std::max(length, channel.size());
+        for (auto& channel : channels)
+            channel.resize(length, 0.0f);
+
+        // Cached under the empty path, as if it had been decoded from a file.
+        auto decoded = std::make_shared<DecodedImpulse>();
+        decoded->sampleRate = sampleRate;
+        decoded->channels = std::move(channels);
+        {
+            const std::lock_guard<std::mutex> lock(settingsMutex_);
+            irPath_.clear();
+            decoded_ = std::move(decoded);
+            ++generation_;
+        }
+        notify();
+    }
+
+    std::string ConvolutionReverbNode::getImpulseResponse() const
+    {
+        const std::lock_guard<std::mutex> lock(settingsMutex_);
+        return irPath_;
+    }
+
+    void ConvolutionReverbNode::stopThreads()
+    {
+        signalThreadShouldExit();
+        notify();
+        stopThread(kStopTimeoutMs);
+
+        tailWorker_->signalThreadShouldExit();
+        tailGeneration_.fetch_add(1, std::memory_order_seq_cst);
+        tailGeneration_.notify_all();
+        tailWorker_->stopThread(kStopTimeoutMs);
+        tailWorkerRunning_ = false;
+    }
+
+    void ConvolutionReverbNode::prepare(double sampleRate, int blockSize)
+    {
+        // Both threads touch the convolvers and buffers about to be
+        // reallocated: park them first.
+        stopThreads();
+
+        sampleRate_ = sampleRate > 0.0 ? sampleRate : 44100.0;
+        latency_ = requestedLatency_.load();
+        prepared_ = true;
+        headPartition_ = latency_ == 0 ? kDirectTaps : latency_;
+        headStart_ = latency_ == 0 ? kDirectTaps : 0;
+        tailPartition_ = tailPartitionFor(headPartition_, blockSize);
+        // A tail partition plays two partitions after its input started
+        // collecting; starting the tail that far (less the latency) into
+        // the IR lines it up with the head.
+        tailStart_ = 2 * tailPartition_ - latency_;
+        maxIrLength_ = static_cast<int>(std::ceil(kMaxIrSeconds * sampleRate_));
+
+        const int headPartitions = (tailStart_ - headStart_ + headPartition_ - 1) / headPartition_;
+        tailPartitions_ = std::max(1, (maxIrLength_ - tailStart_ + tailPartition_ - 1) / tailPartition_);
+        for (int c = 0; c < kWetChannels; ++c)
+        {
+            head_[static_cast<size_t>(c)].prepare(headPartition_, headPartitions, 1);
+            tail_[static_cast<size_t>(c)].prepare(tailPartition_, tailPartitions_, 1);
+
+            directHistory_[static_cast<size_t>(c)].assign(static_cast<size_t>(2 * kDirectTaps), 0.0f);
+            for (auto& buffer : tailInput_)
+                buffer.channels[static_cast<size_t>(c)].assign(static_cast<size_t>(tailPartition_), 0.0f);
+            for (auto& buffer : tailOutput_)
+                buffer.channels[static_cast<size_t>(c)].assign(static_cast<size_t>(tailPartition_), 0.0f);
+        }
+        directPos_ = 0;
+        collect_ = 0;
+        play_ = 0;
+        tailPos_ = 0;
+        jobChannels_ = 0;
+        tailMissed_ = 0;
+        jobMissed_ = 0;
+        tailBusy_.store(false);
+
+        dryDelay_.resize(static_cast<size_t>(kMaxChannels));
+        for (auto& line : dryDelay_)
+            line.assign(static_cast<size_t>(latency_), 0.0f);
+        dryPos_ = 0;
+
+        scratchFrames_ = std::max(1, blockSize);
+        for (auto& scratch : wetScratch_)
+            scratch.assign(static_cast<size_t>(scratchFrames_), 0.0f);
+        tailWaitLimit_ = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(kTailWaitFraction * scratchFrames_ / sampleRate_));
+        wetRamp_.assign(static_cast<size_t>(scratchFrames_), 0.0f);
+        dryRamp_.assign(static_cast<size_t>(scratchFrames_), 0.0f);
+        wetSmoothed_.reset(sampleRate_, 0.02); // ~20 ms ramp
+        wetSmoothed_.setCurrentAndTargetValue(std::clamp(wet_.load(), 0.0f, 1.0f));
+        drySmoothed_.reset(sampleRate_, 0.02);
+        drySmoothed_.setCurrentAndTargetValue(std::clamp(dry_.load(), 0.0f, 1.0f));
+        queue_.prepare(ConvolutionReverbNode::kParamCount * 2);
+        drained_.reserve(queue_.capacity());
+        silentSamples_ = 0;
+
+        // The split points and the rate may have changed, so the kernels are
+        // rebuilt here rather than kept; only an IR not decoded yet reads the
+        // file.
+        installImpulse(resampleImpulse(findDecoded(getImpulseResponse()).get(), sampleRate_, maxIrLength_), true);
+
+        // The tail shares the device callback's deadline, so ask for realtime
+        // scheduling like the graph workers. If no thread starts at all the
+        // audio thread convolves the tail itself.
+        tailWorkerRunning_ = tailWorker_->startRealtimeThread(juce::Thread::RealtimeOptions {})
+                          || tailWorker_->startThread(juce::Thread::Priority::highest);
+        startThread(juce::Thread::Priority::low);
+    }
+
+    void ConvolutionReverbNode::process(ProcessContext& ctx)
+    {
+        applyParameterChanges();
+
+        const int frames = std::max(0, ctx.numFrames);
+        const int inputs = std::max(0, ctx.numInputChannels);
+        const int outputs = std::max(0, ctx.numOutputChannels);
+
+        if (frames == 0 || outputs == 0 || ctx.outputChannels == nullptr || scratchFrames_ == 0)
+            return;
+
+        if (auto* next = directHandoff_.take())
+        {
+            directHandoff_.retire(directTaps_.release());
+            directTaps_.reset(next);
+        }
+
+        wetSmoothed_.setTargetValue(std::clamp(wet_.load(), 0.0f, 1.0f));
+        drySmoothed_.setTargetValue(std::clamp(dry_.load(), 0.0f, 1.0f));
+
+        for (int ch = kMaxChannels; ch < outputs; ++ch)
+        {
+            if (ctx.outputChannels[ch] != nullptr)
+                juce::FloatVectorOperations::clear(ctx.outputChannels[ch], frames);
+        }
+
+        const int channels = std::min(outputs, kMaxChannels);
+        const int wetChannels = std::min(channels, kWetChannels);
+        const auto input = [&](int ch, int offset) -> const float*
+        {
+            if (inputs == 0 || ctx.inputChannels == nullptr || ctx.inputChannels[ch % inputs] == nullptr)
+                return nullptr;
+            return ctx.inputChannels[ch % inputs] + offset;
+        };
+
+        for (int done = 0; done < frames;)
+        {
+            const int count = std::min(frames - done, scratchFrames_);
+            for (int i = 0; i < count; ++i)
+            {
+                wetRamp_[static_cast<size_t>(i)] = wetSmoothed_.getNextValue();
+                dryRamp_[static_cast<size_t>(i)] = drySmoothed_.getNextValue();
+            }
+
+            // The wet path reads its inputs before any output is written.
+            std::array<const float*, kWetChannels> sources {};
+            for (int c = 0; c < wetChannels; ++c)
+                sources[static_cast<size_t>(c)] = input(c, done);
+            renderWet(sources.data(), wetChannels, count);
+
+            // Highest channel first: output ch reads input ch % inputs, which
+            // is never above ch, so a fanned-out input is still intact when
+            // an in-place run reaches it.
+            for (int ch = channels - 1; ch >= 0; --ch)
+            {
+                float* dest = ctx.outputChannels[ch];
+                if (dest == nullptr)
+                    continue;
+                dest += done;
+
+                const float* src = input(ch, done);
+                const float* wet = ch < wetChannels ? wetScratch_[static_cast<size_t>(ch)].data() : nullptr;
+                auto* line = latency_ > 0 ? dryDelay_[static_cast<size_t>(ch)].data() : nullptr;
+                int pos = dryPos_;
+                for (int i = 0; i < count; ++i)
+                {
+                    float dry = src != nullptr ? src[i] : 0.0f;
+                    if (line != nullptr)
+                    {
+                        const float delayed = line[pos];
+                        line[pos] = dry;
+                        dry = delayed;
+                        pos = pos + 1 == latency_ ? 0 : pos + 1;
+                    }
+                    float out = dry * dryRamp_[static_cast<size_t>(i)];
+                    if (wet != nullptr)
+                        out += wet[i] * wetRamp_[static_cast<size_t>(i)];
+                    dest[i] = out;
+                }
+            }
+            if (latency_ > 0)
+                dryPos_ = (dryPos_ + count) % latency_;
+
+            done += count;
+        }
+
+        silentSamples_ = ctx.inputSilent ? static_cast<int>(std::min<std::int64_t>(static_cast<std::int64_t>(silentSamples_) + frames, Node::kInfiniteTail))
+                                         : 0;
+    }
+
+    void ConvolutionReverbNode::renderWet(const float* const* sources, int numChannels, int numSamples) noexcept
+    {
+        for (int c = 0; c < numChannels; ++c)
+        {
+            const float* source = sources[c];
+            float* wet = wetScratch_[static_cast<size_t>(c)].data();
+            head_[static_cast<size_t>(c)].process(&source, &wet, 1, numSamples);
+        }
+
+        // Zero latency: the first kDirectTaps IR samples as a direct FIR.
+        int pos = directPos_;
+        if (latency_ == 0)
+        {
+            for (int c = 0; c < numChannels; ++c)
+            {
+                const float* source = sources[c];
+                float* wet = wetScratch_[static_cast<size_t>(c)].data();
+                float* history = directHistory_[static_cast<size_t>(c)].data();
+                const float* taps = directTaps_ != nullptr ? directTaps_->reversed[static_cast<size_t>(c)].data() : nullptr;
+                pos = directPos_;
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const float x = source != nullptr ? source[i] : 0.0f;
+                    history[pos] = x;
+                    history[pos + kDirectTaps] = x;
+                    if (taps != nullptr)
+                    {
+                        // history[pos + 1 .. pos + kDirectTaps] runs oldest to
+                        // newest, matching the reversed taps.
+                        const float* window = history + pos + 1;
+                        float sum = 0.0f;
+                        for (int k = 0; k < kDirectTaps; ++k)
+                            sum += taps[k] * window[k];
+                        wet[i] += sum;
+                    }
+                    pos = pos + 1 == kDirectTaps ? 0 : pos + 1;
+                }
+            }
+        }
+        directPos_ = pos;
+
+        // Tail: collect whole partitions for the worker and play back the
+        // one it finished a partition ago.
+        for (int done = 0; done < numSamples;)
+        {
+            const int count = std::min(numSamples - done, tailPartition_ - tailPos_);
+            for (int c = 0; c < kWetChannels; ++c)
+            {
+                float* collected = tailInput_[static_cast<size_t>(collect_)].channels[static_cast<size_t>(c)].data() + tailPos_;
+                const float* source = c < numChannels ? sources[c] : nullptr;
+                if (source != nullptr)
+                    juce::FloatVectorOperations::copy(collected, source + done, count);
+                else
+                    juce::FloatVectorOperations::clear(collected, count);
+
+                if (c < numChannels)
+                    juce::FloatVectorOperations::add(wetScratch_[static_cast<size_t>(c)].data() + done,
+                                                     tailOutput_[static_cast<size_t>(play_)].channels[static_cast<size_t>(c)].data() + tailPos_,
+                                                     count);
+            }
+
+            tailPos_ += count;
+            done += count;
+            if (tailPos_ == tailPartition_)
+            {
+                finishTailPartition(numChannels);
+                tailPos_ = 0;
+            }
+        }
+    }
+
+    bool ConvolutionReverbNode::waitForTailJob() const noexcept
+    {
+        // Offline renders have no deadline and must not lose any of the tail.
+        const bool bounded = ! nonRealtime_.load(std::memory_order_relaxed);
+        const auto deadline = std::chrono::steady_clock::now() + tailWaitLimit_;
+        while (tailBusy_.load(std::memory_order_acquire))
+        {
+            if (! bounded)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            if (std::chrono::steady_clock::now() >= deadline)
+                return false;
+            cpuRelax();
+        }
+        return true;
+    }
+
+    void ConvolutionReverbNode::finishTailPartition(int numChannels) noexcept
+    {
+        // The worker has had a whole partition, at least one block, for its
+        // job, so it is only still busy here when it overran.
+        if (tailBusy_.load(std::memory_order_acquire) && ! waitForTailJob())
+        {
+            // Rather than stall the callback, replay the output buffer
+            // silenced and drop the partition just collected. The late job
+            // is discarded once it lands.
+            tailOverruns_.fetch_add(1, std::memory_order_relaxed);
+            tailMissed_ = std::min(tailMissed_ + 1, tailPartitions_);
+            for (auto& channel : tailOutput_[static_cast<size_t>(play_)].channels)
+                juce::FloatVectorOperations::clear(channel.data(), tailPartition_);
+            return;
+        }
+
+        // Its output plays next; the partition just collected is its new job.
+        play_ ^= 1;
+        collect_ ^= 1;
+        jobChannels_ = numChannels;
+        jobMissed_ = tailMissed_;
+        if (tailMissed_ > 0)
+        {
+            // That output was due while a silent partition played.
+            for (auto& channel : tailOutput_[static_cast<size_t>(play_)].channels)
+                juce::FloatVectorOperations::clear(channel.data(), tailPartition_);
+            tailMissed_ = 0;
+        }
+
+        if (! tailWorkerRunning_)
+        {
+            runTailJob();
+            return;
+        }
+        tailBusy_.store(true, std::memory_order_seq_cst);
+        tailGeneration_.fetch_add(1, std::memory_order_seq_cst);
+        tailGeneration_.notify_one();
+    }
+
+    void ConvolutionReverbNode::runTailJob() noexcept
+    {
+        auto& input = tailInput_[static_cast<size_t>(collect_ ^ 1)];
+        auto& output = tailOutput_[static_cast<size_t>(play_ ^ 1)];
+        for (int c = 0; c < kWetChannels; ++c)
+        {
+            float* dest = output.channels[static_cast<size_t>(c)].data();
+            if (c >= jobChannels_)
+            {
+                juce::FloatVectorOperations::clear(dest, tailPartition_);
+                continue;
+            }
+            // Dropped partitions go in as silence so the history stays lined
+            // up with the output schedule.
+            auto& convolver = tail_[static_cast<size_t>(c)];
+            if (jobMissed_ >= tailPartitions_)
+            {
+                convolver.reset();
+            }
+            else
+            {
+                for (int i = 0; i < jobMissed_; ++i)
+                    convolver.processBlock(nullptr, &dest, 1);
+            }
+
+            const float* source = input.channels[static_cast<size_t>(c)].data();
+            convolver.processBlock(&source, &dest, 1);
+        }
+    }
+
+    void ConvolutionReverbNode::tailWorkerLoop(TailWorker& worker)
+    {
+        while (! worker.threadShouldExit())
+        {
+            // Checking the flag after reading the generation closes the gap
+            // where a job is posted between the two.
+            const auto seen = tailGeneration_.load(std::memory_order_seq_cst);
+            if (! tailBusy_.load(std::memory_order_seq_cst))
+            {
+                tailGeneration_.wait(seen, std::memory_order_seq_cst);
+                continue;
+            }
+
+            runTailJob();
+            tailBusy_.store(false, std::memory_order_release);
+        }
+    }
+
+    bool ConvolutionReverbNode::isSilentForSilentInput() const
+    {
+        // By then every convolver has been fed zeros for longer than the IR
+        // and the tail buffers in flight are silent too.
+        return static_cast<std::int64_t>(silentSamples_) >= static_cast<std::int64_t>(latency_) + tailSamples();
+    }
+
+    int ConvolutionReverbNode::tailSamples() const
+    {
+        return irLength_.load() + 2 * tailPartition_ + headPartition_;
+    }
+
+    void ConvolutionReverbNode::setNonRealtime(bool isNonRealtime)
+    {
+        nonRealtime_.store(isNonRealtime);
+    }
+
+    void ConvolutionReverbNode::run()
+    {
+        runBackgroundRebuild(
+            *this, settingsMutex_, generation_,
+            [this] { return irPath_; },
+            [this](const std::string& path) { return resampleImpulse(findDecoded(path).get(), sampleRate_, maxIrLength_); },
+            [this](const ImpulseChannels& impulse) { installImpulse(impulse, false); });
+    }
+
+    std::shared_ptr<const ConvolutionReverbNode::DecodedImpulse> ConvolutionReverbNode::findDecoded(const std::string& path)
+    {
+        {
+            const std::lock_guard<std::mutex> lock(settingsMutex_);
+            if (isCurrent(decoded_.get(), path))
+                return decoded_;
+        }
+
+        auto decoded = decodeImpulse(path);
+        if (decoded != nullptr)
+        {
+            // Unless the IR changed meanwhile, e.g. to one held in memory.
+            const std::lock_guard<std::mutex> lock(settingsMutex_);
+            if (path == irPath_)
+                decoded_ = decoded;
+        }
+        return decoded;
+    }
+
+    bool ConvolutionReverbNode::isCurrent(const DecodedImpulse* decoded, const std::string& path)
+    {
+        if (decoded == nullptr || decoded->path != path)
+            return false;
+        return path.empty() || decoded->modifiedMs == modificationTime(path);
+    }
+
+    std::shared_ptr<const ConvolutionReverbNode::DecodedImpulse> ConvolutionReverbNode::decodeImpulse(const std::string& path)
+    {
+        if (path.empty())
+            return nullptr;
+
+        const juce::String fullPath(path);
+        if (! juce::File::isAbsolutePath(fullPath))
+        {
+            juce::Logger::writeToLog("Convolution reverb: impulse response path is not absolute: " + fullPath);
+            return nullptr;
+        }
+
+        // Taken before reading, so an edit landing mid-read still counts as a
+        // change next time.
+        const auto modifiedMs = modificationTime(path);
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(juce::File(fullPath)));
+        if (reader == nullptr)
+        {
+            juce::Logger::writeToLog("Convolution reverb: cannot read impulse response " + fullPath);
+            return nullptr;
+        }
+
+        const int channels = std::min(static_cast<int>(reader->numChannels), kWetChannels);
+        const auto length = static_cast<int>(std::min<juce::int64>(reader->lengthInSamples,
+                                                                   static_cast<juce::int64>(std::ceil(kMaxIrSeconds * reader->sampleRate))));
+        if (reader->sampleRate <= 0.0 || channels <= 0 || length <= 0)
+            return nullptr;
+
+        juce::AudioBuffer<float> source(channels, length);
+        reader->read(&source, 0, length, 0, true, channels > 1);
+
+        auto decoded = std::make_shared<DecodedImpulse>();
+        decoded->path = path;
+        decoded->modifiedMs = modifiedMs;
+        decoded->sampleRate = reader->sampleRate;
+        decoded->channels.resize(static_cast<size_t>(channels));
+        for (int ch = 0; ch < channels; ++ch)
+            decoded->channels[static_cast<size_t>(ch)].assign(source.getReadPointer(ch), source.getReadPointer(ch) + length);
+        return decoded;
+    }
+
+    ConvolutionReverbNode::ImpulseChannels ConvolutionReverbNode::resampleImpulse(const DecodedImpulse* decoded, double sampleRate, int maxLength)
+    {
+        ImpulseChannels impulse;
+        if (decoded == nullptr || decoded->sampleRate <= 0.0 || decoded->channels.empty() || decoded->channels.front().empty())
+            return impulse;
+
+        const int channels = static_cast<int>(decoded->channels.size());
+        const int fileLength = static_cast<int>(decoded->channels.front().size());
+        const double ratio = decoded->sampleRate / sampleRate;
+        if (std::abs(ratio - 1.0) < 1.0e-9)
+        {
+            impulse = decoded->channels;
+        }
+        else
+        {
+            const int length = static_cast<int>(std::ceil(fileLength / ratio));
+            impulse.assign(static_cast<size_t>(channels), std::vector<float>(static_cast<size_t>(length), 0.0f));
+
+            audio::PolyphaseResampler resampler;
+            resampler.prepare(channels, ratio, kResampleChunk, kResampleChunk);
+            std::array<const float*, kWetChannels> in {};
+            std::array<float*, kWetChannels> out {};
+            int consumed = 0;
+            int produced = 0;
+            while (produced < length)
+            {
+                // Past the end of the file, silence flushes the filter.
+                const int count = std::min(kResampleChunk, fileLength - consumed);
+                if (count > 0)
+                {
+                    for (int ch = 0; ch < channels; ++ch)
+                        in[static_cast<size_t>(ch)] = decoded->channels[static_cast<size_t>(ch)].data() + consumed;
+                    resampler.push(in.data(), count);
+                    consumed += count;
+                }
+                else
+                {
+                    resampler.push(nullptr, kResampleChunk);
+                }
+
+                while (produced < length)
+                {
+                    const int wanted = std::min(kResampleChunk, length - produced);
+                    if (! resampler.canProcess(wanted))
+                        break;
+                    for (int ch = 0; ch < channels; ++ch)
+                        out[static_cast<size_t>(ch)] = impulse[static_cast<size_t>(ch)].data() + produced;
+                    produced += resampler.process(out.data(), wanted);
+                }
+            }
+        }
+
+        // Unit energy on the loudest channel, so IRs of any length and level
+        // come out at a comparable loudness and the wet control means the
+        // same for all of them.
+        double energy = 0.0;
+        for (auto& channel : impulse)
+        {
+            if (static_cast<int>(channel.size()) > maxLength)
+                channel.resize(static_cast<size_t>(maxLength));
+            double sum = 0.0;
+            for (const float s : channel)
+                sum += static_cast<double>(s) * s;
+            energy = std::max(energy, sum);
+        }
+        if (energy > 0.0)
+        {
+            const auto gain = static_cast<float>(1.0 / std::sqrt(energy));
+            for (auto& channel : impulse)
+                juce::FloatVectorOperations::multiply(channel.data(), gain, static_cast<int>(channel.size()));
+        }
+        return impulse;
+    }
+
+    void ConvolutionReverbNode::installImpulse(const ImpulseChannels& impulse, bool immediately)
+    {
+        const int irChannels = static_cast<int>(impulse.size());
+        auto taps = std::make_unique<DirectTaps>();
+        int length = 0;
+        for (int c = 0; c < kWetChannels; ++c)
+        {
+            // A mono IR feeds both wet channels.
+            const auto* channel = irChannels > 0 ? &impulse[static_cast<size_t>(c % irChannels)] : nullptr;
+            const int size = channel != nullptr ? static_cast<int>(channel->size()) : 0;
+            length = std::max(length, size);
+
+            if (latency_ == 0)
+            {
+                auto& reversed = taps->reversed[static_cast<size_t>(c)];
+                for (int k = 0; k < std::min(size, kDirectTaps); ++k)
+                    reversed[static_cast<size_t>(kDirectTaps - 1 - k)] = (*channel)[static_cast<size_t>(k)];
+            }
+
+            auto head = makeKernel(channel, headStart_, tailStart_, headPartition_);
+            auto tail = makeKernel(channel, tailStart_, size, tailPartition_);
+            if (immediately)
+            {
+                head_[static_cast<size_t>(c)].setKernel(std::move(head));
+                tail_[static_cast<size_t>(c)].setKernel(std::move(tail));
+            }
+            else
+            {
+                head_[static_cast<size_t>(c)].publishKernel(std::move(head));
+                tail_[static_cast<size_t>(c)].publishKernel(std::move(tail));
+            }
+        }
+
+        if (immediately)
+        {
+            directHandoff_.clear();
+            directTaps_ = std::move(taps);
+        }
+        else
+        {
+            directHandoff_.publish(std::move(taps));
+        }
+        irLength_.store(length);
+    }
+
+    std::vector<NodeParameter> ConvolutionReverbNode::getParameters() const
+    {
+        NodeParameter impulse { "ir_file", "Impulse Response", 0.0, 0.0, 1.0, 0.0, false };
+        impulse.isText = true;
+        impulse.text = getImpulseResponse();
+        // Once prepared, the latency in effect rather than the one asked for.
+        NodeParameter latency { "latency", "Latency (samples)", static_cast<double>(prepared_ ? latency_ : requestedLatency_.load()),
+                                0.0, kMaxLatency, 0.0, false };
+        latency.loadTimeOnly = true;
+        return {
+            impulse,
+            { "wet", "Wet", wet_.load(), 0.0, 1.0, 0.3, true },
+            { "dry", "Dry", dry_.load(), 0.0, 1.0, 1.0, true },
+            latency,
+        };
+    }
+
+    void ConvolutionReverbNode::setParameters(const std::vector<NodeParameter>& parameters)
+    {
+        // Load-time path: write state directly. requestParameterChange is the
+        // live, queue-routed path for wet and dry.
+        for (const auto& p : parameters)
+        {
+            if (p.id == "ir_file" && p.isText)
+                setImpulseResponse(p.text);
+            else if (p.id == "wet")
+                wet_.store(static_cast<float>(p.value));
+            else if (p.id == "dry")
+                dry_.store(static_cast<float>(p.value));
+            else if (p.id == "latency")
+                requestedLatency_.store(normaliseLatency(p.value));
+        }
+    }
+
+    void ConvolutionReverbNode::pushChange(int index, double value)
+    {
+        queue_.push(static_cast<std::size_t>(index), value);
+    }
+
+    void ConvolutionReverbNode::requestParameterChange(const std::string& id, double value)
+    {
+        for (int i = 0; i < ConvolutionReverbNode::kParamCount; ++i)
+            if (kParamIds[static_cast<size_t>(i)] == id)
+            {
+                pushChange(i, value);
+                return;
+            }
+    }
+
+    void ConvolutionReverbNode::applyParameterChanges()
+    {
+        queue_.drain(drained_);
+        for (const auto& entry : drained_)
+        {
+            switch (static_cast<int>(entry.idHash))
+            {
+                case 0: wet_.store(static_cast<float>(entry.value)); break;
+                case 1: dry_.store(static_cast<float>(entry.value)); break;
+                default: break;
+            }
+        }
+    }
+} // namespace host::graph::nodes
@@ -0,0 +1,202 @@
+#pragma once
+
+#include "audio/PartitionedConvolver.h"
+#include "audio/RealtimeHandoff.h"
+#include "graph/Node.h"
+#include "graph/ParameterQueue.h"
+
+#include <juce_core/juce_core.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace host::graph::nodes
+{
+/// Convolution reverb with impulse responses loaded from audio files (WAV,
+/// AIFF, FLAC). Mono or stereo IRs; IR channel c is applied to input c.
+///
+/// The IR is split non-uniformly so long responses cost little on the audio
+/// thread:
+///  - with zero latency, its first kDirectTaps samples run as a direct FIR and
+///    the rest of the head through a partitioned convolver whose FIFO delay
+///    equals that offset; with a latency set, the head convolver's partition
+///    is the latency and covers the IR from sample 0;
+///  - everything from the split point on runs through a convolver with much
+///    larger partitions on a tail worker thread. A collected tail partition is
+///    handed over at its boundary and its output is played one partition
+///    later, so the worker has a whole partition, at least one host block, of
+///    time per job. A job still running a little past that is given up: the
+///    partition plays silent and is counted in getTailOverrunCount().
+///    Offline renders wait for it instead.
+///
+/// A new IR is read, resampled and transformed on a loader thread owned by
+/// the node; its kernels crossfade in at the next partition of each
+/// convolver. prepare() builds the kernels itself, like LinearPhaseEqNode, so
+/// playback and offline renders start with the reverb in place. The decoded
+/// file is cached, so a re-prepare only resamples it again.
+class ConvolutionReverbNode : public Node,
+                              private juce::Thread
+{
+public:
+    /// Wet channels; further output channels carry the dry signal only.
+    static constexpr int kWetChannels = 2;
+    static constexpr int kMaxChannels = 64;
+    static constexpr int kDirectTaps = 64;
+    static constexpr int kMaxLatency = 1024;
+    static constexpr double kMaxIrSeconds = 10.0;
+
+    ConvolutionReverbNode();
+    ~ConvolutionReverbNode() override;
+
+    /// Message thread. Absolute path of the IR file, or empty for none. The
+    /// file is loaded in the background; setting the current path again
+    /// reloads it if it has been modified since it was read.
+    void setImpulseResponse(const std::string& path);
+    /// Message thread. An IR held in memory, one vector per channel at
+    /// sampleRate, in place of a file; the path reads back as empty. Setting
+    /// an empty path removes it again.
+    void setImpulseResponse(std::vector<std::vector<float>> channels, double sampleRate);
+    std::string getImpulseResponse() const;
+
+    void prepare(double sampleRate, int blockSize) override;
+    void process(ProcessContext& ctx) override;
+    int latencySamples() const override { return latency_; }
+    std::string name() const override { return "Convolution Reverb"; }
+    std::string typeId() const override { return "ConvolutionReverb"; }
+    bool supportsInPlace() const override { return true; }
+    bool isSilentForSilentInput() const override;
+    int tailSamples() const override;
+    void setNonRealtime(bool isNonRealtime) override;
+    /// "latency" is in samples, rounded to 0 or a power of two from
+    /// kDirectTaps to kMaxLatency. It is load-time only: setParameters()
+    /// stores it for the next prepare(), and once prepared getParameters()
+    /// reports the latency in effect.
+    std::vector<NodeParameter> getParameters() const override;
+    void setParameters(const std::vector<NodeParameter>& parameters) override;
+    void requestParameterChange(const std::string& id, double value) override;
+    void applyParameterChanges() override;
+
+    /// Any thread: tail partitions played silent because the worker was late.
+    std::uint64_t getTailOverrunCount() const noexcept { return tailOverruns_.load(std::memory_order_relaxed); }
+
+private:
+    class TailWorker;
+
+    /// Direct-form taps for the zero-latency head, time-reversed.
+    struct DirectTaps
+    {
+        std::array<std::array<float, kDirectTaps>, kWetChannels> reversed {};
+    };
+
+    /// An IR file as read, at its own sample rate.
+    struct DecodedImpulse
+    {
+        std::string path;
+        juce::int64 modifiedMs { 0 }; ///< The file's modification time when read
+        double sampleRate { 0.0 };
+        std::vector<std::vector<float>> channels;
+    };
+
+    using ImpulseChannels = std::vector<std::vector<float>>;
+
+    /// One buffer of a whole tail partition per wet channel.
+    struct TailBuffer
+    {
+        std::array<std::vector<float>, kWetChannels> channels;
+    };
+
+    void run() override;
+    std::shared_ptr<const DecodedImpulse> findDecoded(const std::string& path);
+    static bool isCurrent(const DecodedImpulse* decoded, const std::string& path);
+    static std::shared_ptr<const DecodedImpulse> decodeImpulse(const std::string& path);
+    static ImpulseChannels resampleImpulse(const DecodedImpulse* decoded, double sampleRate, int maxLength);
+    /// immediately: from prepare(), with both threads parked. Otherwise from
+    /// the loader, through the convolvers' lock-free handoff.
+    void installImpulse(const ImpulseChannels& impulse, bool immediately);
+
+    void renderWet(const float* const* sources, int numChannels, int numSamples) noexcept;
+    bool waitForTailJob() const noexcept;
+    void finishTailPartition(int numChannels) noexcept;
+    void runTailJob() noexcept;
+    void tailWorkerLoop(TailWorker& worker);
+    void stopThreads();
+    void pushChange(int index, double value);
+
+    // Guards irPath_, generation_ and decoded_ between the message thread and
+    // the loader; the audio thread never takes it.
+    mutable std::mutex settingsMutex_;
+    std::string irPath_;
+    std::shared_ptr<const DecodedImpulse> decoded_;
+    // Bumped on every change; see runBackgroundRebuild().
+    std::uint64_t generation_ { 0 };
+
+    std::atomic<float> wet_ { 0.3f };
+    std::atomic<float> dry_ { 1.0f };
+    std::atomic<int> requestedLatency_ { 0 };
+    // Samples of the current IR after resampling, for tailSamples().
+    std::atomic<int> irLength_ { 0 };
+
+    // Layout, fixed by prepare() while both threads are parked.
+    double sampleRate_ { 44100.0 };
+    int latency_ { 0 };
+    bool prepared_ { false };
+    int headPartition_ { kDirectTaps };
+    int headStart_ { kDirectTaps }; // IR sample the head convolver starts at
+    int tailPartition_ { 1024 };
+    int tailPartitions_ { 1 };
+    int tailStart_ { 2048 };        // IR sample the tail convolver starts at
+    int maxIrLength_ { 0 };
+    int scratchFrames_ { 0 };
+    std::chrono::steady_clock::duration tailWaitLimit_ {};
+
+    std::array<audio::PartitionedConvolver, kWetChannels> head_;
+    std::array<audio::PartitionedConvolver, kWetChannels> tail_;
+    std::unique_ptr<DirectTaps> directTaps_;
+    audio::RealtimeHandoff<DirectTaps> directHandoff_;
+    // Input history for the direct FIR, mirrored so the window is contiguous.
+    std::array<std::vector<float>, kWetChannels> directHistory_;
+    int directPos_ { 0 };
+
+    // Tail double buffering: the audio thread fills tailInput_[collect_] and
+    // plays tailOutput_[play_] while the worker convolves the other input
+    // into the other output.
+    std::array<TailBuffer, 2> tailInput_;
+    std::array<TailBuffer, 2> tailOutput_;
+    int collect_ { 0 };
+    int play_ { 0 };
+    int tailPos_ { 0 };
+    int jobChannels_ { 0 };
+    // Partitions dropped since the worker last caught up, and how many of
+    // them the posted job feeds in as silence first.
+    int tailMissed_ { 0 };
+    int jobMissed_ { 0 };
+    std::unique_ptr<TailWorker> tailWorker_;
+    bool tailWorkerRunning_ { false };
+    std::atomic<std::uint32_t> tailGeneration_ { 0 };
+    std::atomic<bool> tailBusy_ { false };
+    std::atomic<bool> nonRealtime_ { false };
+    std::atomic<std::uint64_t> tailOverruns_ { 0 };
+
+    // Dry path, delayed by the latency so it stays aligned with the wet.
+    std::vector<std::vector<float>> dryDelay_;
+    int dryPos_ { 0 };
+
+    std::array<std::vector<float>, kWetChannels> wetScratch_;
+    juce::SmoothedValue<float> wetSmoothed_;
+    juce::SmoothedValue<float> drySmoothed_;
+    std::vector<float> wetRamp_;
+    std::vector<float> dryRamp_;
+    ParameterQueue queue_;
+    std::vector<ParameterQueue::Entry> drained_;
+    // Audio thread: consecutive silent input samples.
+    int silentSamples_ { 0 };
+    // Index layout: 0=wet,1=dry
+    static constexpr int kParamCount = 2;
+};
+} // namespace host::graph::nodes
@@ -10,6 +10,9 @@ namespace host::graph::nodes
         // Stable parameter id list mirroring getParameters(). Index into this
         // array is what the queue stores. Layout: 0=time,1=feedback,2=mix.
         const std::array<std::string, 3> kParamIds { "time", "feedback", "mix" };
+
+        // Echo level (-120 dB) after which the feedback tail counts as gone.
+        constexpr double kTailFloor = 1.0e-6;
     }
 
     DelayNode::DelayNode()
@@ -39,7 +42,7 @@ namespace host::graph::nodes
         mixSmoothed_.setCurrentAndTargetValue(std::clamp(mix_.load(), 0.0f, 1.0f));
         mixRampBuffer_.assign(static_cast<size_t>(std::max(1, blockSize)), 0.0f);
         queue_.prepare(DelayNode::kParamCount * 2);
-        drained_.reserve(DelayNode::kParamCount * 2);
+        drained_.reserve(queue_.capacity());
         updateDelaySamples();
     }
 
@@ -143,6 +146,16 @@ namespace host::graph::nodes
             dirty_ = true;
     }
 
+    int DelayNode::tailSamples() const
+    {
+        // One pass through the line, then one more per repeat until the
+        // feedback has decayed below kTailFloor.
+        const double delay = std::max(1.0, std::round(timeMs_.load() * 0.001 * preparedSampleRate_));
+        const double feedback = std::clamp(static_cast<double>(feedback_.load()), 0.0, 0.99);
+        const double repeats = feedback > 0.0 ? std::ceil(std::log(kTailFloor) / std::log(feedback)) : 0.0;
+        return static_cast<int>(delay * (1.0 + repeats));
+    }
+
     void DelayNode::updateDelaySamples()
     {
         delaySamples_ = std::max(1, static_cast<int>(std::round(timeMs_.load() * 0.001 * preparedSampleRate_)));
@@ -23,6 +23,7 @@ public:
     void process(ProcessContext& ctx) override;
     std::string name() const override { return "Delay"; }
     std::string typeId() const override { return "Delay"; }
+    int tailSamples() const override;
     std::vector<NodeParameter> getParameters() const override;
     void setParameters(const std::vector<NodeParameter>& parameters) override;
     void requestParameterChange(const std::string& id, double value) override;
@@ -1,29 +1,75 @@
 #include "graph/Nodes/EqualizerNode.h"
 
+#include <algorithm>
 #include <cmath>
 
 namespace host::graph::nodes
 {
 namespace
 {
-    // Default band centres spaced across the audible spectrum.
-    constexpr std::array<float, EqualizerNode::kBandCount> kDefaultFreqs { 80.0f, 500.0f, 2500.0f, 8000.0f };
+    // Default band centres. The first four are the original four-band
+    // layout; the rest fill the gaps between them so adding bands one at a
+    // time lands somewhere useful.
+    constexpr std::array<float, EqualizerNode::kMaxBands> kDefaultFreqs {
+        80.0f, 500.0f, 2500.0f, 8000.0f, 40.0f, 160.0f, 1000.0f, 5000.0f,
+        12000.0f, 120.0f, 250.0f, 750.0f, 1500.0f, 3500.0f, 6500.0f, 16000.0f,
+        30.0f, 60.0f, 200.0f, 350.0f, 2000.0f, 3000.0f, 10000.0f, 14000.0f
+    };
 
-    // Stable parameter id list in the same order as getParameters(). Index
-    // into this list is what the queue stores, so the audio thread can apply
-    // a change without string parsing or hash lookups.
+    constexpr int kBandTypeCount = 7;
+    constexpr int kMinSlope = 12;
+    constexpr int kMaxSlope = 12 * EqualizerNode::kMaxSectionsPerBand;
+
+    // Output level (-120 dB) below which a filter tail over silent input
+    // counts as rung out.
+    constexpr float kSettledLevel = 1.0e-6f;
+
+    // Length of a parameter glide, matching GainNode's gain ramp.
+    constexpr double kSmoothingSeconds = 0.02;
+
+    // While a band glides its coefficients are recomputed every this many
+    // samples; short enough that the steps are inaudible, long enough that a
+    // sweep costs a handful of coefficient calculations per block.
+    constexpr int kSmoothingStep = 32;
+
+    bool hasGain(EqualizerNode::BandType type) noexcept
+    {
+        return type == EqualizerNode::BandType::peak
+            || type == EqualizerNode::BandType::lowShelf
+            || type == EqualizerNode::BandType::highShelf;
+    }
+
+    EqualizerNode::BandType toBandType(double value) noexcept
+    {
+        return static_cast<EqualizerNode::BandType>(std::clamp(static_cast<int>(std::lround(value)), 0, kBandTypeCount - 1));
+    }
+
+    int toSlope(double value) noexcept
+    {
+        return std::clamp(static_cast<int>(std::lround(value / 12.0)) * 12, kMinSlope, kMaxSlope);
+    }
+
+    // Q of section `index` of an `sections`-section Butterworth cascade.
+    float butterworthQ(int index, int sections) noexcept
+    {
+        const double angle = juce::MathConstants<double>::pi * (2.0 * index + 1.0) / (4.0 * sections);
+        return static_cast<float>(1.0 / (2.0 * std::cos(angle)));
+    }
+
+    // Stable parameter id list covering every band, in the same order as
+    // getParameters() (which stops at the band count). Index into this list
+    // is what the queue stores, so the audio thread can apply a change
+    // without string parsing or hash lookups.
     std::vector<std::string> buildParamIds()
     {
         std::vector<std::string> ids;
-        ids.reserve(static_cast<size_t>(EqualizerNode::kBandCount) * 4);
-        for (int b = 0; b < EqualizerNode::kBandCount; ++b)
+        ids.reserve(static_cast<size_t>(EqualizerNode::kMaxBands) * EqualizerNode::kFieldsPerBand + 1);
+        for (int b = 0; b < EqualizerNode::kMaxBands; ++b)
         {
-            const auto prefix = "band" + std::to_string(b);
-            ids.push_back(prefix + "_freq");
-            ids.push_back(prefix + "_gain");
-            ids.push_back(prefix + "_q");
-            ids.push_back(prefix + "_on");
+            for (int field = 0; field < EqualizerNode::kFieldsPerBand; ++field)
+                ids.push_back(EqualizerNode::bandParameterId(b, field));
         }
+        ids.push_back("band_count");
         return ids;
     }
     }
@@ -42,15 +88,23 @@ namespace
 
     void EqualizerNode::setBand(int index, const Band& band)
     {
-        if (index < 0 || index >= kBandCount)
+        if (index < 0 || index >= kMaxBands)
             return;
-        bands_[static_cast<size_t>(index)] = band;
+        auto& target = bands_[static_cast<size_t>(index)];
+        target = band;
+        applyBandField(target, fieldSlope, band.slopeDbPerOctave);
+        dirty_ = true;
+    }
+
+    void EqualizerNode::setBandCount(int count)
+    {
+        bandCount_ = std::clamp(count, 1, kMaxBands);
         dirty_ = true;
     }
 
     EqualizerNode::Band EqualizerNode::getBand(int index) const
     {
-        if (index < 0 || index >= kBandCount)
+        if (index < 0 || index >= kMaxBands)
             return {};
         return bands_[static_cast<size_t>(index)];
     }
@@ -59,12 +113,15 @@ namespace
     {
         juce::ignoreUnused(blockSize);
         preparedSampleRate_ = sampleRate > 0.0 ? sampleRate : 44100.0;
-        juce::dsp::ProcessSpec spec { preparedSampleRate_, static_cast<juce::uint32>(std::max(1, blockSize)), 2 };
-        for (auto& bandFilters : filters_)
-            for (auto& f : bandFilters)
-                f.prepare(spec);
-        queue_.prepare(static_cast<int>(kBandCount) * 4 * 2);
-        drained_.reserve(static_cast<size_t>(kBandCount) * 4 * 2);
+        cascade_.prepare(kMaxBands * kMaxSectionsPerBand, kMaxChannels);
+        for (auto& smoother : smoothers_)
+        {
+            smoother.frequency.reset(preparedSampleRate_, kSmoothingSeconds);
+            smoother.gainDb.reset(preparedSampleRate_, kSmoothingSeconds);
+            smoother.q.reset(preparedSampleRate_, kSmoothingSeconds);
+        }
+        queue_.prepare(static_cast<int>(paramIds_.size()) * 2);
+        drained_.reserve(queue_.capacity());
         updateFilters();
     }
 
@@ -81,6 +138,14 @@ namespace
         if (dirty_)
             updateFilters();
 
+        // The cascade reads straight from the inputs when each output has its
+        // own input channel (in place or not). When inputs are fanned out to
+        // more outputs, one input can feed several outputs, so copy first and
+        // filter in place rather than read a channel another group already
+        // overwrote.
+        const bool direct = inputs >= outputs && ctx.inputChannels != nullptr;
+        std::array<const float*, static_cast<size_t>(kMaxChannels)> sources {};
+        const int channels = std::min(outputs, kMaxChannels);
         for (int ch = 0; ch < outputs; ++ch)
         {
             float* dest = ctx.outputChannels[ch];
@@ -91,72 +156,214 @@ namespace
                 ? ctx.inputChannels[ch % inputs]
                 : nullptr;
 
-           if (src != nullptr)
-               juce::FloatVectorOperations::copy(dest, src, frames);
-           else
-               juce::FloatVectorOperations::clear(dest, frames);
+            if (src == nullptr)
+            {
+                juce::FloatVectorOperations::clear(dest, frames);
+                src = dest;
+            }
+            else if (! direct || ch >= kMaxChannels)
+            {
+                if (src != dest)
+                    juce::FloatVectorOperations::copy(dest, src, frames);
+                src = dest;
+            }
 
-           for (int b = 0; b < kBandCount; ++b)
-           {
-               if (bands_[static_cast<size_t>(b)].enabled)
-               {
-                    // IIR::Filter processes via a ProcessContext; feed it a
-                    // single-channel block wrapping this channel's output.
-                    float* channelPtr = dest;
-                    juce::dsp::AudioBlock<float> block(&channelPtr, 1, static_cast<size_t>(frames));
-                    juce::dsp::ProcessContextReplacing<float> context(block);
-                    // Use the per-channel filter so L/R keep independent state.
-                    const int filterCh = std::min(ch, kMaxChannels - 1);
-                    filters_[static_cast<size_t>(b)][static_cast<size_t>(filterCh)].process(context);
-               }
-           }
+            if (ch < kMaxChannels)
+                sources[static_cast<size_t>(ch)] = src;
         }
-    }
 
-    void EqualizerNode::updateFilters()
-    {
-        for (int b = 0; b < kBandCount; ++b)
+        bool smoothing = false;
+        for (const auto& smoother : smoothers_)
+            smoothing = smoothing || smoother.isSmoothing();
+
+        if (! smoothing)
+        {
+            cascade_.process(sources.data(), ctx.outputChannels, channels, frames);
+        }
+        else
         {
-            const auto& band = bands_[static_cast<size_t>(b)];
-            // Disabled or unity-gain bands get unity (passthrough) coefficients
-            // so process() never applies stale non-unity coefficients. reset()
-            // alone only clears the delay-line state, not the coefficients.
-            juce::dsp::IIR::Coefficients<float>::Ptr coeffs;
-            if (! band.enabled || band.gainDb == 0.0f)
+            // Step the gliding bands every kSmoothingStep samples and filter
+            // the block piecewise; the filter state carries straight across
+            // each coefficient change.
+            std::array<const float*, static_cast<size_t>(kMaxChannels)> in {};
+            std::array<float*, static_cast<size_t>(kMaxChannels)> out {};
+            for (int offset = 0; offset < frames; offset += kSmoothingStep)
             {
-                // (1, 0, 1, 0) = y[n] = x[n] (unity). Matches JUCE default.
-                coeffs = juce::dsp::IIR::Coefficients<float>::Ptr(
-                    new juce::dsp::IIR::Coefficients<float>(1, 0, 1, 0));
+                const int count = std::min(kSmoothingStep, frames - offset);
+                for (int b = 0; b < kMaxBands; ++b)
+                {
+                    auto& smoother = smoothers_[static_cast<size_t>(b)];
+                    if (! smoother.isSmoothing())
+                        continue;
+                    smoother.frequency.skip(count);
+                    smoother.gainDb.skip(count);
+                    smoother.q.skip(count);
+                    updateBandCoefficients(b);
+                }
+
+                for (int ch = 0; ch < channels; ++ch)
+                {
+                    const auto c = static_cast<size_t>(ch);
+                    in[c] = sources[c] != nullptr ? sources[c] + offset : nullptr;
+                    out[c] = ctx.outputChannels[ch] != nullptr ? ctx.outputChannels[ch] + offset : nullptr;
+                }
+                cascade_.process(in.data(), out.data(), channels, count);
             }
-            else
+        }
+
+        // Once the input is silent and the filters have rung out below
+        // kSettledLevel, clear their state so that skipping further silent
+        // blocks is exact rather than truncating a tail.
+        settled_ = false;
+        if (ctx.inputSilent)
+        {
+            float peak = 0.0f;
+            for (int ch = 0; ch < outputs; ++ch)
             {
-                // makePeakFilter handles both boost (gain > 1) and cut (gain < 1).
-                coeffs = juce::dsp::IIR::Coefficients<float>::makePeakFilter(
-                    preparedSampleRate_, band.frequency, band.q,
-                    juce::Decibels::decibelsToGain(band.gainDb));
+                if (const float* dest = ctx.outputChannels[ch])
+                {
+                    const auto range = juce::FloatVectorOperations::findMinAndMax(dest, frames);
+                    peak = std::max({ peak, -range.getStart(), range.getEnd() });
+                }
             }
-            for (auto& f : filters_[static_cast<size_t>(b)])
+
+            if (peak < kSettledLevel)
             {
-                f.coefficients = coeffs;
-                f.reset();
+                cascade_.reset();
+                settled_ = true;
             }
         }
+    }
+
+    void EqualizerNode::updateFilters()
+    {
+        // Jump every band to its settings. The filter state is kept: the new
+        // coefficients are stable, so at worst the transition rings briefly.
+        for (int b = 0; b < kMaxBands; ++b)
+        {
+            auto& smoother = smoothers_[static_cast<size_t>(b)];
+            smoother.frequency.setCurrentAndTargetValue(bands_[static_cast<size_t>(b)].frequency);
+            smoother.gainDb.setCurrentAndTargetValue(targetGainDb(b));
+            smoother.q.setCurrentAndTargetValue(bands_[static_cast<size_t>(b)].q);
+            updateBandCoefficients(b);
+        }
         dirty_ = false;
     }
 
+    float EqualizerNode::targetGainDb(int index) const
+    {
+        const auto& band = bands_[static_cast<size_t>(index)];
+        return band.enabled && index < bandCount_ ? band.gainDb : 0.0f;
+    }
+
+    void EqualizerNode::retargetBand(int index)
+    {
+        const auto& band = bands_[static_cast<size_t>(index)];
+        auto& smoother = smoothers_[static_cast<size_t>(index)];
+        smoother.frequency.setTargetValue(band.frequency);
+        smoother.gainDb.setTargetValue(targetGainDb(index));
+        smoother.q.setTargetValue(band.q);
+        // A band leaving 0 dB, or one whose type or slope changed, has to be
+        // updated before its first step.
+        updateBandCoefficients(index);
+    }
+
+    int EqualizerNode::designBand(const Band& band, double sampleRate, SectionArray& sections)
+    {
+        // ArrayCoefficients computes into a std::array, so nothing here
+        // allocates and the audio thread can call it.
+        using Coefficients = juce::dsp::IIR::ArrayCoefficients<float>;
+
+        // JUCE's designs need the frequency below Nyquist; at 44.1 kHz the
+        // top of the parameter range is already close.
+        const float frequency = std::min(band.frequency, static_cast<float>(sampleRate * 0.49));
+        const float q = band.q;
+        const float gain = juce::Decibels::decibelsToGain(band.gainDb);
+
+        int count = 0;
+        const auto set = [&sections, &count](const std::array<float, 6>& raw)
+        {
+            sections[static_cast<size_t>(count++)] = audio::BiquadCoefficients::fromJuce(raw);
+        };
+
+        switch (band.type)
+        {
+            case BandType::peak:
+                // makePeakFilter handles both boost (gain > 1) and cut (gain < 1).
+                set(Coefficients::makePeakFilter(sampleRate, frequency, q, gain));
+                break;
+            case BandType::lowShelf:
+                set(Coefficients::makeLowShelf(sampleRate, frequency, q, gain));
+                break;
+            case BandType::highShelf:
+                set(Coefficients::makeHighShelf(sampleRate, frequency, q, gain));
+                break;
+            case BandType::lowCut:
+            case BandType::highCut:
+            {
+                // 12 dB/oct keeps the band's Q so the cut can resonate;
+                // steeper slopes are Butterworth, one section per 12 dB.
+                const int order = std::clamp(band.slopeDbPerOctave / 12, 1, kMaxSectionsPerBand);
+                for (int i = 0; i < order; ++i)
+                {
+                    const float sectionQ = order == 1 ? q : butterworthQ(i, order);
+                    set(band.type == BandType::lowCut
+                            ? Coefficients::makeHighPass(sampleRate, frequency, sectionQ)
+                            : Coefficients::makeLowPass(sampleRate, frequency, sectionQ));
+                }
+                break;
+            }
+            case BandType::notch:
+                set(Coefficients::makeNotch(sampleRate, frequency, q));
+                break;
+            case BandType::bandPass:
+                set(Coefficients::makeBandPass(sampleRate, frequency, q));
+                break;
+        }
+        return count;
+    }
+
+    void EqualizerNode::updateBandCoefficients(int index)
+    {
+        const auto& smoother = smoothers_[static_cast<size_t>(index)];
+        auto band = bands_[static_cast<size_t>(index)];
+        band.frequency = smoother.frequency.getCurrentValue();
+        band.gainDb = smoother.gainDb.getCurrentValue();
+        band.q = smoother.q.getCurrentValue();
+        const int firstSection = index * kMaxSectionsPerBand;
+
+        // A peak or shelf band that sits at 0 dB drops out of the cascade
+        // entirely rather than running as a unity section. Their settled
+        // state at unity is zero, so leaving and rejoining at 0 dB is
+        // seamless. The other types drop out as soon as they are switched off.
+        const bool active = hasGain(band.type)
+            ? band.gainDb != 0.0f || smoother.isSmoothing()
+            : band.enabled && index < bandCount_;
+
+        int count = 0;
+        if (active)
+        {
+            SectionArray sections;
+            count = designBand(band, preparedSampleRate_, sections);
+            for (int i = 0; i < count; ++i)
+                cascade_.setCoefficients(firstSection + i, sections[static_cast<size_t>(i)]);
+        }
+
+        for (int i = 0; i < kMaxSectionsPerBand; ++i)
+            cascade_.setEnabled(firstSection + i, i < count);
+    }
+
     std::vector<NodeParameter> EqualizerNode::getParameters() const
     {
         std::vector<NodeParameter> params;
-        params.reserve(static_cast<size_t>(kBandCount) * 4);
-        for (int b = 0; b < kBandCount; ++b)
+        params.reserve(static_cast<size_t>(bandCount_) * kFieldsPerBand + 1);
+        for (int b = 0; b < bandCount_; ++b)
         {
-            const auto& band = bands_[static_cast<size_t>(b)];
-            const auto prefix = "band" + std::to_string(b);
-            params.push_back({ prefix + "_freq", "Band " + std::to_string(b + 1) + " Freq", band.frequency, 20.0, 20000.0, kDefaultFreqs[static_cast<size_t>(b)], true });
-            params.push_back({ prefix + "_gain", "Band " + std::to_string(b + 1) + " Gain", band.gainDb, -24.0, 24.0, 0.0, true });
-            params.push_back({ prefix + "_q", "Band " + std::to_string(b + 1) + " Q", band.q, 0.1, 12.0, 0.707, true });
-            params.push_back({ prefix + "_on", "Band " + std::to_string(b + 1) + " On", band.enabled ? 1.0 : 0.0, 0.0, 1.0, 1.0, false });
+            Band defaults;
+            defaults.frequency = kDefaultFreqs[static_cast<size_t>(b)];
+            appendBandParameters(params, b, bands_[static_cast<size_t>(b)], defaults);
         }
+        params.push_back({ "band_count", "Bands", static_cast<double>(bandCount_), 1.0, kMaxBands, kDefaultBandCount, false });
         return params;
     }
 
@@ -167,18 +374,56 @@ namespace
         // is the live path that routes through the lock-free queue.
         for (const auto& p : parameters)
         {
-            for (int b = 0; b < kBandCount; ++b)
-            {
-                const auto prefix = "band" + std::to_string(b);
-                if (p.id == prefix + "_freq") { bands_[static_cast<size_t>(b)].frequency = static_cast<float>(p.value); }
-                else if (p.id == prefix + "_gain") { bands_[static_cast<size_t>(b)].gainDb = static_cast<float>(p.value); }
-                else if (p.id == prefix + "_q") { bands_[static_cast<size_t>(b)].q = static_cast<float>(p.value); }
-                else if (p.id == prefix + "_on") { bands_[static_cast<size_t>(b)].enabled = p.value > 0.5; }
-            }
+            const auto idx = parameterIndex(p.id);
+            if (idx >= 0)
+                applyField(idx, p.value);
         }
         dirty_ = true;
     }
 
+    void EqualizerNode::applyField(int index, double value)
+    {
+        if (index == kBandCountParamIndex)
+        {
+            bandCount_ = std::clamp(static_cast<int>(std::lround(value)), 1, kMaxBands);
+            return;
+        }
+
+        applyBandField(bands_[static_cast<size_t>(index / kFieldsPerBand)], index % kFieldsPerBand, value);
+    }
+
+    std::string EqualizerNode::bandParameterId(int index, int field)
+    {
+        static constexpr std::array<const char*, kFieldsPerBand> suffixes { "_freq", "_gain", "_q", "_on", "_type", "_slope" };
+        return "band" + std::to_string(index) + suffixes[static_cast<size_t>(std::clamp(field, 0, kFieldsPerBand - 1))];
+    }
+
+    void EqualizerNode::appendBandParameters(std::vector<NodeParameter>& params, int index, const Band& band, const Band& defaults)
+    {
+        const auto label = "Band " + std::to_string(index + 1);
+        params.push_back({ bandParameterId(index, fieldFrequency), label + " Freq", band.frequency, 20.0, 20000.0, defaults.frequency, true });
+        params.push_back({ bandParameterId(index, fieldGain), label + " Gain", band.gainDb, -24.0, 24.0, defaults.gainDb, true });
+        params.push_back({ bandParameterId(index, fieldQ), label + " Q", band.q, 0.1, 12.0, defaults.q, true });
+        params.push_back({ bandParameterId(index, fieldOn), label + " On", band.enabled ? 1.0 : 0.0, 0.0, 1.0, defaults.enabled ? 1.0 : 0.0, false });
+        params.push_back({ bandParameterId(index, fieldType), label + " Type", static_cast<double>(band.type), 0.0, kBandTypeCount - 1.0,
+                           static_cast<double>(defaults.type), false });
+        params.push_back({ bandParameterId(index, fieldSlope), label + " Slope", static_cast<double>(band.slopeDbPerOctave), kMinSlope, kMaxSlope,
+                           static_cast<double>(defaults.slopeDbPerOctave), false });
+    }
+
+    void EqualizerNode::applyBandField(Band& band, int field, double value)
+    {
+        switch (field)
+        {
+            case fieldFrequency: band.frequency = static_cast<float>(value); break;
+            case fieldGain: band.gainDb = static_cast<float>(value); break;
+            case fieldQ: band.q = static_cast<float>(value); break;
+            case fieldOn: band.enabled = value > 0.5; break;
+            case fieldType: band.type = toBandType(value); break;
+            default: band.slopeDbPerOctave = toSlope(value); break;
+        }
+    }
+
     int EqualizerNode::parameterIndex(const std::string& id) const
     {
         for (size_t i = 0; i < paramIds_.size(); ++i)
@@ -205,24 +450,38 @@ namespace
         if (drained_.empty())
             return;
 
-        bool changed = false;
+        // Queue entries carry the index into paramIds_, which lists the
+        // fields of each band in order, so the band and field fall out of it
+        // arithmetically and nothing here allocates. Only the bands that
+        // changed are retargeted; a band count change touches every band
+        // that crossed it.
+        std::array<bool, kMaxBands> changed {};
         for (const auto& entry : drained_)
         {
             const auto idx = static_cast<int>(entry.idHash);
             if (idx < 0 || idx >= static_cast<int>(paramIds_.size()))
                 continue;
-            const auto& id = paramIds_[static_cast<size_t>(idx)];
 
-            for (int b = 0; b < kBandCount; ++b)
+            const int previousCount = bandCount_;
+            applyField(idx, entry.value);
+            if (idx == kBandCountParamIndex)
+            {
+                for (int b = std::min(previousCount, bandCount_); b < std::max(previousCount, bandCount_); ++b)
+                    changed[static_cast<size_t>(b)] = true;
+            }
+            else
             {
-                const auto prefix = "band" + std::to_string(b);
-                if (id == prefix + "_freq") { bands_[static_cast<size_t>(b)].frequency = static_cast<float>(entry.value); changed = true; }
-                else if (id == prefix + "_gain") { bands_[static_cast<size_t>(b)].gainDb = static_cast<float>(entry.value); changed = true; }
-                else if (id == prefix + "_q") { bands_[static_cast<size_t>(b)].q = static_cast<float>(entry.value); changed = true; }
-                else if (id == prefix + "_on") { bands_[static_cast<size_t>(b)].enabled = entry.value > 0.5; changed = true; }
+                changed[static_cast<size_t>(idx / kFieldsPerBand)] = true;
             }
         }
-        if (changed)
-            dirty_ = true;
+
+        // A pending jump from setParameters() wins over a glide.
+        if (dirty_)
+            return;
+        for (int b = 0; b < kMaxBands; ++b)
+        {
+            if (changed[static_cast<size_t>(b)])
+                retargetBand(b);
+        }
     }
 } // namespace host::graph::nodes
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "audio/BiquadCascade.h"
 #include "graph/Node.h"
 #include "graph/ParameterQueue.h"
 
@@ -7,25 +8,45 @@
 
 #include <array>
 #include <atomic>
+#include <cstdint>
 
 namespace host::graph::nodes
 {
-/// Four-band parametric EQ. Each band exposes frequency, gain (dB) and Q,
-/// giving a usable corrective/creative tone shaper without pulling in a
-/// full VST. Implemented on juce::dsp::IIR filters for stability.
+/// Parametric EQ with up to kMaxBands bands (four by default). Each band
+/// has a type plus frequency, gain (dB) and Q, and cut bands a slope, so a
+/// single node covers shelving, cuts and surgical notches without pulling
+/// in a full VST or chaining several EQs. All bands run as one fused biquad
+/// cascade with the channels in SIMD lanes (see audio::BiquadCascade).
 class EqualizerNode : public Node
 {
 public:
-    static constexpr int kBandCount = 4;
-    /// Maximum channels each band filter must handle independently so L/R
-    /// (and beyond) never share IIR delay-line state.
-    static constexpr int kMaxChannels = 2;
+    static constexpr int kMaxBands = 24;
+    static constexpr int kDefaultBandCount = 4;
+    /// Channels filtered independently; matches the graph's channel limit.
+    static constexpr int kMaxChannels = 64;
+    /// Cut slopes run in 12 dB/oct steps, one biquad section each.
+    static constexpr int kMaxSectionsPerBand = 4;
+
+    /// Stored as the band's "_type" parameter value, so the order is part
+    /// of the preset format.
+    enum class BandType : std::uint8_t
+    {
+        peak,
+        lowShelf,
+        highShelf,
+        lowCut,
+        highCut,
+        notch,
+        bandPass
+    };
 
     struct Band
     {
+        BandType type { BandType::peak };
         float frequency { 100.0f };
-        float gainDb { 0.0f };
+        float gainDb { 0.0f };   ///< Peak and shelf bands only
         float q { 0.707f };
+        int slopeDbPerOctave { 12 }; ///< Cut bands only: 12, 24, 36 or 48
         bool enabled { true };
     };
 
@@ -33,27 +54,91 @@ public:
 
     void setBand(int index, const Band& band);
     Band getBand(int index) const;
+    /// Bands at or past the count are off and left out of getParameters().
+    void setBandCount(int count);
+    int getBandCount() const noexcept { return bandCount_; }
+
+    /// A band's parameters, in their order in the parameter list. The ids
+    /// ("band<n>_freq" ...) and this layout are shared with LinearPhaseEqNode,
+    /// so a band's settings read the same in either EQ's preset.
+    enum BandField
+    {
+        fieldFrequency,
+        fieldGain,
+        fieldQ,
+        fieldOn,
+        fieldType,
+        fieldSlope
+    };
+    static constexpr int kFieldsPerBand = 6;
+
+    static std::string bandParameterId(int index, int field);
+    /// Appends the kFieldsPerBand parameters of band `index`, reporting
+    /// `defaults` as their default values.
+    static void appendBandParameters(std::vector<NodeParameter>& params, int index, const Band& band, const Band& defaults);
+    /// Sets one field of `band` from its parameter value; type and slope are
+    /// clamped to values the band designs support.
+    static void applyBandField(Band& band, int field, double value);
+
+    using SectionArray = std::array<audio::BiquadCoefficients, kMaxSectionsPerBand>;
+    /// Designs the biquad sections for `band` (ignoring `enabled`) and
+    /// returns how many of `sections` it filled. Allocation-free.
+    static int designBand(const Band& band, double sampleRate, SectionArray& sections);
 
     void prepare(double sampleRate, int blockSize) override;
     void process(ProcessContext& ctx) override;
     std::string name() const override { return "Equalizer"; }
     std::string typeId() const override { return "Equalizer"; }
+    bool supportsInPlace() const override { return true; }
+    bool isSilentForSilentInput() const override { return settled_; }
     std::vector<NodeParameter> getParameters() const override;
     void setParameters(const std::vector<NodeParameter>& parameters) override;
     void requestParameterChange(const std::string& id, double value) override;
     void applyParameterChanges() override;
 
 private:
+    // paramIds_ lists kFieldsPerBand parameters per band; the band count
+    // follows the last band.
+    static constexpr int kBandCountParamIndex = kMaxBands * kFieldsPerBand;
+
+    // Parameter-domain smoothing for one band: frequency and Q glide
+    // geometrically, gain linearly in dB, and a peak or shelf band switched
+    // off glides to 0 dB before it leaves the cascade. Every intermediate
+    // set of coefficients is a valid filter of the band's type, so a sweep
+    // never passes through an unstable biquad the way interpolating
+    // coefficients directly can. Type and slope changes take effect at once.
+    struct BandSmoother
+    {
+        juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> frequency;
+        juce::SmoothedValue<float> gainDb;
+        juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> q;
+
+        bool isSmoothing() const noexcept { return frequency.isSmoothing() || gainDb.isSmoothing() || q.isSmoothing(); }
+    };
+
     void updateFilters();
+    float targetGainDb(int index) const;
+    void retargetBand(int index);
+    void updateBandCoefficients(int index);
+    void applyField(int index, double value);
     void pushChange(int index, double value);
     int parameterIndex(const std::string& id) const;
 
-    std::array<Band, kBandCount> bands_;
-    // Per-band, per-channel filter so each channel keeps its own IIR state.
-    std::array<std::array<juce::dsp::IIR::Filter<float>, kMaxChannels>, kBandCount> filters_;
+    std::array<Band, kMaxBands> bands_;
+    int bandCount_ { kDefaultBandCount };
+    // kMaxSectionsPerBand sections per band, of which the band's type and
+    // slope switch on as many as they need; per-channel state lives inside
+    // the cascade.
+    audio::BiquadCascade cascade_;
+    std::array<BandSmoother, kMaxBands> smoothers_;
     double preparedSampleRate_ { 44100.0 };
     int preparedChannels_ { kMaxChannels };
+    // Set by setBand/setParameters/prepare: jump straight to the band
+    // settings on the next block. Live changes glide instead.
     bool dirty_ { true };
+    // Audio thread: the input went silent and the filter ringing died away,
+    // so the filter state was cleared and silent blocks can be skipped.
+    bool settled_ { false };
     ParameterQueue queue_;
     std::vector<ParameterQueue::Entry> drained_;
     std::vector<std::string> paramIds_;
@@ -19,7 +19,7 @@ void GainNode::prepare(double sampleRate, int blockSize)
     gainSmoothed_.setCurrentAndTargetValue(gain_.load());
     rampBuffer_.assign(static_cast<size_t>(std::max(1, blockSize)), 0.0f);
     queue_.prepare(GainNode::kParamCount * 2);
-    drained_.reserve(GainNode::kParamCount * 2);
+    drained_.reserve(queue_.capacity());
 }
 
 void GainNode::process(ProcessContext& ctx)
@@ -38,6 +38,14 @@ void GainNode::process(ProcessContext& ctx)
     if (frames == 0 || outputs == 0 || ctx.outputChannels == nullptr)
         return;
 
+    // Fully muted and not ramping (a muted send): report silence instead of
+    // writing zeros, so everything downstream can be skipped as well.
+    if (! gainSmoothed_.isSmoothing() && gainSmoothed_.getCurrentValue() == 0.0f)
+    {
+        ctx.outputSilent = true;
+        return;
+    }
+
     // Compute the ramp once for this block so every channel gets identical
     // per-sample gain values (no L/R drift). Previously getNextValue() was
     // called inside the per-channel loop, so ch1 advanced the ramp further.
@@ -52,16 +60,16 @@ void GainNode::process(ProcessContext& ctx)
         if (dest == nullptr)
             continue;
 
-        // Copy input into output first, since the engine now keeps in/out
-        // buffers separate.
+        // Copy input into output first. When the engine runs the node in
+        // place the two are the same buffer and the copy is skipped.
         if (inputs > 0 && ctx.inputChannels != nullptr)
         {
             const int srcCh = outCh % inputs;
             const float* src = ctx.inputChannels[srcCh];
-            if (src != nullptr)
-                juce::FloatVectorOperations::copy(dest, src, frames);
-            else
+            if (src == nullptr)
                 juce::FloatVectorOperations::clear(dest, frames);
+            else if (src != dest)
+                juce::FloatVectorOperations::copy(dest, src, frames);
         }
         else
         {
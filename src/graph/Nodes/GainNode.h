@@ -19,6 +19,9 @@ public:
     void process(ProcessContext& ctx) override;
     std::string name() const override { return "Gain"; }
     std::string typeId() const override { return "Gain"; }
+    bool supportsInPlace() const override { return true; }
+    bool isSilentForSilentInput() const override { return true; }
+    int tailSamples() const override { return 0; }
     std::vector<NodeParameter> getParameters() const override;
     void setParameters(const std::vector<NodeParameter>& parameters) override;
     void requestParameterChange(const std::string& id, double value) override;
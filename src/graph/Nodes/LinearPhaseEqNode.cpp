@@ -0,0 +1,243 @@
+#include "graph/Nodes/LinearPhaseEqNode.h"
+
+#include "graph/BackgroundRebuild.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace host::graph::nodes
+{
+namespace
+{
+    // Mastering-style defaults: a low and a high cut (off) around six
+    // peak bands spread across the spectrum.
+    constexpr std::array<float, LinearPhaseEqNode::kBandCount> kDefaultFreqs {
+        30.0f, 100.0f, 250.0f, 800.0f, 2500.0f, 6000.0f, 12000.0f, 18000.0f
+    };
+
+    constexpr int kFieldsPerBand = EqualizerNode::kFieldsPerBand;
+
+    // EqualizerNode's band parameters, for the first kBandCount bands.
+    const std::vector<std::string>& paramIds()
+    {
+        static const std::vector<std::string> ids = []
+        {
+            std::vector<std::string> list;
+            for (int b = 0; b < LinearPhaseEqNode::kBandCount; ++b)
+            {
+                for (int field = 0; field < kFieldsPerBand; ++field)
+                    list.push_back(EqualizerNode::bandParameterId(b, field));
+            }
+            return list;
+        }();
+        return ids;
+    }
+
+    // The default layout set up by the constructor.
+    LinearPhaseEqNode::Band defaultBand(int index)
+    {
+        LinearPhaseEqNode::Band band;
+        band.frequency = kDefaultFreqs[static_cast<size_t>(index)];
+        band.gainDb = 0.0f;
+        band.q = 0.707f;
+        band.enabled = true;
+        if (index == 0 || index == LinearPhaseEqNode::kBandCount - 1)
+        {
+            band.type = index == 0 ? LinearPhaseEqNode::BandType::lowCut : LinearPhaseEqNode::BandType::highCut;
+            band.enabled = false;
+        }
+        return band;
+    }
+
+    // |H(e^jw)| of one normalised biquad section.
+    double magnitude(const audio::BiquadCoefficients& c, double w) noexcept
+    {
+        const double cos1 = std::cos(w);
+        const double sin1 = std::sin(w);
+        const double cos2 = std::cos(2.0 * w);
+        const double sin2 = std::sin(2.0 * w);
+        const double numRe = c.b0 + c.b1 * cos1 + c.b2 * cos2;
+        const double numIm = c.b1 * sin1 + c.b2 * sin2;
+        const double denRe = 1.0 + c.a1 * cos1 + c.a2 * cos2;
+        const double denIm = c.a1 * sin1 + c.a2 * sin2;
+        const double den = denRe * denRe + denIm * denIm;
+        return den > 0.0 ? std::sqrt((numRe * numRe + numIm * numIm) / den) : 0.0;
+    }
+}
+
+    LinearPhaseEqNode::LinearPhaseEqNode()
+        : juce::Thread("Linear phase EQ kernel")
+    {
+        for (int b = 0; b < kBandCount; ++b)
+            bands_[static_cast<size_t>(b)] = defaultBand(b);
+    }
+
+    LinearPhaseEqNode::~LinearPhaseEqNode()
+    {
+        signalThreadShouldExit();
+        notify();
+        stopThread(2000);
+    }
+
+    void LinearPhaseEqNode::setBand(int index, const Band& band)
+    {
+        if (index < 0 || index >= kBandCount)
+            return;
+        {
+            const std::lock_guard<std::mutex> lock(settingsMutex_);
+            auto& target = bands_[static_cast<size_t>(index)];
+            target = band;
+            EqualizerNode::applyBandField(target, EqualizerNode::fieldSlope, band.slopeDbPerOctave);
+            ++generation_;
+        }
+        notify();
+    }
+
+    LinearPhaseEqNode::Band LinearPhaseEqNode::getBand(int index) const
+    {
+        if (index < 0 || index >= kBandCount)
+            return {};
+        const std::lock_guard<std::mutex> lock(settingsMutex_);
+        return bands_[static_cast<size_t>(index)];
+    }
+
+    void LinearPhaseEqNode::prepare(double sampleRate, int blockSize)
+    {
+        juce::ignoreUnused(blockSize);
+
+        // The builder publishes into the convolver, which is about to be
+        // reallocated: park it first.
+        signalThreadShouldExit();
+        notify();
+        stopThread(2000);
+
+        std::array<Band, kBandCount> bands;
+        {
+            const std::lock_guard<std::mutex> lock(settingsMutex_);
+            sampleRate_ = sampleRate > 0.0 ? sampleRate : 44100.0;
+            ++generation_;
+            bands = bands_;
+        }
+
+        convolver_.prepare(kPartitionSize, kKernelLength / kPartitionSize, kMaxChannels);
+        convolver_.setKernel(buildKernel(bands, sampleRate > 0.0 ? sampleRate : 44100.0));
+        silentSamples_ = 0;
+
+        startThread(juce::Thread::Priority::low);
+    }
+
+    void LinearPhaseEqNode::process(ProcessContext& ctx)
+    {
+        const int frames = std::max(0, ctx.numFrames);
+        const int inputs = std::max(0, ctx.numInputChannels);
+        const int outputs = std::max(0, ctx.numOutputChannels);
+
+        if (frames == 0 || outputs == 0 || ctx.outputChannels == nullptr)
+            return;
+
+        // The convolver reads every input of a chunk before writing outputs,
+        // so fanned-out inputs and in-place buffers need no copy here.
+        std::array<const float*, static_cast<size_t>(kMaxChannels)> sources {};
+        for (int ch = 0; ch < std::min(outputs, kMaxChannels); ++ch)
+        {
+            sources[static_cast<size_t>(ch)] = (inputs > 0 && ctx.inputChannels != nullptr)
+                ? ctx.inputChannels[ch % inputs]
+                : nullptr;
+        }
+        convolver_.process(sources.data(), ctx.outputChannels, outputs, frames);
+
+        silentSamples_ = ctx.inputSilent ? std::min(silentSamples_ + frames, kKernelLength * 4) : 0;
+    }
+
+    bool LinearPhaseEqNode::isSilentForSilentInput() const
+    {
+        // The collecting window, the spectrum history and the pending output
+        // partition have all been fed zeros by then.
+        return silentSamples_ >= kKernelLength + 2 * kPartitionSize;
+    }
+
+    void LinearPhaseEqNode::run()
+    {
+        runBackgroundRebuild(
+            *this, settingsMutex_, generation_,
+            [this] { return std::make_pair(bands_, sampleRate_); },
+            [](const auto& settings) { return buildKernel(settings.first, settings.second); },
+            [this](auto kernel) { convolver_.publishKernel(std::move(kernel)); });
+    }
+
+    std::unique_ptr<audio::PartitionedConvolver::Kernel> LinearPhaseEqNode::buildKernel(const std::array<Band, kBandCount>& bands,
+                                                                                        double sampleRate)
+    {
+        std::vector<audio::BiquadCoefficients> sections;
+        for (const auto& band : bands)
+        {
+            if (! band.enabled)
+                continue;
+            EqualizerNode::SectionArray designed;
+            const int count = EqualizerNode::designBand(band, sampleRate, designed);
+            sections.insert(sections.end(), designed.begin(), designed.begin() + count);
+        }
+
+        // Zero-phase spectrum: the bands' combined magnitude on every bin.
+        constexpr int length = kKernelLength;
+        std::vector<float> buffer(static_cast<size_t>(2 * length), 0.0f);
+        for (int k = 0; k <= length / 2; ++k)
+        {
+            const double w = juce::MathConstants<double>::twoPi * k / length;
+            double gain = 1.0;
+            for (const auto& section : sections)
+                gain *= magnitude(section, w);
+            buffer[static_cast<size_t>(2 * k)] = static_cast<float>(gain);
+        }
+
+        juce::dsp::FFT transform(audio::PartitionedConvolver::fftOrderFor(length));
+        transform.performRealOnlyInverseTransform(buffer.data());
+
+        // The impulse comes back centred on sample 0 and wrapped; rotate it to
+        // the middle, which is the node's latency, and taper it with a
+        // Blackman window centred there so the truncation does not ripple.
+        std::vector<float> impulse(static_cast<size_t>(length));
+        for (int n = 0; n < length; ++n)
+        {
+            const double phase = juce::MathConstants<double>::twoPi * n / length;
+            const double window = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+            impulse[static_cast<size_t>(n)] = buffer[static_cast<size_t>((n + length / 2) % length)] * static_cast<float>(window);
+        }
+
+        return std::make_unique<audio::PartitionedConvolver::Kernel>(impulse.data(), length, kPartitionSize);
+    }
+
+    std::vector<NodeParameter> LinearPhaseEqNode::getParameters() const
+    {
+        std::array<Band, kBandCount> bands;
+        {
+            const std::lock_guard<std::mutex> lock(settingsMutex_);
+            bands = bands_;
+        }
+
+        std::vector<NodeParameter> params;
+        params.reserve(static_cast<size_t>(kBandCount) * kFieldsPerBand);
+        for (int b = 0; b < kBandCount; ++b)
+            EqualizerNode::appendBandParameters(params, b, bands[static_cast<size_t>(b)], defaultBand(b));
+        return params;
+    }
+
+    void LinearPhaseEqNode::setParameters(const std::vector<NodeParameter>& parameters)
+    {
+        const auto& ids = paramIds();
+        {
+            const std::lock_guard<std::mutex> lock(settingsMutex_);
+            for (const auto& p : parameters)
+            {
+                const auto it = std::find(ids.begin(), ids.end(), p.id);
+                if (it == ids.end())
+                    continue;
+
+                const auto index = static_cast<int>(it - ids.begin());
+                EqualizerNode::applyBandField(bands_[static_cast<size_t>(index / kFieldsPerBand)], index % kFieldsPerBand, p.value);
+            }
+            ++generation_;
+        }
+        notify();
+    }
+} // namespace host::graph::nodes
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "audio/PartitionedConvolver.h"
+#include "graph/Node.h"
+#include "graph/Nodes/EqualizerNode.h"
+
+#include <juce_core/juce_core.h>
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+
+namespace host::graph::nodes
+{
+/// Linear-phase EQ for mastering. The bands are the same designs as
+/// EqualizerNode's, but only their combined magnitude response is kept:
+/// it is turned into a symmetric FIR kernel of kKernelLength taps and
+/// applied with partitioned FFT convolution, so every frequency is delayed
+/// equally and nothing smears in phase.
+///
+/// Band changes never touch the audio thread: a builder thread owned by
+/// the node designs the new kernel and publishes it to the convolver, which
+/// crossfades to it at the next partition. The price is a fixed latency of
+/// half the kernel plus one partition, reported through latencySamples() for
+/// the graph's delay compensation.
+class LinearPhaseEqNode : public Node,
+                          private juce::Thread
+{
+public:
+    static constexpr int kBandCount = 8;
+    static constexpr int kMaxChannels = EqualizerNode::kMaxChannels;
+    /// 4096 taps resolve about 12 Hz at 48 kHz, enough for low shelves and
+    /// cuts down to 30 Hz or so.
+    static constexpr int kKernelLength = 4096;
+    static constexpr int kPartitionSize = 512;
+
+    using Band = EqualizerNode::Band;
+    using BandType = EqualizerNode::BandType;
+
+    LinearPhaseEqNode();
+    ~LinearPhaseEqNode() override;
+
+    void setBand(int index, const Band& band);
+    Band getBand(int index) const;
+
+    void prepare(double sampleRate, int blockSize) override;
+    void process(ProcessContext& ctx) override;
+    int latencySamples() const override { return kPartitionSize + kKernelLength / 2; }
+    std::string name() const override { return "Linear Phase EQ"; }
+    std::string typeId() const override { return "LinearPhaseEQ"; }
+    bool supportsInPlace() const override { return true; }
+    bool isSilentForSilentInput() const override;
+    int tailSamples() const override { return kKernelLength / 2 + kPartitionSize; }
+    /// Parameters are only read by the builder thread, so changes go
+    /// straight to it (through the default requestParameterChange) rather
+    /// than through a ParameterQueue.
+    std::vector<NodeParameter> getParameters() const override;
+    void setParameters(const std::vector<NodeParameter>& parameters) override;
+
+private:
+    void run() override;
+    static std::unique_ptr<audio::PartitionedConvolver::Kernel> buildKernel(const std::array<Band, kBandCount>& bands,
+                                                                            double sampleRate);
+
+    // Guards bands_, sampleRate_ and generation_ between the message thread
+    // and the builder thread; the audio thread never takes it.
+    mutable std::mutex settingsMutex_;
+    std::array<Band, kBandCount> bands_;
+    double sampleRate_ { 44100.0 };
+    // Bumped on every change; see runBackgroundRebuild().
+    std::uint64_t generation_ { 0 };
+
+    audio::PartitionedConvolver convolver_;
+    // Audio thread: consecutive silent input samples, so the node can report
+    // silence once the convolver's history is all zeros.
+    int silentSamples_ { 0 };
+};
+} // namespace host::graph::nodes
@@ -96,6 +96,7 @@ namespace host::graph::nodes
         }
 
         std::string name() const override { return "Merge"; }
+        bool isSilentForSilentInput() const override { return true; }
 
     private:
         std::vector<float> monoScratch_;
@@ -101,6 +101,7 @@ namespace host::graph::nodes
         }
 
         std::string name() const override { return "Mix"; }
+        bool isSilentForSilentInput() const override { return true; }
 
     private:
         static constexpr int kMaxChannels = 64;
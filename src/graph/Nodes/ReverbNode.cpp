@@ -1,5 +1,8 @@
 #include "graph/Nodes/ReverbNode.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace host::graph::nodes
 {
     namespace
@@ -10,6 +13,17 @@ namespace host::graph::nodes
         const std::array<std::string, 6> kParamIds {
             "roomSize", "damping", "wet", "dry", "width", "freeze"
         };
+
+        // juce::Reverb (Freeverb) internals used to bound the tail: comb
+        // feedback is roomSize * 0.28 + 0.7, the longest comb plus stereo
+        // spread is 1640 samples and the allpass chain 1563 samples, all at
+        // 44.1 kHz. Damping only shortens the decay, so it is ignored.
+        constexpr double kCombFeedbackScale = 0.28;
+        constexpr double kCombFeedbackOffset = 0.7;
+        constexpr double kLongestCombAt44k = 1640.0;
+        constexpr double kAllpassChainAt44k = 1563.0;
+        // Decay (-120 dB) after which the tail counts as gone.
+        constexpr double kTailFloor = 1.0e-6;
     }
 
     ReverbNode::ReverbNode()
@@ -20,11 +34,12 @@ namespace host::graph::nodes
     void ReverbNode::prepare(double sampleRate, int blockSize)
     {
         juce::ignoreUnused(blockSize);
-        reverb_.setSampleRate(sampleRate > 0.0 ? sampleRate : 44100.0);
+        preparedSampleRate_ = sampleRate > 0.0 ? sampleRate : 44100.0;
+        reverb_.setSampleRate(preparedSampleRate_);
         // Pre-allocate the mono scratch buffer so process() never allocates.
         monoScratch_.assign(static_cast<size_t>(std::max(1, blockSize)), 0.0f);
         queue_.prepare(ReverbNode::kParamCount * 2);
-        drained_.reserve(ReverbNode::kParamCount * 2);
+        drained_.reserve(queue_.capacity());
         applyParameters();
     }
 
@@ -52,10 +67,10 @@ namespace host::graph::nodes
                 ? ctx.inputChannels[ch % inputs]
                 : nullptr;
 
-            if (src != nullptr)
-                juce::FloatVectorOperations::copy(dest, src, frames);
-            else
+            if (src == nullptr)
                 juce::FloatVectorOperations::clear(dest, frames);
+            else if (src != dest)
+                juce::FloatVectorOperations::copy(dest, src, frames);
         }
 
         // juce::Reverb processes stereo in place. When only one channel is
@@ -75,6 +90,20 @@ namespace host::graph::nodes
         }
     }
 
+    int ReverbNode::tailSamples() const
+    {
+        if (frozen_.load())
+            return kInfiniteTail;
+        if (wetLevel_.load() <= 0.0f)
+            return 0;
+
+        const double feedback = std::clamp(static_cast<double>(roomSize_.load()), 0.0, 1.0)
+                                * kCombFeedbackScale + kCombFeedbackOffset;
+        const double combPasses = std::log(kTailFloor) / std::log(feedback);
+        const double scale = preparedSampleRate_ / 44100.0;
+        return static_cast<int>(std::ceil((combPasses * kLongestCombAt44k + kAllpassChainAt44k) * scale));
+    }
+
     void ReverbNode::applyParameters()
     {
         params_.roomSize = roomSize_.load();
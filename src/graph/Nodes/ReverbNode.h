@@ -23,6 +23,8 @@ public:
     void process(ProcessContext& ctx) override;
     std::string name() const override { return "Reverb"; }
     std::string typeId() const override { return "Reverb"; }
+    bool supportsInPlace() const override { return true; }
+    int tailSamples() const override;
     std::vector<NodeParameter> getParameters() const override;
     void setParameters(const std::vector<NodeParameter>& parameters) override;
     void requestParameterChange(const std::string& id, double value) override;
@@ -40,6 +42,7 @@ private:
     std::atomic<float> dryLevel_ { 0.4f };
     std::atomic<float> width_ { 1.0f };
     std::atomic<bool> frozen_ { false };
+    double preparedSampleRate_ { 44100.0 };
     bool dirty_ { true };
     ParameterQueue queue_;
     std::vector<ParameterQueue::Entry> drained_;
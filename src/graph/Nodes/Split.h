@@ -48,5 +48,6 @@ namespace host::graph::nodes
         }
 
         std::string name() const override { return "Split"; }
+        bool isSilentForSilentInput() const override { return true; }
     };
 }
@@ -1,5 +1,7 @@
 #include "graph/Nodes/VstFx.h"
 
+#include <algorithm>
+#include <cmath>
 #include <utility>
 
 namespace host::graph::nodes
@@ -25,10 +27,19 @@ namespace host::graph::nodes
             instance_->prepare(sampleRate, blockSize);
     }
 
+    void VstFxNode::setNonRealtime(bool isNonRealtime)
+    {
+        if (instance_)
+            instance_->setNonRealtime(isNonRealtime);
+    }
+
     void VstFxNode::process(ProcessContext& ctx)
     {
         if (! instance_)
+        {
+            ctx.outputSilent = true;
             return;
+        }
 
         // Bypass must still forward the input to the output. Previously this
         // returned immediately, leaving the node's output buffer untouched and
@@ -54,7 +65,8 @@ namespace host::graph::nodes
                     const float* src = ctx.inputChannels[srcCh];
                     if (src != nullptr)
                     {
-                        juce::FloatVectorOperations::copy(dest, src, frames);
+                        if (src != dest)
+                            juce::FloatVectorOperations::copy(dest, src, frames);
                         continue;
                     }
                 }
@@ -75,6 +87,17 @@ namespace host::graph::nodes
         return instance_ ? instance_->latencySamples() : 0;
     }
 
+    int VstFxNode::tailSamples() const
+    {
+        if (! instance_ || bypassed_.load())
+            return 0;
+
+        const double tail = instance_->tailLengthSeconds() * preparedSampleRate_;
+        if (! std::isfinite(tail) || tail >= static_cast<double>(kInfiniteTail))
+            return kInfiniteTail;
+        return static_cast<int>(std::ceil(std::max(0.0, tail)));
+    }
+
     int VstFxNode::inputChannelCount() const
     {
         if (pluginInfo_.has_value() && pluginInfo_->ins > 0)
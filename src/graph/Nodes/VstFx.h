@@ -27,6 +27,11 @@ namespace host::graph::nodes
        std::string name() const override;
         int inputChannelCount() const override;
         int outputChannelCount() const override;
+        // The plug-in instance copies through its own process buffer, so
+        // aliased input/output pointers are safe.
+        bool supportsInPlace() const override { return true; }
+        int tailSamples() const override;
+        void setNonRealtime(bool isNonRealtime) override;
         void setDisplayName(std::string newName);
 
         [[nodiscard]] host::plugin::PluginInstance* plugin() const noexcept { return instance_.get(); }
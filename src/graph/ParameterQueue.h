@@ -80,19 +80,28 @@ public:
     /// project load, before the node is prepared).
     bool isPrepared() const noexcept { return ! ring_.empty(); }
 
-    /// Audio thread: drain all pending changes into `out`.
+    /// Ring size chosen by prepare(). Reserve the drain vector to this so one
+    /// drain() can always empty a full queue.
+    std::size_t capacity() const noexcept { return ring_.size(); }
+
+    /// Audio thread: drain pending changes into `out`, at most as many as
+    /// it has capacity for so it never reallocates here - callers reserve it
+    /// to capacity() in prepare(), after preparing the queue, so nothing is
+    /// ever left over. A smaller reservation leaves the rest queued for the
+    /// next block.
     void drain(std::vector<Entry>& out)
     {
         out.clear();
+        const auto limit = out.capacity();
         const auto h = head_.load(std::memory_order_acquire);
-        const auto t = tail_.load(std::memory_order_relaxed);
+        const auto t = tail_.load(std::memory_order_acquire);
         std::size_t i = h;
-        while (i != t)
+        while (i != t && out.size() < limit)
         {
             out.push_back(ring_[i]);
             i = (i + 1) % capacity_;
         }
-        head_.store(t, std::memory_order_release);
+        head_.store(i, std::memory_order_release);
     }
 
 private:
@@ -0,0 +1,482 @@
+#include "graph/RealtimeChecker.h"
+
+#if VSTHOST_REALTIME_CHECKS
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if JUCE_WINDOWS
+ #if defined(_DEBUG)
+  #include <crtdbg.h>
+  #define VSTHOST_RT_HOOK_CRT 1
+ #endif
+ #include <malloc.h>
+extern "C" __declspec(dllimport) unsigned short __stdcall RtlCaptureStackBackTrace(unsigned long framesToSkip,
+                                                                                   unsigned long framesToCapture,
+                                                                                   void** backTrace,
+                                                                                   unsigned long* backTraceHash);
+#else
+ #include <execinfo.h>
+ #if defined(__GLIBC__)
+  #include <dlfcn.h>
+  #include <pthread.h>
+  #define VSTHOST_RT_HOOK_MALLOC 1
+  #define VSTHOST_RT_HOOK_PTHREAD 1
+extern "C" void* __libc_malloc(std::size_t);
+extern "C" void* __libc_calloc(std::size_t, std::size_t);
+extern "C" void* __libc_realloc(void*, std::size_t);
+extern "C" void __libc_free(void*);
+ #endif
+#endif
+
+namespace host::graph
+{
+namespace
+{
+// Per logNewViolations() call; the rest are summarised as a count.
+constexpr std::size_t kMaxLoggedViolations = 8;
+// Hook and recorder frames at the top of every captured stack.
+constexpr int kSkippedFrames = 3;
+
+struct ThreadState
+{
+    int depth = 0;
+    std::uint64_t node = 0; // index + 1 << 32 | generation, 0 = none
+    bool inHook = false;    // Set while recording or inside a replaced operator
+};
+
+thread_local ThreadState threadState;
+
+struct ViolationSlot
+{
+    // Written last with release; a reader that sees the sequence it expects
+    // before and after copying has a consistent entry.
+    std::atomic<std::uint64_t> sequence { 0 };
+    std::atomic<std::uint8_t> kind { 0 };
+    std::atomic<std::uint64_t> node { 0 };
+    std::atomic<std::size_t> bytes { 0 };
+    std::atomic<int> depth { 0 };
+    std::array<std::atomic<void*>, RealtimeChecker::kMaxStackFrames> frames {};
+};
+
+std::array<ViolationSlot, RealtimeChecker::kMaxViolations> violations;
+std::atomic<std::uint64_t> violationCount { 0 };
+std::atomic<std::uint64_t> allocationCount { 0 };
+std::atomic<std::uint64_t> deallocationCount { 0 };
+std::atomic<std::uint64_t> lockCount { 0 };
+std::uint64_t lastLoggedViolation = 0; // Message thread only
+
+[[nodiscard]] std::uint64_t packHandle(GraphEngine::NodeHandle handle) noexcept
+{
+    return handle.isValid() ? (static_cast<std::uint64_t>(handle.index + 1) << 32) | handle.generation : 0;
+}
+
+[[nodiscard]] GraphEngine::NodeHandle unpackHandle(std::uint64_t packed) noexcept
+{
+    GraphEngine::NodeHandle handle;
+    if (packed != 0)
+    {
+        handle.index = static_cast<std::uint32_t>(packed >> 32) - 1;
+        handle.generation = static_cast<std::uint32_t>(packed);
+    }
+    return handle;
+}
+
+int captureStack(void** frames, int maxFrames) noexcept
+{
+#if JUCE_WINDOWS
+    return static_cast<int>(RtlCaptureStackBackTrace(0, static_cast<unsigned long>(maxFrames), frames, nullptr));
+#else
+    return backtrace(frames, maxFrames);
+#endif
+}
+
+/// Keeps the replaced operators from being reported a second time by the
+/// malloc hooks underneath them.
+struct HookGuard
+{
+    HookGuard() noexcept : owner(! threadState.inHook) { threadState.inHook = true; }
+    ~HookGuard() noexcept
+    {
+        if (owner)
+            threadState.inHook = false;
+    }
+
+    bool owner;
+};
+
+void record(RealtimeChecker::ViolationKind kind, std::size_t bytes) noexcept
+{
+    auto& state = threadState;
+    if (state.depth == 0 || state.inHook)
+        return;
+
+    const HookGuard guard;
+
+    switch (kind)
+    {
+        case RealtimeChecker::ViolationKind::allocation: allocationCount.fetch_add(1, std::memory_order_relaxed); break;
+        case RealtimeChecker::ViolationKind::deallocation: deallocationCount.fetch_add(1, std::memory_order_relaxed); break;
+        case RealtimeChecker::ViolationKind::lock: lockCount.fetch_add(1, std::memory_order_relaxed); break;
+    }
+
+    // Worker threads record too, so the sequence needs a real increment.
+    const auto sequence = violationCount.fetch_add(1, std::memory_order_relaxed) + 1;
+    auto& slot = violations[static_cast<size_t>((sequence - 1) % RealtimeChecker::kMaxViolations)];
+
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::array<void*, RealtimeChecker::kMaxStackFrames + kSkippedFrames> frames {};
+    const int captured = captureStack(frames.data(), static_cast<int>(frames.size()));
+    const int depth = std::max(0, captured - kSkippedFrames);
+    for (int i = 0; i < depth; ++i)
+        slot.frames[static_cast<size_t>(i)].store(frames[static_cast<size_t>(i + kSkippedFrames)], std::memory_order_relaxed);
+
+    slot.kind.store(static_cast<std::uint8_t>(kind), std::memory_order_relaxed);
+    slot.node.store(state.node, std::memory_order_relaxed);
+    slot.bytes.store(bytes, std::memory_order_relaxed);
+    slot.depth.store(depth, std::memory_order_relaxed);
+    slot.sequence.store(sequence, std::memory_order_release);
+}
+
+[[nodiscard]] const char* describe(RealtimeChecker::ViolationKind kind) noexcept
+{
+    switch (kind)
+    {
+        case RealtimeChecker::ViolationKind::allocation: return "allocation";
+        case RealtimeChecker::ViolationKind::deallocation: return "deallocation";
+        case RealtimeChecker::ViolationKind::lock: return "mutex lock";
+    }
+    return "violation";
+}
+
+[[nodiscard]] juce::StringArray symbolise(const std::vector<void*>& stack)
+{
+    juce::StringArray lines;
+#if JUCE_WINDOWS
+    // Resolve against the PDB in a debugger; dbghelp is not worth linking
+    // for a diagnostic.
+    for (auto* frame : stack)
+        lines.add("0x" + juce::String::toHexString(static_cast<juce::pointer_sized_int>(reinterpret_cast<std::uintptr_t>(frame))));
+#else
+    if (stack.empty())
+        return lines;
+
+    if (char** symbols = backtrace_symbols(stack.data(), static_cast<int>(stack.size())))
+    {
+        for (size_t i = 0; i < stack.size(); ++i)
+            lines.add(symbols[i]);
+        std::free(symbols);
+    }
+#endif
+    return lines;
+}
+
+#if VSTHOST_RT_HOOK_CRT
+int crtAllocHook(int allocType, void*, std::size_t size, int blockType, long, const unsigned char*, int)
+{
+    // The CRT's own bookkeeping blocks are not the caller's doing.
+    if (blockType == _CRT_BLOCK)
+        return 1;
+
+    if (allocType == _HOOK_FREE)
+        record(RealtimeChecker::ViolationKind::deallocation, 0);
+    else
+        record(RealtimeChecker::ViolationKind::allocation, size);
+    return 1;
+}
+#endif
+
+#if VSTHOST_RT_HOOK_PTHREAD
+using MutexFunction = int (*)(pthread_mutex_t*);
+std::atomic<MutexFunction> realMutexLock { nullptr };
+std::atomic<MutexFunction> realMutexTryLock { nullptr };
+
+/// The hooks can run before static initialisation reaches this file, so the
+/// real functions are looked up on first use.
+MutexFunction resolve(std::atomic<MutexFunction>& cached, const char* name) noexcept
+{
+    auto function = cached.load(std::memory_order_acquire);
+    if (function == nullptr)
+    {
+        function = reinterpret_cast<MutexFunction>(dlsym(RTLD_NEXT, name));
+        cached.store(function, std::memory_order_release);
+    }
+    return function;
+}
+#endif
+
+/// Installs the hooks and resolves everything that would otherwise allocate
+/// or lock the first time it is used on an audio thread.
+struct Installer
+{
+    Installer()
+    {
+#if VSTHOST_RT_HOOK_PTHREAD
+        juce::ignoreUnused(resolve(realMutexLock, "pthread_mutex_lock"),
+                           resolve(realMutexTryLock, "pthread_mutex_trylock"));
+#endif
+#if VSTHOST_RT_HOOK_CRT
+        _CrtSetAllocHook(crtAllocHook);
+#endif
+        // backtrace() loads the unwinder on first use.
+        std::array<void*, 4> frames {};
+        juce::ignoreUnused(captureStack(frames.data(), static_cast<int>(frames.size())));
+    }
+};
+
+const Installer installer;
+
+void* allocate(std::size_t size)
+{
+    record(RealtimeChecker::ViolationKind::allocation, size);
+    const HookGuard guard;
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* allocateAligned(std::size_t size, std::align_val_t alignment)
+{
+    record(RealtimeChecker::ViolationKind::allocation, size);
+    const HookGuard guard;
+    const auto align = std::max(static_cast<std::size_t>(alignment), sizeof(void*));
+#if JUCE_WINDOWS
+    return _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+    void* result = nullptr;
+    return posix_memalign(&result, align, size == 0 ? 1 : size) == 0 ? result : nullptr;
+#endif
+}
+
+void release(void* pointer) noexcept
+{
+    if (pointer == nullptr)
+        return;
+
+    record(RealtimeChecker::ViolationKind::deallocation, 0);
+    const HookGuard guard;
+    std::free(pointer);
+}
+
+void releaseAligned(void* pointer) noexcept
+{
+    if (pointer == nullptr)
+        return;
+
+    record(RealtimeChecker::ViolationKind::deallocation, 0);
+    const HookGuard guard;
+#if JUCE_WINDOWS
+    _aligned_free(pointer);
+#else
+    std::free(pointer);
+#endif
+}
+
+void* allocateOrThrow(std::size_t size)
+{
+    if (auto* result = allocate(size))
+        return result;
+    throw std::bad_alloc();
+}
+
+void* allocateAlignedOrThrow(std::size_t size, std::align_val_t alignment)
+{
+    if (auto* result = allocateAligned(size, alignment))
+        return result;
+    throw std::bad_alloc();
+}
+} // namespace
+
+RealtimeChecker::Scope::Scope(GraphEngine::NodeHandle node) noexcept
+    : previousNode(threadState.node)
+{
+    ++threadState.depth;
+    if (node.isValid())
+        threadState.node = packHandle(node);
+}
+
+RealtimeChecker::Scope::~Scope() noexcept
+{
+    threadState.node = previousNode;
+    --threadState.depth;
+}
+
+RealtimeChecker::Counts RealtimeChecker::getCounts() noexcept
+{
+    Counts counts;
+    counts.allocations = allocationCount.load(std::memory_order_relaxed);
+    counts.deallocations = deallocationCount.load(std::memory_order_relaxed);
+    counts.locks = lockCount.load(std::memory_order_relaxed);
+    return counts;
+}
+
+std::uint64_t RealtimeChecker::getViolationCount() noexcept
+{
+    return violationCount.load(std::memory_order_acquire);
+}
+
+std::vector<RealtimeChecker::Violation> RealtimeChecker::getViolationsSince(std::uint64_t afterSequence)
+{
+    const auto newest = violationCount.load(std::memory_order_acquire);
+    const auto oldestAvailable = newest > static_cast<std::uint64_t>(kMaxViolations) ? newest - kMaxViolations + 1 : 1;
+    const auto first = std::max(afterSequence + 1, oldestAvailable);
+
+    std::vector<Violation> result;
+    if (first > newest)
+        return result;
+
+    result.reserve(static_cast<size_t>(newest - first + 1));
+    for (auto sequence = first; sequence <= newest; ++sequence)
+    {
+        const auto& slot = violations[static_cast<size_t>((sequence - 1) % kMaxViolations)];
+        if (slot.sequence.load(std::memory_order_acquire) != sequence)
+            continue;
+
+        Violation violation;
+        violation.sequence = sequence;
+        violation.kind = static_cast<ViolationKind>(slot.kind.load(std::memory_order_relaxed));
+        violation.node = unpackHandle(slot.node.load(std::memory_order_relaxed));
+        violation.bytes = slot.bytes.load(std::memory_order_relaxed);
+        const int depth = std::clamp(slot.depth.load(std::memory_order_relaxed), 0, kMaxStackFrames);
+        for (int i = 0; i < depth; ++i)
+            violation.stack.push_back(slot.frames[static_cast<size_t>(i)].load(std::memory_order_relaxed));
+
+        // Overwritten while copying: the entry is gone, drop it.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+            continue;
+
+        result.push_back(std::move(violation));
+    }
+    return result;
+}
+
+void RealtimeChecker::logNewViolations(const GraphEngine* graph)
+{
+    const auto newest = getViolationCount();
+    if (newest <= lastLoggedViolation)
+        return;
+
+    const auto found = getViolationsSince(lastLoggedViolation);
+    const auto newViolations = newest - lastLoggedViolation;
+    lastLoggedViolation = newest;
+
+    const auto listed = std::min(found.size(), kMaxLoggedViolations);
+    for (size_t i = 0; i < listed; ++i)
+    {
+        const auto& violation = found[i];
+        juce::String line = "Realtime violation #" + juce::String(static_cast<juce::int64>(violation.sequence)) + ": "
+                            + describe(violation.kind);
+        if (violation.bytes > 0)
+            line << " of " << juce::String(static_cast<juce::int64>(violation.bytes)) << " bytes";
+
+        juce::String where = "the graph runtime";
+        if (graph != nullptr && violation.node.isValid())
+        {
+            if (auto node = graph->getNode(violation.node))
+                where = "node '" + juce::String(node->name()) + "'";
+        }
+        line << " in " << where;
+
+        for (const auto& frame : symbolise(violation.stack))
+            line << "\n    " << frame;
+
+        juce::Logger::writeToLog(line);
+    }
+
+    if (newViolations > listed)
+        juce::Logger::writeToLog("Realtime violations not listed: "
+                                 + juce::String(static_cast<juce::int64>(newViolations - listed)));
+
+    const auto counts = getCounts();
+    juce::Logger::writeToLog("Realtime violations so far: " + juce::String(static_cast<juce::int64>(counts.allocations))
+                             + " allocations, " + juce::String(static_cast<juce::int64>(counts.deallocations))
+                             + " deallocations, " + juce::String(static_cast<juce::int64>(counts.locks)) + " locks");
+}
+} // namespace host::graph
+
+// ----------------------------------------------------------------- hooks
+
+void* operator new(std::size_t size) { return host::graph::allocateOrThrow(size); }
+void* operator new[](std::size_t size) { return host::graph::allocateOrThrow(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return host::graph::allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return host::graph::allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return host::graph::allocateAlignedOrThrow(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return host::graph::allocateAlignedOrThrow(size, alignment); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return host::graph::allocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return host::graph::allocateAligned(size, alignment); }
+
+void operator delete(void* pointer) noexcept { host::graph::release(pointer); }
+void operator delete[](void* pointer) noexcept { host::graph::release(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { host::graph::release(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { host::graph::release(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { host::graph::release(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { host::graph::release(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { host::graph::releaseAligned(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { host::graph::releaseAligned(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { host::graph::releaseAligned(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { host::graph::releaseAligned(pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { host::graph::releaseAligned(pointer); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { host::graph::releaseAligned(pointer); }
+
+#if VSTHOST_RT_HOOK_MALLOC
+extern "C"
+{
+void* malloc(std::size_t size) noexcept
+{
+    host::graph::record(host::graph::RealtimeChecker::ViolationKind::allocation, size);
+    return __libc_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size) noexcept
+{
+    host::graph::record(host::graph::RealtimeChecker::ViolationKind::allocation, count * size);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, std::size_t size) noexcept
+{
+    host::graph::record(host::graph::RealtimeChecker::ViolationKind::allocation, size);
+    return __libc_realloc(pointer, size);
+}
+
+void free(void* pointer) noexcept
+{
+    if (pointer != nullptr)
+        host::graph::record(host::graph::RealtimeChecker::ViolationKind::deallocation, 0);
+    __libc_free(pointer);
+}
+}
+#endif
+
+#if VSTHOST_RT_HOOK_PTHREAD
+extern "C"
+{
+int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+{
+    host::graph::record(host::graph::RealtimeChecker::ViolationKind::lock, 0);
+    return host::graph::resolve(host::graph::realMutexLock, "pthread_mutex_lock")(mutex);
+}
+
+int pthread_mutex_trylock(pthread_mutex_t* mutex) noexcept
+{
+    host::graph::record(host::graph::RealtimeChecker::ViolationKind::lock, 0);
+    return host::graph::resolve(host::graph::realMutexTryLock, "pthread_mutex_trylock")(mutex);
+}
+}
+#endif
+
+#else // VSTHOST_REALTIME_CHECKS
+
+namespace host::graph
+{
+RealtimeChecker::Counts RealtimeChecker::getCounts() noexcept { return {}; }
+std::uint64_t RealtimeChecker::getViolationCount() noexcept { return 0; }
+std::vector<RealtimeChecker::Violation> RealtimeChecker::getViolationsSince(std::uint64_t) { return {}; }
+void RealtimeChecker::logNewViolations(const GraphEngine*) {}
+} // namespace host::graph
+
+#endif // VSTHOST_REALTIME_CHECKS
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "graph/GraphEngine.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#ifndef VSTHOST_REALTIME_CHECKS
+ #define VSTHOST_REALTIME_CHECKS 0
+#endif
+
+namespace host::graph
+{
+/// Instrumented-build check that nothing under GraphEngine::process
+/// allocates, frees or takes a lock. Enabled with the CMake option
+/// VSTHOST_REALTIME_CHECKS; without it every call here compiles to nothing
+/// and no global hook is installed.
+///
+/// While a Scope is alive the calling thread counts as an audio thread, and
+/// each trapped call is counted and logged with the node it happened in and
+/// a short stack. What is trapped depends on the platform:
+///   - operator new/delete everywhere (the global operators are replaced);
+///   - malloc/calloc/realloc/free on glibc, and through the debug CRT's
+///     allocation hook in MSVC debug builds;
+///   - pthread_mutex_lock/trylock on glibc, which covers std::mutex and
+///     juce::CriticalSection there. Locks are not trapped on Windows or
+///     macOS.
+///
+/// Meant as a regression harness: run the CLI host or the app with this
+/// build and any new audio-thread allocation shows up by node name.
+class RealtimeChecker
+{
+public:
+    enum class ViolationKind : std::uint8_t
+    {
+        allocation,
+        deallocation,
+        lock
+    };
+
+    static constexpr int kMaxStackFrames = 16;
+    static constexpr int kMaxViolations = 128;
+
+    struct Violation
+    {
+        std::uint64_t sequence { 0 };
+        ViolationKind kind { ViolationKind::allocation };
+        GraphEngine::NodeHandle node; ///< Invalid: graph runtime code outside any node
+        std::size_t bytes { 0 };      ///< Allocations only, when known
+        std::vector<void*> stack;
+    };
+
+    struct Counts
+    {
+        std::uint64_t allocations { 0 };
+        std::uint64_t deallocations { 0 };
+        std::uint64_t locks { 0 };
+
+        [[nodiscard]] std::uint64_t total() const noexcept { return allocations + deallocations + locks; }
+    };
+
+    /// Marks the calling thread as an audio thread for its lifetime and
+    /// attributes violations to `node`. Nests; the innermost node wins.
+    class Scope
+    {
+    public:
+#if VSTHOST_REALTIME_CHECKS
+        explicit Scope(GraphEngine::NodeHandle node = {}) noexcept;
+        ~Scope() noexcept;
+#else
+        explicit Scope(GraphEngine::NodeHandle = {}) noexcept {}
+#endif
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+#if VSTHOST_REALTIME_CHECKS
+    private:
+        std::uint64_t previousNode;
+#endif
+    };
+
+    [[nodiscard]] static constexpr bool isAvailable() noexcept { return VSTHOST_REALTIME_CHECKS != 0; }
+
+    [[nodiscard]] static Counts getCounts() noexcept;
+    /// Violations newer than `afterSequence`, oldest first. Ones the ring
+    /// has already overwritten are skipped.
+    [[nodiscard]] static std::vector<Violation> getViolationsSince(std::uint64_t afterSequence);
+    [[nodiscard]] static std::uint64_t getViolationCount() noexcept;
+
+    /// Message thread: write new violations with their stacks to the current
+    /// juce::Logger, naming nodes through `graph` (may be null).
+    static void logNewViolations(const GraphEngine* graph);
+};
+} // namespace host::graph
@@ -0,0 +1,113 @@
+#include "graph/WorkerPool.h"
+
+#include <algorithm>
+
+namespace host::graph
+{
+namespace
+{
+// Iterations a worker spins on the generation counter before parking. Long
+// enough to catch back-to-back small blocks without a futex wake, short
+// enough that idle workers don't burn a core between callbacks.
+constexpr int kSpinIterations = 1024;
+constexpr int kStopTimeoutMs = 1000;
+} // namespace
+
+class WorkerPool::Worker final : public juce::Thread
+{
+public:
+    Worker(WorkerPool& poolIn, int participantIndexIn)
+        : juce::Thread("Graph worker " + juce::String(participantIndexIn))
+        , pool(poolIn)
+        , participantIndex(participantIndexIn)
+    {
+    }
+
+    void run() override
+    {
+        pool.workerLoop(*this, participantIndex);
+    }
+
+private:
+    WorkerPool& pool;
+    const int participantIndex;
+};
+
+WorkerPool::WorkerPool(int numWorkers)
+{
+    workers_.reserve(static_cast<size_t>(std::max(0, numWorkers)));
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        auto worker = std::make_unique<Worker>(*this, i + 1);
+        // Workers share the device callback's deadline, so ask for realtime
+        // scheduling. Without the privilege (e.g. no rtkit on Linux) fall
+        // back to the highest normal priority rather than failing.
+        if (! worker->startRealtimeThread(juce::Thread::RealtimeOptions {}))
+            worker->startThread(juce::Thread::Priority::highest);
+        workers_.push_back(std::move(worker));
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    shuttingDown_.store(true, std::memory_order_release);
+    for (auto& worker : workers_)
+        worker->signalThreadShouldExit();
+
+    generation_.fetch_add(1, std::memory_order_release);
+    generation_.notify_all();
+
+    for (auto& worker : workers_)
+        worker->stopThread(kStopTimeoutMs);
+}
+
+void WorkerPool::run(JobFunction job, void* context) noexcept
+{
+    job_.store(job, std::memory_order_relaxed);
+    context_.store(context, std::memory_order_relaxed);
+    jobOpen_.store(true, std::memory_order_seq_cst);
+
+    generation_.fetch_add(1, std::memory_order_release);
+    generation_.notify_all();
+
+    job(context, 0);
+
+    // Close the job, then wait for stragglers. A worker that registers as busy
+    // after this point sees jobOpen_ == false and leaves without touching the
+    // job, so once busyWorkers_ reads zero the caller owns the state again.
+    jobOpen_.store(false, std::memory_order_seq_cst);
+    while (busyWorkers_.load(std::memory_order_seq_cst) != 0)
+        cpuRelax();
+}
+
+void WorkerPool::workerLoop(Worker& worker, int participantIndex)
+{
+    auto seen = generation_.load(std::memory_order_acquire);
+
+    while (! worker.threadShouldExit() && ! shuttingDown_.load(std::memory_order_acquire))
+    {
+        auto current = generation_.load(std::memory_order_acquire);
+        for (int spin = 0; current == seen && spin < kSpinIterations; ++spin)
+        {
+            cpuRelax();
+            current = generation_.load(std::memory_order_acquire);
+        }
+
+        if (current == seen)
+        {
+            generation_.wait(seen, std::memory_order_acquire);
+            continue;
+        }
+
+        seen = current;
+
+        busyWorkers_.fetch_add(1, std::memory_order_seq_cst);
+        if (jobOpen_.load(std::memory_order_seq_cst))
+        {
+            if (auto* job = job_.load(std::memory_order_acquire))
+                job(context_.load(std::memory_order_acquire), participantIndex);
+        }
+        busyWorkers_.fetch_sub(1, std::memory_order_seq_cst);
+    }
+}
+} // namespace host::graph
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+#endif
+
+namespace host::graph
+{
+/// Spin-wait hint for short busy loops on the audio path. Lets the sibling
+/// hyper-thread run and saves power without giving up the time slice.
+inline void cpuRelax() noexcept
+{
+#if JUCE_INTEL
+    _mm_pause();
+#elif JUCE_ARM && (JUCE_GCC || JUCE_CLANG)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+/// Pool of pre-spawned realtime threads that help the device callback run one
+/// job per audio block. run() publishes the job, executes it on the calling
+/// thread as participant 0 and returns once every worker that joined has left
+/// it, so per-block state can be reset for the next block straight away.
+///
+/// Nothing on the run() path locks or allocates: the job is handed over
+/// through atomics, and idle workers park on std::atomic::wait (a futex /
+/// WaitOnAddress, not a mutex) after a short spin.
+class WorkerPool
+{
+public:
+    using JobFunction = void (*)(void* context, int participantIndex);
+
+    explicit WorkerPool(int numWorkers);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    [[nodiscard]] int getNumWorkers() const noexcept { return static_cast<int>(workers_.size()); }
+
+    /// Workers plus the calling thread.
+    [[nodiscard]] int getNumParticipants() const noexcept { return getNumWorkers() + 1; }
+
+    /// Audio thread: run `job` on every participant and wait for all of them
+    /// to return. The job decides itself when there is no work left.
+    void run(JobFunction job, void* context) noexcept;
+
+private:
+    class Worker;
+
+    void workerLoop(Worker& worker, int participantIndex);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<std::uint32_t> generation_ { 0 };
+    std::atomic<bool> jobOpen_ { false };
+    std::atomic<int> busyWorkers_ { 0 };
+    std::atomic<JobFunction> job_ { nullptr };
+    std::atomic<void*> context_ { nullptr };
+    std::atomic<bool> shuttingDown_ { false };
+};
+} // namespace host::graph
@@ -25,6 +25,7 @@ namespace
     constexpr float kConnectorHitRadius = kConnectorRadius + 4.0f;
     constexpr float kNodeHorizontalSpacing = 200.0f;
     constexpr float kDefaultTop = 80.0f;
+    constexpr int kCpuOverlayRefreshHz = 4;
 }
 
 class GraphView::NodeComponent : public juce::Component
@@ -97,6 +98,18 @@ public:
         }
     }
 
+    void setTiming(bool hasTimingIn, double meanUsIn, double p99UsIn, double loadPercentIn)
+    {
+        if (hasTiming == hasTimingIn && meanUs == meanUsIn && p99Us == p99UsIn && loadPercent == loadPercentIn)
+            return;
+
+        hasTiming = hasTimingIn;
+        meanUs = meanUsIn;
+        p99Us = p99UsIn;
+        loadPercent = loadPercentIn;
+        repaint();
+    }
+
     [[nodiscard]] juce::Point<float> getInputConnectorPosition() const
     {
         return {
@@ -163,6 +176,9 @@ public:
                    juce::Rectangle<int>(0, 0, getWidth(), getHeight()).reduced(14, 0).withTrimmedTop(36).withHeight(18),
                    juce::Justification::topLeft);
 
+        if (hasTiming)
+            drawTiming(g);
+
         drawConnector(g, { 12.0f, getHeight() / 2.0f }, numInputs > 0 || nodeRole == Role::Output);
         drawConnector(g, { getWidth() - 12.0f, getHeight() / 2.0f }, numOutputs > 0 || nodeRole == Role::Input);
     }
@@ -261,6 +277,31 @@ public:
     }
 
 private:
+    void drawTiming(juce::Graphics& g) const
+    {
+        auto area = getLocalBounds().reduced(14, 0).withTrimmedBottom(8);
+        auto barArea = area.removeFromBottom(3).toFloat();
+        auto textArea = area.removeFromBottom(16);
+
+        // Green up to a quarter of the block budget, red from a half.
+        const auto fraction = static_cast<float>(std::clamp(loadPercent / 100.0, 0.0, 1.0));
+        const auto barColour = juce::Colours::limegreen.interpolatedWith(juce::Colours::red,
+                                                                         std::clamp((fraction - 0.25f) * 4.0f, 0.0f, 1.0f));
+
+        juce::String text = tr("graph.cpu");
+        text = text.replace("%1", juce::String(meanUs / 1000.0, 2))
+                   .replace("%2", juce::String(p99Us / 1000.0, 2))
+                   .replace("%3", juce::String(loadPercent, 1));
+        g.setColour(barColour.brighter(0.4f));
+        g.setFont(11.0f);
+        g.drawText(text, textArea, juce::Justification::bottomLeft);
+
+        g.setColour(juce::Colours::white.withAlpha(0.15f));
+        g.fillRoundedRectangle(barArea, 1.5f);
+        g.setColour(barColour);
+        g.fillRoundedRectangle(barArea.withWidth(std::max(1.0f, barArea.getWidth() * fraction)), 1.5f);
+    }
+
     void drawConnector(juce::Graphics& g, juce::Point<float> centre, bool enabled) const
     {
         const juce::Colour fill = enabled ? pickRoleColour(nodeRole) : juce::Colours::darkgrey;
@@ -292,6 +333,10 @@ private:
     bool draggingConnection { false };
     bool draggingNode { false };
     juce::Point<float> dragStartWorld_ {};
+    bool hasTiming { false };
+    double meanUs { 0.0 };
+    double p99Us { 0.0 };
+    double loadPercent { 0.0 };
 };
 
 GraphView::GraphView()
@@ -300,7 +345,10 @@ GraphView::GraphView()
     setWantsKeyboardFocus(true);
 }
 
-GraphView::~GraphView() = default;
+GraphView::~GraphView()
+{
+    setCpuOverlayVisible(false);
+}
 
 void GraphView::setOnRequestNodeSettings(std::function<void(NodeId)> callback)
 {
@@ -314,6 +362,8 @@ void GraphView::setOnRequestAddNode(std::function<void(const std::string&)> call
 
 void GraphView::setGraph(std::shared_ptr<host::graph::GraphEngine> graphEngine)
 {
+    const bool overlayWasVisible = cpuOverlayVisible;
+    setCpuOverlayVisible(false);
     graph = std::move(graphEngine);
     selectedNode = {};
     viewOffset = {};
@@ -322,6 +372,50 @@ void GraphView::setGraph(std::shared_ptr<host::graph::GraphEngine> graphEngine)
     nodeComponents.clear();
     removeAllChildren();
     refreshGraph(false);
+    setCpuOverlayVisible(overlayWasVisible);
+}
+
+void GraphView::setCpuOverlayVisible(bool shouldBeVisible)
+{
+    if (graph)
+    {
+        if (shouldBeVisible != graph->isProfilingEnabled())
+            graph->resetNodeTimings();
+        graph->setProfilingEnabled(shouldBeVisible);
+    }
+
+    cpuOverlayVisible = shouldBeVisible;
+    if (cpuOverlayVisible)
+    {
+        startTimerHz(kCpuOverlayRefreshHz);
+    }
+    else
+    {
+        stopTimer();
+        for (auto& component : nodeComponents)
+            component->setTiming(false, 0.0, 0.0, 0.0);
+    }
+}
+
+void GraphView::timerCallback()
+{
+    updateNodeTimings();
+}
+
+void GraphView::updateNodeTimings()
+{
+    if (! graph)
+        return;
+
+    // Nodes without samples yet (just added, or asleep) show no overlay.
+    for (auto& component : nodeComponents)
+        component->setTiming(false, 0.0, 0.0, 0.0);
+
+    for (const auto& timing : graph->getNodeTimings())
+    {
+        if (auto* component = findNodeComponent(timing.id))
+            component->setTiming(true, timing.meanUs, timing.p99Us, timing.meanLoadPercent);
+    }
 }
 
 void GraphView::refreshGraph(bool preservePositions)
@@ -691,6 +785,7 @@ void GraphView::showBackgroundMenu(juce::Point<int> screenPosition)
        focusItemId = 1,
        resetItemId = 2,
        clearItemId = 3,
+       cpuOverlayItemId = 4,
        addNodeBase = 1000
    };
 
@@ -721,6 +816,8 @@ void GraphView::showBackgroundMenu(juce::Point<int> screenPosition)
 
    menu.addItem(resetItemId, tr("graph.menu.resetView"));
    menu.addItem(clearItemId, tr("graph.menu.clearSelection"));
+    menu.addSeparator();
+    menu.addItem(cpuOverlayItemId, tr("graph.menu.cpuOverlay"), graph != nullptr, cpuOverlayVisible);
 
     menu.showMenuAsync(juce::PopupMenu::Options().withTargetScreenArea({ screenPosition.x, screenPosition.y, 1, 1 }),
                        [this](int result)
@@ -730,6 +827,7 @@ void GraphView::showBackgroundMenu(juce::Point<int> screenPosition)
                                case focusItemId: centerOnSelectedNode(); break;
                                case resetItemId: setViewOffset({}); break;
                               case clearItemId: deselectAll(); break;
+                              case cpuOverlayItemId: setCpuOverlayVisible(! cpuOverlayVisible); break;
                               default:
                                   if (result >= addNodeBase && onRequestAddNode)
                                   {
@@ -1111,7 +1209,9 @@ bool GraphView::nodeSupportsSettings(NodeId id) const
        // editable when they expose parameters.
        if (dynamic_cast<host::graph::nodes::VstFxNode*>(node.get()) != nullptr)
            return true;
-       return ! node->getParameters().empty();
+       const auto params = node->getParameters();
+       return std::any_of(params.begin(), params.end(),
+                          [](const auto& p) { return ! p.loadTimeOnly; });
    }
 
    return false;
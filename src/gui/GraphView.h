@@ -11,7 +11,8 @@
 
 namespace host::gui
 {
-    class GraphView : public juce::Component
+    class GraphView : public juce::Component,
+                      private juce::Timer
     {
     public:
         using NodeId = host::graph::GraphEngine::NodeId;
@@ -34,6 +35,11 @@ namespace host::gui
         void mouseWheelMove(const juce::MouseEvent& event, const juce::MouseWheelDetails& wheel) override;
         bool keyPressed(const juce::KeyPress& key) override;
 
+        /// Show per-node CPU time on every node. Turns GraphEngine profiling
+        /// on while visible and polls the timings a few times a second.
+        void setCpuOverlayVisible(bool shouldBeVisible);
+        [[nodiscard]] bool isCpuOverlayVisible() const noexcept { return cpuOverlayVisible; }
+
     private:
         class NodeComponent;
         friend class NodeComponent;
@@ -52,6 +58,8 @@ namespace host::gui
         void showBackgroundMenu(juce::Point<int> screenPosition);
         void drawConnections(juce::Graphics& g);
         void drawScrollIndicators(juce::Graphics& g);
+        void timerCallback() override;
+        void updateNodeTimings();
         void clearConnectionsFrom(NodeId id);
         void clearConnectionsTo(NodeId id);
         void selectNode(NodeId id);
@@ -87,6 +95,7 @@ namespace host::gui
         juce::Point<float> panStartOffset {};
 
         float zoom_ { 1.0f };
+        bool cpuOverlayVisible = false;
 
         bool isDraggingConnection = false;
         NodeId connectionSource {};
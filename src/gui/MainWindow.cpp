@@ -418,6 +418,10 @@ void MainWindow::loadConfiguration()
     engineCfg.blockSize = settings.blockSize;
     engineCfg.resamplerQuality = settings.resamplerQuality;
     engineCfg.pdcEnabled = settings.pdcEnabled;
+    engineCfg.workerThreads = settings.workerThreads;
+    engineCfg.tailSleepEnabled = settings.tailSleepEnabled;
+    engineCfg.driftCompensation = settings.driftCompensation;
+    engineCfg.pipelineDepth = settings.pipelineDepth;
     deviceEngine.setEngineConfig(engineCfg);
 
     if (pluginScanner)
@@ -616,6 +620,9 @@ void MainWindow::openPluginSettings(host::graph::GraphEngine::NodeId id)
            return;
 
        auto params = node->getParameters();
+       params.erase(std::remove_if(params.begin(), params.end(),
+                                   [](const auto& p) { return p.loadTimeOnly; }),
+                    params.end());
        if (params.empty())
            return;
 
@@ -640,6 +647,23 @@ void MainWindow::openPluginSettings(host::graph::GraphEngine::NodeId id)
                    addAndMakeVisible(label);
                    label->setBounds(padding, y, labelWidth, rowHeight);
 
+                   if (p.isText)
+                   {
+                       // Text parameters are file paths (a convolution IR):
+                       // a button that shows the file and opens a chooser.
+                       auto* button = new juce::TextButton(textButtonLabel(p.text));
+                       button->setComponentID(juce::String(p.id));
+                       addAndMakeVisible(button);
+                       button->setBounds(padding + labelWidth + 4, y, 320, rowHeight);
+                       button->onClick = [this, idx = sliders.size()] { chooseFile(idx); };
+
+                       labels.emplace_back(label);
+                       sliders.emplace_back(nullptr);
+                       buttons.emplace_back(button);
+                       y += rowHeight + 4;
+                       continue;
+                   }
+
                    auto* slider = new juce::Slider(juce::Slider::LinearHorizontal, juce::Slider::TextBoxRight);
                    slider->setRange(p.min, p.max, 0.01);
                    slider->setValue(p.value, juce::dontSendNotification);
@@ -670,10 +694,40 @@ void MainWindow::openPluginSettings(host::graph::GraphEngine::NodeId id)
 
            void paint(juce::Graphics& g) override { g.fillAll(juce::Colours::darkgrey.darker(0.4f)); }
 
+           static juce::String textButtonLabel(const std::string& path)
+           {
+               return path.empty() ? juce::String("(none)") : juce::File(juce::String(path)).getFileName();
+           }
+
+           void chooseFile(size_t idx)
+           {
+               chooser = std::make_unique<juce::FileChooser>(params[idx].displayName,
+                                                             juce::File(juce::String(params[idx].text)),
+                                                             "*.wav;*.aif;*.aiff;*.flac");
+               const juce::Component::SafePointer<EffectParameterPanel> safeThis(this);
+               chooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+                                    [safeThis, idx](const juce::FileChooser& fc)
+                                    {
+                                        if (safeThis == nullptr || fc.getResult() == juce::File())
+                                            return;
+                                        auto& param = safeThis->params[idx];
+                                        param.text = fc.getResult().getFullPathName().toStdString();
+                                        for (auto& button : safeThis->buttons)
+                                        {
+                                            if (button->getComponentID() == juce::String(param.id))
+                                                button->setButtonText(textButtonLabel(param.text));
+                                        }
+                                        if (safeThis->node)
+                                            safeThis->node->requestTextParameterChange(param.id, param.text);
+                                    });
+           }
+
            std::shared_ptr<host::graph::Node> node;
            std::vector<host::graph::NodeParameter> params;
            std::vector<std::unique_ptr<juce::Label>> labels;
            std::vector<std::unique_ptr<juce::Slider>> sliders;
+           std::vector<std::unique_ptr<juce::TextButton>> buttons;
+           std::unique_ptr<juce::FileChooser> chooser;
        };
 
        auto panel = std::make_unique<EffectParameterPanel>(node, std::move(params));
@@ -96,6 +96,8 @@ namespace host::gui
 
         configureLabel(resamplerQualityLabel, tr("preferences.audio.resamplerQuality"));
         configureLabel(pdcLabel, tr("preferences.audio.pdc"));
+        configureLabel(tailSleepLabel, tr("preferences.audio.tailSleep"));
+        configureLabel(driftLabel, tr("preferences.audio.drift"));
 
         // Embed the full AudioDeviceSelectorComponent so the audio tab offers
         // the same detailed control as the standalone "Audio Device Settings"
@@ -118,6 +120,10 @@ namespace host::gui
         audioTab->addAndMakeVisible(resamplerQualityBox);
         audioTab->addAndMakeVisible(pdcLabel);
         audioTab->addAndMakeVisible(pdcToggle);
+        audioTab->addAndMakeVisible(tailSleepLabel);
+        audioTab->addAndMakeVisible(tailSleepToggle);
+        audioTab->addAndMakeVisible(driftLabel);
+        audioTab->addAndMakeVisible(driftToggle);
 
         // Resampler quality: trades CPU for SRC accuracy between the device
         // sample rate and the engine sample rate.
@@ -125,10 +131,11 @@ namespace host::gui
         resamplerQualityBox.addItem(tr("preferences.audio.quality.catmull"), 2);
         resamplerQualityBox.addItem(tr("preferences.audio.quality.lagrange"), 3);
         resamplerQualityBox.addItem(tr("preferences.audio.quality.sinc"), 4);
+        resamplerQualityBox.addItem(tr("preferences.audio.quality.polyphase"), 5);
         {
             const auto settings = config.getEngineSettings();
-            // EngineSettings.resamplerQuality indexes: 0..3 map to item ids 1..4.
-            const int itemId = std::clamp(settings.resamplerQuality + 1, 1, 4);
+            // EngineSettings.resamplerQuality indexes: 0..4 map to item ids 1..5.
+            const int itemId = std::clamp(settings.resamplerQuality + 1, 1, 5);
             resamplerQualityBox.setSelectedId(itemId, juce::dontSendNotification);
         }
         resamplerQualityBox.onChange = [this]
@@ -166,6 +173,44 @@ namespace host::gui
             notifyConfigChanged();
         };
 
+        // Tail sleep: idle effect chains stop processing once their reported
+        // tail has rung out, and wake on the next non-silent block.
+        tailSleepToggle.setToggleState(config.getEngineSettings().tailSleepEnabled,
+                                       juce::dontSendNotification);
+        tailSleepToggle.setColour(juce::ToggleButton::textColourId, juce::Colours::whitesmoke);
+        tailSleepToggle.onClick = [this]
+        {
+            if (isUpdating)
+                return;
+            const bool enabled = tailSleepToggle.getToggleState();
+            auto cfg = deviceEngine.getEngineConfig();
+            cfg.tailSleepEnabled = enabled;
+            deviceEngine.setEngineConfig(cfg);
+            auto settings = config.getEngineSettings();
+            settings.tailSleepEnabled = enabled;
+            config.setEngineSettings(settings);
+            notifyConfigChanged();
+        };
+
+        // Drift compensation: keep the engine at its nominal rate in host
+        // time, whatever the device's clock actually runs at.
+        driftToggle.setToggleState(config.getEngineSettings().driftCompensation,
+                                   juce::dontSendNotification);
+        driftToggle.setColour(juce::ToggleButton::textColourId, juce::Colours::whitesmoke);
+        driftToggle.onClick = [this]
+        {
+            if (isUpdating)
+                return;
+            const bool enabled = driftToggle.getToggleState();
+            auto cfg = deviceEngine.getEngineConfig();
+            cfg.driftCompensation = enabled;
+            deviceEngine.setEngineConfig(cfg);
+            auto settings = config.getEngineSettings();
+            settings.driftCompensation = enabled;
+            config.setEngineSettings(settings);
+            notifyConfigChanged();
+        };
+
         // ASIO (and some WASAPI) devices expose a vendor control panel for
         // hardware buffer / latch / exclusive-mode settings. Without it the
         // user cannot tune the low-latency path that makes ASIO / WASAPI
@@ -386,7 +431,12 @@ namespace host::gui
         if (changed)
         {
             deviceEngine.setEngineConfig(cfg);
-            config.setEngineSettings({ cfg.sampleRate, cfg.blockSize });
+            // Merge rather than rebuild the aggregate so resampler quality,
+            // PDC and worker-thread settings are not reset to defaults.
+            auto settings = config.getEngineSettings();
+            settings.sampleRate = cfg.sampleRate;
+            settings.blockSize = cfg.blockSize;
+            config.setEngineSettings(settings);
         }
 
         // Always persist on any device change so the user's input device /
@@ -440,6 +490,8 @@ namespace host::gui
 
         layoutRow(resamplerQualityLabel, resamplerQualityBox);
         layoutRow(pdcLabel, pdcToggle);
+        layoutRow(tailSleepLabel, tailSleepToggle);
+        layoutRow(driftLabel, driftToggle);
 
         // Control panel row: ASIO / WASAPI-exclusive vendor panel.
         auto controlRow = area.removeFromTop(rowHeight);
@@ -504,6 +556,10 @@ namespace host::gui
         resamplerQualityLabel.setText(tr("preferences.audio.resamplerQuality"), juce::dontSendNotification);
         pdcLabel.setText(tr("preferences.audio.pdc"), juce::dontSendNotification);
         pdcToggle.setButtonText(tr("preferences.audio.pdc"));
+        tailSleepLabel.setText(tr("preferences.audio.tailSleep"), juce::dontSendNotification);
+        tailSleepToggle.setButtonText(tr("preferences.audio.tailSleepHint"));
+        driftLabel.setText(tr("preferences.audio.drift"), juce::dontSendNotification);
+        driftToggle.setButtonText(tr("preferences.audio.driftHint"));
 
         controlPanelButton.setButtonText(tr("preferences.audio.controlPanel"));
         controlPanelHint.setText(tr("preferences.audio.controlPanelHint"), juce::dontSendNotification);
@@ -56,8 +56,12 @@ namespace host::gui
         juce::Component* startupTab { nullptr };
         juce::ComboBox resamplerQualityBox;
         juce::ToggleButton pdcToggle { "PDC" };
+        juce::ToggleButton tailSleepToggle { "Tail sleep" };
+        juce::ToggleButton driftToggle { "Drift compensation" };
         juce::Label resamplerQualityLabel;
         juce::Label pdcLabel;
+        juce::Label tailSleepLabel;
+        juce::Label driftLabel;
         juce::TextButton controlPanelButton { "Control Panel" };
         juce::Label controlPanelHint;
         std::unique_ptr<juce::AudioDeviceSelectorComponent> deviceSelector;
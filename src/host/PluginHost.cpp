@@ -1,8 +1,11 @@
 #include "host/PluginHost.h"
 
+#include <pluginterfaces/vst2.x/aeffect.h>
+
 #include <algorithm>
 #include <cstring>
 #include <filesystem>
+#include <limits>
 
 namespace host::plugin
 {
@@ -53,23 +56,35 @@ namespace
             prepared = true;
             const int inCh = instance->getTotalNumInputChannels();
             const int outCh = instance->getTotalNumOutputChannels();
-            processBuffer.setSize(juce::jmax(inCh, outCh, 1), block);
+            // Sized for the plug-in's buses and the largest block up front;
+            // process() only ever shrinks it, which never reallocates.
+            processChannels = juce::jmax(inCh, outCh, 1);
+            processBuffer.setSize(processChannels, juce::jmax(block, 1));
+            midi.ensureSize(kMidiReserveBytes);
         }
 
         void process(float** in, int inCh, float** out, int outCh, int numFrames) override
         {
             if (! instance || ! prepared)
+            {
+                // The caller does not pre-clear its output buffers.
+                for (int c = 0; c < outCh; ++c)
+                    if (out != nullptr && out[c] != nullptr)
+                        std::memset(out[c], 0, static_cast<std::size_t>(numFrames) * sizeof(float));
                 return;
+            }
 
             // JUCE's processBlock owns the buffer; copy inputs in, run, then
-            // copy outputs back out. The buffer is sized to max(in,out) so a
-            // mono->stereo plugin (or vice versa) does not overflow. Channels
-            // are mapped host<->plugin so a channel count mismatch (mono
-            // plugin on a stereo bus, or the reverse) still routes audio
-            // correctly instead of leaving one side silent or feeding garbage.
-            const int maxCh = juce::jmax(inCh, outCh, 1);
-            if (processBuffer.getNumChannels() < maxCh || processBuffer.getNumSamples() < numFrames)
-                processBuffer.setSize(maxCh, juce::jmax(numFrames, processBuffer.getNumSamples()));
+            // copy outputs back out. The buffer has one channel per plug-in
+            // bus channel and exactly numFrames samples, so the plug-in sees
+            // the real block length. Channels are mapped host<->plugin so a
+            // channel count mismatch (mono plugin on a stereo bus, or the
+            // reverse) still routes audio correctly instead of leaving one
+            // side silent or feeding garbage. The engine never passes more
+            // than the prepared block size, so the resize stays within the
+            // allocation made in prepare().
+            const int maxCh = processChannels;
+            processBuffer.setSize(maxCh, numFrames, false, false, true);
 
             // Clear the whole working buffer first so channels the plugin does
             // not write (or that have no host source) come out silent instead
@@ -90,7 +105,7 @@ namespace
                                 static_cast<std::size_t>(numFrames) * sizeof(float));
             }
 
-            juce::MidiBuffer midi;
+            midi.clear();
             instance->processBlock(processBuffer, midi);
 
             // Copy plugin outputs back onto the host output channels. If the
@@ -115,6 +130,29 @@ namespace
             return instance ? instance->getLatencySamples() : 0;
         }
 
+        void setNonRealtime(bool isNonRealtime) override
+        {
+            if (instance)
+                instance->setNonRealtime(isNonRealtime);
+        }
+
+        [[nodiscard]] double tailLengthSeconds() const override
+        {
+            if (! instance)
+                return 0.0;
+            // Without audio inputs the plug-in is a source; silence on the
+            // (non-existent) input says nothing about its output.
+            if (instance->getTotalNumInputChannels() == 0)
+                return std::numeric_limits<double>::infinity();
+            if (const double tail = instance->getTailLengthSeconds(); tail > 0.0)
+                return tail;
+            // JUCE reports 0 both for "no tail" and for a plug-in that never
+            // answered (the VST3 SDK default, an unhandled effGetTailSize), and
+            // many reverbs and delays never do. Only trust silence-in,
+            // silence-out when the plug-in declares it outright.
+            return declaresNoTail() ? 0.0 : std::numeric_limits<double>::infinity();
+        }
+
         bool getState(std::vector<std::uint8_t>& out) override
         {
             if (! instance)
@@ -180,8 +218,24 @@ namespace
         }
 
     private:
+        // Room for the events a plug-in may emit in one block before the
+        // MidiBuffer would have to grow on the audio thread.
+        static constexpr int kMidiReserveBytes = 2048;
+
+        // VST2's effFlagsNoSoundInStop is the one explicit "no tail" a plug-in
+        // can give; a VST3 kNoTail is indistinguishable from the SDK default.
+        [[nodiscard]] bool declaresNoTail() const
+        {
+            if (storedInfo.format != PluginFormat::VST2)
+                return false;
+            const auto* effect = static_cast<const AEffect*>(instance->getPlatformSpecificData());
+            return effect != nullptr && (effect->flags & effFlagsNoSoundInStop) != 0;
+        }
+
         std::unique_ptr<juce::AudioPluginInstance> instance;
         juce::AudioBuffer<float> processBuffer;
+        juce::MidiBuffer midi;
+        int processChannels { 1 };
         PluginInfo storedInfo;
         bool prepared { false };
     };
@@ -35,9 +35,16 @@ namespace host::plugin
         virtual void prepare(double sr, int block) = 0;
         virtual void process(float** in, int inCh, float** out, int outCh, int numFrames) = 0;
         [[nodiscard]] virtual int latencySamples() const = 0;
+        // Seconds the plug-in keeps producing output after its input stops;
+        // infinity when it never stops (instruments, generators) or when it
+        // reports no tail without declaring that it has none.
+        [[nodiscard]] virtual double tailLengthSeconds() const { return 0.0; }
         virtual bool getState(std::vector<std::uint8_t>& out) = 0;
         virtual bool setState(const std::uint8_t* data, std::size_t len) = 0;
         virtual bool queryRuntimeInfo(PluginInfo& ioInfo) const { juce::ignoreUnused(ioInfo); return false; }
+        // Offline rendering: the plug-in may trade speed for quality and
+        // must not rely on wall-clock time. Applies from the next prepare().
+        virtual void setNonRealtime(bool isNonRealtime) { juce::ignoreUnused(isNonRealtime); }
         [[nodiscard]] virtual bool hasEditor() const { return false; }
         // Reports whether the hosted editor supports live resizing. Hosts use this
         // to decide if the editor dialog should be user-resizable and to size it.
@@ -60,7 +60,12 @@ void ChainPreset::applyToGraph(host::graph::GraphEngine& graph) const
             continue;
 
         for (const auto& p : snapshot.parameters)
-            node->requestParameterChange(p.id, p.value);
+        {
+            if (p.isText)
+                node->requestTextParameterChange(p.id, p.text);
+            else
+                node->requestParameterChange(p.id, p.value);
+        }
     }
 }
 
@@ -106,6 +111,11 @@ bool ChainPreset::load(const juce::File& file)
                     host::graph::NodeParameter p;
                     p.id = paramObj->getProperty("id").toString().toStdString();
                     p.value = paramObj->getProperty("value");
+                    if (paramObj->hasProperty("text"))
+                    {
+                        p.isText = true;
+                        p.text = paramObj->getProperty("text").toString().toStdString();
+                    }
                     snapshot.parameters.push_back(std::move(p));
                 }
             }
@@ -140,6 +150,8 @@ bool ChainPreset::save(const juce::File& file) const
             juce::DynamicObject::Ptr paramObj(new juce::DynamicObject());
             paramObj->setProperty("id", juce::String(p.id));
             paramObj->setProperty("value", p.value);
+            if (p.isText)
+                paramObj->setProperty("text", juce::String(p.text));
             paramArray.add(juce::var(paramObj.get()));
         }
         nodeObj->setProperty("parameters", juce::var(paramArray));
@@ -1,5 +1,7 @@
 #include "persist/Config.h"
 
+#include <algorithm>
+
 namespace host::persist
 {
     void Config::setPluginDirectories(const std::vector<juce::File>& dirs)
@@ -33,6 +35,14 @@ namespace host::persist
             // default.
             if (auto pdcVar = object->getProperty("pdcEnabled"); ! pdcVar.isVoid())
                 engineSettings.pdcEnabled = static_cast<bool>(pdcVar);
+            if (auto workersVar = object->getProperty("workerThreads"); ! workersVar.isVoid())
+                engineSettings.workerThreads = std::max(0, static_cast<int>(workersVar));
+            if (auto sleepVar = object->getProperty("tailSleepEnabled"); ! sleepVar.isVoid())
+                engineSettings.tailSleepEnabled = static_cast<bool>(sleepVar);
+            if (auto driftVar = object->getProperty("driftCompensation"); ! driftVar.isVoid())
+                engineSettings.driftCompensation = static_cast<bool>(driftVar);
+            if (auto depthVar = object->getProperty("pipelineDepth"); ! depthVar.isVoid())
+                engineSettings.pipelineDepth = std::max(0, static_cast<int>(depthVar));
 
             pluginDirectories.clear();
             if (auto* arr = object->getProperty("pluginDirectories").getArray())
@@ -63,6 +73,10 @@ namespace host::persist
         obj->setProperty("blockSize", engineSettings.blockSize);
         obj->setProperty("resamplerQuality", engineSettings.resamplerQuality);
         obj->setProperty("pdcEnabled", engineSettings.pdcEnabled);
+        obj->setProperty("workerThreads", engineSettings.workerThreads);
+        obj->setProperty("tailSleepEnabled", engineSettings.tailSleepEnabled);
+        obj->setProperty("driftCompensation", engineSettings.driftCompensation);
+        obj->setProperty("pipelineDepth", engineSettings.pipelineDepth);
 
         juce::Array<juce::var> directories;
         for (auto& dir : pluginDirectories)
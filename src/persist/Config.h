@@ -12,11 +12,25 @@ namespace host::persist
         // Resampler quality used by the device engine when bridging between
         // the hardware sample rate and the engine sample rate. Persisted so
         // the user's CPU/quality trade-off survives restarts.
-        int resamplerQuality { 2 }; // 0=Linear 1=CatmullRom 2=Lagrange 3=WindowedSinc
+        int resamplerQuality { 2 }; // 0=Linear 1=CatmullRom 2=Lagrange 3=WindowedSinc 4=Polyphase
         // Plugin Delay Compensation master switch. When enabled the graph
         // runtime inserts delay lines so parallel paths stay sample-aligned
         // with the longest-latency chain.
         bool pdcEnabled { true };
+        // Realtime worker threads for parallel graph execution. 0 keeps the
+        // whole graph on the device callback thread.
+        int workerThreads { 0 };
+        // Let idle effect chains stop processing once their tail has rung
+        // out. Off by default: it relies on the tail each plug-in reports, and
+        // one that under-reports is cut off mid-tail. Plug-ins reporting no
+        // tail are never put to sleep unless they declare it (VST2 only).
+        bool tailSleepEnabled { false };
+        // Lock the engine rate to the host clock by measuring the device
+        // clock against it and steering the resampler ratios.
+        bool driftCompensation { false };
+        // Blocks the dedicated engine thread renders ahead of the device.
+        // 0 renders inside the device callback.
+        int pipelineDepth { 0 };
     };
 
     class Config
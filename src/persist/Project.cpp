@@ -239,6 +239,8 @@ namespace
                             juce::DynamicObject::Ptr pObj(new juce::DynamicObject());
                             pObj->setProperty("id", juce::String(p.id));
                             pObj->setProperty("value", p.value);
+                            if (p.isText)
+                                pObj->setProperty("text", juce::String(p.text));
                             paramsArray.add(juce::var(pObj.get()));
                         }
                         nodeObj->setProperty("parameters", juce::var(paramsArray));
@@ -0,0 +1,275 @@
+#include "persist/ProjectGraphBuilder.h"
+
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <optional>
+#include <system_error>
+#include <unordered_map>
+
+#include "graph/NodeFactory.h"
+#include "graph/Nodes/VstFx.h"
+#include "host/PluginScanner.h"
+
+namespace host::persist
+{
+    ProjectGraphBuilder::ProjectGraphBuilder(host::plugin::PluginScanner* scannerIn)
+        : scanner(scannerIn)
+    {
+    }
+
+    void ProjectGraphBuilder::instantiate(const Project& project)
+    {
+        prepared.clear();
+        prepared.reserve(project.getNodes().size());
+        missingPlugins.clear();
+        connections = project.getConnections();
+        inputNodeId = project.getInputNodeId();
+        outputNodeId = project.getOutputNodeId();
+
+        for (const auto& nodeDef : project.getNodes())
+        {
+            auto node = createNode(nodeDef);
+            if (node == nullptr)
+            {
+                if (nodeDef.type.isNotEmpty())
+                    juce::Logger::writeToLog("Unknown node type in project: " + nodeDef.type);
+                continue;
+            }
+
+            prepared.push_back({ nodeDef, std::move(node) });
+        }
+    }
+
+    std::unique_ptr<host::graph::Node> ProjectGraphBuilder::createNode(const Project::NodeDefinition& definition)
+    {
+        // Built-in nodes (Gain, EQ, Compressor, Reverb, Delay, routing) go
+        // through the factory. Only VST plugins need the bespoke loader below.
+        const auto rawType = definition.type.isNotEmpty() ? definition.type : definition.name;
+
+        if (auto node = host::graph::NodeFactory::createFromPersistedName(rawType.toStdString()))
+        {
+            // Restore saved parameters for effect nodes.
+            if (definition.parameters.isNotEmpty())
+            {
+                // Parameters are stored as JSON in the project; parsed and
+                // applied here so presets and projects share the format.
+                juce::var paramsVar;
+                if (juce::JSON::parse(definition.parameters, paramsVar).wasOk())
+                {
+                    std::vector<host::graph::NodeParameter> params;
+                    if (auto* arr = paramsVar.getArray())
+                    {
+                        for (const auto& item : *arr)
+                        {
+                            if (auto* obj = item.getDynamicObject())
+                            {
+                                host::graph::NodeParameter p;
+                                p.id = obj->getProperty("id").toString().toStdString();
+                                p.value = obj->getProperty("value");
+                                if (obj->hasProperty("text"))
+                                {
+                                    p.isText = true;
+                                    p.text = obj->getProperty("text").toString().toStdString();
+                                }
+                                params.push_back(p);
+                            }
+                        }
+                        node->setParameters(params);
+                    }
+                }
+            }
+            return node;
+        }
+
+        const bool looksLikePlugin = rawType.toLowerCase().removeCharacters(" ") == "vstfx"
+                                     || definition.pluginPath.isNotEmpty()
+                                     || definition.pluginId.isNotEmpty();
+
+        if (! looksLikePlugin)
+            return {};
+
+        host::plugin::PluginInfo info;
+        info.id = definition.pluginId.toStdString();
+        info.name = definition.name.toStdString();
+        info.latency = definition.latency;
+        info.ins = definition.inputs > 0 ? definition.inputs : 2;
+        info.outs = definition.outputs > 0 ? definition.outputs : 2;
+
+        if (definition.pluginFormat.equalsIgnoreCase("VST2"))
+            info.format = host::plugin::PluginFormat::VST2;
+        else
+            info.format = host::plugin::PluginFormat::VST3;
+
+        if (definition.pluginPath.isNotEmpty())
+            info.path = std::filesystem::path(definition.pluginPath.toStdString());
+
+        const auto hydrateFromScanner = [&]()
+        {
+            if ((! info.path.empty()) && definition.pluginPath.isNotEmpty())
+                return;
+
+            if (scanner == nullptr)
+                return;
+
+            const auto discovered = scanner->getDiscoveredPlugins();
+            const auto it = std::find_if(discovered.begin(), discovered.end(),
+                                         [&](const host::plugin::PluginInfo& candidate)
+                                         {
+                                             const bool idMatches = ! info.id.empty() && candidate.id == info.id;
+                                             const bool nameMatches = ! info.name.empty() && candidate.name == info.name;
+                                             return idMatches || nameMatches;
+                                         });
+
+            if (it != discovered.end())
+                info = *it;
+        };
+
+        hydrateFromScanner();
+
+        const auto pluginFileExists = [&]() -> bool
+        {
+            if (info.path.empty())
+                return false;
+
+            std::error_code ec;
+            const bool exists = std::filesystem::exists(info.path, ec);
+            return exists && ec.value() == 0;
+        }();
+
+        std::unique_ptr<host::plugin::PluginInstance> instance;
+
+        if (pluginFileExists)
+        {
+            if (scanner != nullptr)
+                instance = scanner->loader().load(info);
+
+            if (instance)
+                instance->queryRuntimeInfo(info);
+
+            if (instance && definition.pluginState.getSize() > 0)
+            {
+                instance->setState(static_cast<const std::uint8_t*>(definition.pluginState.getData()),
+                                   static_cast<std::size_t>(definition.pluginState.getSize()));
+            }
+        }
+
+        if (! instance)
+        {
+            const auto descriptor = definition.name.isNotEmpty() ? definition.name : juce::String(info.id);
+            missingPlugins.add("• " + descriptor);
+        }
+
+        std::optional<host::plugin::PluginInfo> storedInfo;
+        if (! info.id.empty() || ! info.name.empty() || ! info.path.empty())
+            storedInfo = info;
+
+        return std::make_unique<host::graph::nodes::VstFxNode>(std::move(instance),
+                                                               definition.name.toStdString(),
+                                                               storedInfo);
+    }
+
+    void ProjectGraphBuilder::populate(host::graph::GraphEngine& graph)
+    {
+        std::unordered_map<juce::Uuid, host::graph::GraphEngine::NodeId> idMap;
+        idMap.reserve(prepared.size());
+
+        std::vector<host::graph::GraphEngine::NodeId> orderedIds;
+        orderedIds.reserve(prepared.size());
+
+        for (auto& prep : prepared)
+        {
+            const auto& nodeDef = prep.definition;
+            auto node = std::move(prep.node);
+
+            host::graph::GraphEngine::NodeId assignedId;
+
+            if (! nodeDef.id.isNull())
+            {
+                try
+                {
+                    assignedId = graph.addNodeWithId(nodeDef.id, std::move(node));
+                }
+                catch (const std::exception& e)
+                {
+                    juce::Logger::writeToLog("Failed to reuse node id " + nodeDef.id.toString() + ": " + e.what());
+                    assignedId = graph.addNode(std::move(node));
+                }
+            }
+            else
+            {
+                assignedId = graph.addNode(std::move(node));
+            }
+
+            if (! nodeDef.id.isNull())
+                idMap[nodeDef.id] = assignedId;
+
+            orderedIds.push_back(assignedId);
+        }
+        prepared.clear();
+
+        if (! connections.empty())
+        {
+            for (const auto& connection : connections)
+            {
+                const auto fromIt = idMap.find(connection.from);
+                const auto toIt = idMap.find(connection.to);
+                if (fromIt != idMap.end() && toIt != idMap.end())
+                {
+                    try
+                    {
+                        graph.connect(fromIt->second, toIt->second);
+                    }
+                    catch (const std::exception& e)
+                    {
+                        juce::Logger::writeToLog("Failed to connect nodes: " + juce::String(e.what()));
+                    }
+                }
+            }
+        }
+        else
+        {
+            for (size_t i = 1; i < orderedIds.size(); ++i)
+            {
+                try
+                {
+                    graph.connect(orderedIds[i - 1], orderedIds[i]);
+                }
+                catch (const std::exception& e)
+                {
+                    juce::Logger::writeToLog("Failed to connect sequential nodes: " + juce::String(e.what()));
+                }
+            }
+        }
+
+        const auto resolveNodeId = [&](juce::Uuid desiredId, bool useFrontFallback)
+        {
+            if (! desiredId.isNull())
+            {
+                const auto it = idMap.find(desiredId);
+                if (it != idMap.end())
+                    return it->second;
+            }
+
+            if (! orderedIds.empty())
+                return useFrontFallback ? orderedIds.front() : orderedIds.back();
+
+            return host::graph::GraphEngine::NodeId {};
+        };
+
+        const auto inputId = resolveNodeId(inputNodeId, true);
+        const auto outputId = resolveNodeId(outputNodeId, false);
+
+        if (! inputId.isNull() && ! outputId.isNull())
+        {
+            try
+            {
+                graph.setIO(inputId, outputId);
+            }
+            catch (const std::exception& e)
+            {
+                juce::Logger::writeToLog("Failed to assign graph IO: " + juce::String(e.what()));
+            }
+        }
+    }
+}
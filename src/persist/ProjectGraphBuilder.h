@@ -0,0 +1,58 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include "graph/GraphEngine.h"
+#include "persist/Project.h"
+
+#include <memory>
+#include <vector>
+
+namespace host::plugin
+{
+    class PluginScanner;
+}
+
+namespace host::persist
+{
+    /// Turns a loaded Project into graph nodes. Shared by the app and the
+    /// command-line host so both build the same graph from a project file.
+    ///
+    /// Split in two so the slow part can run while another graph keeps
+    /// playing: instantiate() creates every node (plug-ins included) without
+    /// touching any graph, populate() then adds them to an empty graph,
+    /// connects them and assigns IO in one quick pass. Neither prepares the
+    /// graph; that is left to the caller.
+    class ProjectGraphBuilder
+    {
+    public:
+        /// Plug-ins are loaded through the scanner's loader and, when a
+        /// project lacks the plug-in path, looked up among its discovered
+        /// plug-ins. Without a scanner, plug-in nodes stay empty.
+        explicit ProjectGraphBuilder(host::plugin::PluginScanner* scanner);
+
+        void instantiate(const Project& project);
+        /// Consumes the instantiated nodes. Problems connecting individual
+        /// nodes are logged, not thrown.
+        void populate(host::graph::GraphEngine& graph);
+
+        /// One "• name" line per plug-in that could not be loaded.
+        [[nodiscard]] const juce::StringArray& getMissingPlugins() const noexcept { return missingPlugins; }
+
+    private:
+        struct PreparedNode
+        {
+            Project::NodeDefinition definition;
+            std::unique_ptr<host::graph::Node> node;
+        };
+
+        [[nodiscard]] std::unique_ptr<host::graph::Node> createNode(const Project::NodeDefinition& definition);
+
+        host::plugin::PluginScanner* scanner;
+        std::vector<PreparedNode> prepared;
+        std::vector<Project::ConnectionDefinition> connections;
+        juce::Uuid inputNodeId;
+        juce::Uuid outputNodeId;
+        juce::StringArray missingPlugins;
+    };
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <optional>
+#include <string>
+
+#include <juce_core/juce_core.h>
+
+namespace host::util
+{
+/// Option values for the command-line tools, which document the
+/// "--name value" form. juce::ArgumentList::getValueForOption() only returns a
+/// long option's value written as "--name=value", so both forms are read
+/// here. A value that is missing, does not parse or is out of range is
+/// recorded as an error instead of being replaced by a default.
+class CommandLineOptions
+{
+public:
+    explicit CommandLineOptions(const juce::ArgumentList& argsIn) : args(argsIn) {}
+
+    [[nodiscard]] bool has(const juce::String& name) const { return args.containsOption(name); }
+
+    /// The option's value, or fallback when the option is absent.
+    [[nodiscard]] juce::String text(const juce::String& name, const juce::String& fallback = {})
+    {
+        if (! has(name))
+            return fallback;
+        if (auto value = find(name); value.has_value() && value->isNotEmpty())
+            return *value;
+        errors.add(name + " needs a value");
+        return fallback;
+    }
+
+    [[nodiscard]] int integer(const juce::String& name, int fallback, int min, int max)
+    {
+        const auto value = text(name);
+        if (value.isEmpty())
+            return fallback;
+
+        const auto utf8 = value.toStdString();
+        char* end = nullptr;
+        errno = 0;
+        const long parsed = std::strtol(utf8.c_str(), &end, 10);
+        if (errno != 0 || end == utf8.c_str() || *end != '\0' || parsed < min || parsed > max)
+        {
+            errors.add(name + " expects a whole number from " + juce::String(min) + " to " + juce::String(max)
+                       + ", not \"" + value + "\"");
+            return fallback;
+        }
+        return static_cast<int>(parsed);
+    }
+
+    [[nodiscard]] double number(const juce::String& name, double fallback, double min, double max)
+    {
+        const auto value = text(name);
+        if (value.isEmpty())
+            return fallback;
+
+        const auto utf8 = value.toStdString();
+        char* end = nullptr;
+        errno = 0;
+        const double parsed = std::strtod(utf8.c_str(), &end);
+        if (errno != 0 || end == utf8.c_str() || *end != '\0' || ! std::isfinite(parsed) || parsed < min || parsed > max)
+        {
+            errors.add(name + " expects a number from " + juce::String(min) + " to " + juce::String(max)
+                       + ", not \"" + value + "\"");
+            return fallback;
+        }
+        return parsed;
+    }
+
+    /// Also records an error when the value is not one of choices.
+    [[nodiscard]] juce::String choice(const juce::String& name, const juce::StringArray& choices, const juce::String& fallback)
+    {
+        const auto value = text(name, fallback);
+        if (! choices.contains(value))
+        {
+            errors.add(name + " expects one of " + choices.joinIntoString(", ") + ", not \"" + value + "\"");
+            return fallback;
+        }
+        return value;
+    }
+
+    [[nodiscard]] bool ok() const noexcept { return errors.isEmpty(); }
+    [[nodiscard]] const juce::StringArray& getErrors() const noexcept { return errors; }
+
+private:
+    // "--name=value", or the token after "--name" unless that is an option
+    // itself. name may list alternatives ("--output|-o").
+    [[nodiscard]] std::optional<juce::String> find(const juce::String& name) const
+    {
+        for (int i = 0; i < args.size(); ++i)
+        {
+            const auto& arg = args[i];
+            for (const auto& alternative : juce::StringArray::fromTokens(name, "|", {}))
+            {
+                if (arg.text.startsWith(alternative + "="))
+                    return arg.text.fromFirstOccurrenceOf("=", false, false);
+            }
+
+            if (arg == name && i + 1 < args.size() && ! args[i + 1].text.startsWith("--"))
+                return args[i + 1].text;
+        }
+        return std::nullopt;
+    }
+
+    const juce::ArgumentList& args;
+    juce::StringArray errors;
+};
+} // namespace host::util
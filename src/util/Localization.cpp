@@ -42,6 +42,8 @@ namespace
         strings.set("graph.menu.resetView", "Reset View");
         strings.set("graph.menu.clearSelection", "Clear Selection");
         strings.set("graph.menu.addNode", "Add Node");
+        strings.set("graph.menu.cpuOverlay", "Show CPU Usage");
+        strings.set("graph.cpu", "%1 ms / p99 %2 / %3%");
         strings.set("chainPreset.saveTitle", "Save Chain Preset");
         strings.set("chainPreset.errorTitle", "Chain Preset Error");
         strings.set("chainPreset.saveFailed", "Failed to save the chain preset.");
@@ -74,10 +76,15 @@ namespace
         strings.set("preferences.audio.controlPanelUnavailable", "No vendor control panel for the current device.");
         strings.set("preferences.audio.resamplerQuality", "Resampler Quality");
         strings.set("preferences.audio.pdc", "Plugin Delay Compensation");
+        strings.set("preferences.audio.tailSleep", "Sleep Idle Effects");
+        strings.set("preferences.audio.tailSleepHint", "Stop processing silent effects after their tail");
+        strings.set("preferences.audio.drift", "Clock Drift Compensation");
+        strings.set("preferences.audio.driftHint", "Lock the engine rate to the system clock by resampling");
         strings.set("preferences.audio.quality.linear", "Linear (fastest)");
         strings.set("preferences.audio.quality.catmull", "Catmull-Rom");
         strings.set("preferences.audio.quality.lagrange", "Lagrange (default)");
         strings.set("preferences.audio.quality.sinc", "Windowed Sinc (best)");
+        strings.set("preferences.audio.quality.polyphase", "Polyphase FIR (multichannel SIMD)");
         strings.set("preferences.plugins.add", "Add");
         strings.set("preferences.plugins.remove", "Remove");
         strings.set("preferences.plugins.rescan", "Rescan");
@@ -179,6 +186,8 @@ namespace
         strings.set("graph.menu.resetView", juce::String::fromUTF8("보기 초기화"));
         strings.set("graph.menu.clearSelection", juce::String::fromUTF8("선택 해제"));
         strings.set("graph.menu.addNode", juce::String::fromUTF8("노드 추가"));
+        strings.set("graph.menu.cpuOverlay", juce::String::fromUTF8("CPU 사용량 표시"));
+        strings.set("graph.cpu", "%1 ms / p99 %2 / %3%");
         strings.set("chainPreset.saveTitle", juce::String::fromUTF8("체인 프리셋 저장"));
         strings.set("chainPreset.errorTitle", juce::String::fromUTF8("체인 프리셋 오류"));
         strings.set("chainPreset.saveFailed", juce::String::fromUTF8("체인 프리셋을 저장하지 못했습니다."));
@@ -211,10 +220,15 @@ namespace
         strings.set("preferences.audio.controlPanelUnavailable", juce::String::fromUTF8("현재 장치에 컨트롤 패널이 없습니다."));
         strings.set("preferences.audio.resamplerQuality", juce::String::fromUTF8("리샘플러 품질"));
         strings.set("preferences.audio.pdc", juce::String::fromUTF8("플러그인 지연 보정 (PDC)"));
+        strings.set("preferences.audio.tailSleep", juce::String::fromUTF8("유휴 이펙트 절전"));
+        strings.set("preferences.audio.tailSleepHint", juce::String::fromUTF8("무음 입력이 테일보다 길면 이펙트 처리 중지"));
+        strings.set("preferences.audio.drift", juce::String::fromUTF8("클럭 드리프트 보정"));
+        strings.set("preferences.audio.driftHint", juce::String::fromUTF8("리샘플링으로 엔진 속도를 시스템 클럭에 고정"));
         strings.set("preferences.audio.quality.linear", juce::String::fromUTF8("선형 (가장 빠름)"));
         strings.set("preferences.audio.quality.catmull", juce::String::fromUTF8("Catmull-Rom"));
         strings.set("preferences.audio.quality.lagrange", juce::String::fromUTF8("Lagrange (기본)"));
         strings.set("preferences.audio.quality.sinc", juce::String::fromUTF8("윈도우드 싱크 (최고 품질)"));
+        strings.set("preferences.audio.quality.polyphase", juce::String::fromUTF8("폴리페이즈 FIR (멀티채널 SIMD)"));
         strings.set("preferences.plugins.add", juce::String::fromUTF8("추가"));
         strings.set("preferences.plugins.remove", juce::String::fromUTF8("삭제"));
         strings.set("preferences.plugins.rescan", juce::String::fromUTF8("다시 검색"));